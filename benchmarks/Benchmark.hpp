@@ -0,0 +1,64 @@
+/**
+ * @file Benchmark.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Timing helpers shared by benchmarks.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_BENCHMARKS_BENCHMARK_HPP
+#define VULKAN_HELPER_BENCHMARKS_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstdio>
+
+namespace Benchmark{
+
+    using Clock = std::chrono::steady_clock;
+
+    /// seconds passed since start
+    [[nodiscard]] inline double Seconds(const Clock::time_point& start){
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief call function repeatedly until at least minSeconds have passed.
+     *        Gives up growing the batch at 2^32 iterations, so work the compiler
+     *        removed entirely still returns (close to zero).
+     *
+     * @param minSeconds minimum measured time
+     * @param function called with number of iterations to run, returns nothing
+     * @return double : seconds per iteration
+     */
+    template<typename Function>
+    [[nodiscard]] inline double Measure(const double& minSeconds, const Function& function){
+        // grow batch until it takes long enough to time reliably
+        for(size_t iterations = 1; ; iterations *= 2){
+            Clock::time_point start = Clock::now();
+            function(iterations);
+            double seconds = Seconds(start);
+            if(seconds >= minSeconds || iterations >= (size_t(1) << 32)) return seconds / static_cast<double>(iterations);
+        }
+    }
+
+} // namespace Benchmark
+
+#endif//VULKAN_HELPER_BENCHMARKS_BENCHMARK_HPP
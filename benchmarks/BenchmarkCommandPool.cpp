@@ -0,0 +1,54 @@
+#include <thread>
+#include <VulkanHelper.hpp>
+#include "Benchmark.hpp"
+
+// command buffers recorded per second by 1..N threads, each thread using its own pools of CommandPoolManager
+
+/// command buffers each thread records per frame
+static constexpr uint32 cmdBuffersPerThread = 512;
+
+/// frames measured per thread count, pools are reset between frames
+static constexpr uint32 frameCount = 64;
+
+int main(){
+    Vulkan::Tools::VulkanBase base;
+    base.InitializeHeadless({64, 64});
+
+    const uint32 maxThreads = std::min(16u, std::max(1u, std::thread::hardware_concurrency()));
+    double singleThreadRate = 0.0;
+    for(uint32 threadCount = 1; threadCount <= maxThreads; threadCount *= 2){
+        Vulkan::CommandPoolManager pools;
+        pools.Init(base.device, base.graphicsIdx.value(), threadCount, 1);
+
+        double seconds = 0.0;
+        for(uint32 frame = 0; frame <= frameCount; frame++){
+            pools.BeginFrame(0);
+
+            // starting threads is measured too, it stands in for dispatching recording jobs
+            Benchmark::Clock::time_point start = Benchmark::Clock::now();
+            std::vector<std::thread> threads;
+            for(uint32 t = 0; t < threadCount; t++){
+                threads.emplace_back([&pools, t](){
+                    for(uint32 i = 0; i < cmdBuffersPerThread; i++){
+                        VkCommandBuffer cmdBuffer = pools.AllocatePrimary(t);
+                        Vulkan::BeginCommandBuffer(cmdBuffer, Vulkan::Init::CommandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
+                        Vulkan::EndCommandBuffer(cmdBuffer);
+                    }
+                });
+            }
+            for(auto& thread : threads) thread.join();
+
+            // first frame allocates command buffers, don't measure it
+            if(frame > 0) seconds += Benchmark::Seconds(start);
+        }
+
+        const double rate = static_cast<double>(threadCount) * cmdBuffersPerThread * frameCount / seconds;
+        if(threadCount == 1) singleThreadRate = rate;
+        printf("[CommandPoolManager] : threads = %2u | %12.0f command buffers/s | speedup = %.2fx\n", threadCount, rate, rate / singleThreadRate);
+
+        pools.Destroy();
+    }
+
+    base.Destroy();
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <VulkanHelper.hpp>
+#include "Benchmark.hpp"
+
+// descriptor sets allocated per second by DescriptorAllocator and FrameDescriptorAllocator,
+// all sets of a frame are returned with one reset before the next frame
+
+/// frames measured per set count
+static constexpr uint32 frameCount = 64;
+
+/// frames in flight of FrameDescriptorAllocator
+static constexpr uint32 framesInFlight = 2;
+
+int main(){
+    Vulkan::Tools::VulkanBase base;
+    base.InitializeHeadless({64, 64});
+
+    // a typical material set, uniform buffer and two textures
+    VkDescriptorSetLayout layout = Vulkan::CreateDescriptorSetLayout(base.device, Vulkan::Init::DescriptorSetLayoutCreateInfo({
+        Vulkan::Init::DescriptorSetLayoutBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT),
+        Vulkan::Init::DescriptorSetLayoutBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT),
+        Vulkan::Init::DescriptorSetLayoutBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
+    }));
+
+    for(const uint32 setsPerFrame : {64u, 1024u, 16384u}){
+        // pools grow in the first frames, don't measure them
+        Vulkan::DescriptorAllocator allocator;
+        allocator.Init(base.device);
+
+        double seconds = 0.0;
+        for(uint32 frame = 0; frame < frameCount + framesInFlight; frame++){
+            Benchmark::Clock::time_point start = Benchmark::Clock::now();
+            allocator.Reset();
+            for(uint32 i = 0; i < setsPerFrame; i++){
+                [[maybe_unused]] VkDescriptorSet set = allocator.Allocate(layout);
+            }
+            if(frame >= framesInFlight) seconds += Benchmark::Seconds(start);
+        }
+        printf("[DescriptorAllocator] : sets/frame = %5u | %12.0f sets/s\n", setsPerFrame, static_cast<double>(setsPerFrame) * frameCount / seconds);
+        allocator.Destroy();
+
+        Vulkan::FrameDescriptorAllocator frameAllocator;
+        frameAllocator.Init(base.device, framesInFlight);
+
+        seconds = 0.0;
+        for(uint32 frame = 0; frame < frameCount + framesInFlight; frame++){
+            Benchmark::Clock::time_point start = Benchmark::Clock::now();
+            frameAllocator.BeginFrame(frame % framesInFlight);
+            for(uint32 i = 0; i < setsPerFrame; i++){
+                [[maybe_unused]] VkDescriptorSet set = frameAllocator.Allocate(layout);
+            }
+            if(frame >= framesInFlight) seconds += Benchmark::Seconds(start);
+        }
+        printf("[FrameDescriptorAllocator] : sets/frame = %5u | %12.0f sets/s\n", setsPerFrame, static_cast<double>(setsPerFrame) * frameCount / seconds);
+        frameAllocator.Destroy();
+    }
+
+    Vulkan::DestroyDescriptorSetLayout(base.device, layout);
+    base.Destroy();
+    return 0;
+}
@@ -0,0 +1,100 @@
+// success is below this level so it compiles to nothing, info and above are logged
+#define SETTING_LOG_LEVEL info
+
+#include <thread>
+#include <vector>
+#include <Core.hpp>
+#include "Benchmark.hpp"
+
+// cost of one LOG call on the calling thread, and end to end cost including the drain that
+// formats and writes messages. Logged messages go to stdout, so run with stdout redirected
+// (eg. > /dev/null), results are printed to stderr
+
+/// LOG as it was before it was asynchronous, four buffered printf calls on the calling thread
+#define SYNCHRONOUS_LOG(severity, ...) { \
+    printf("\n[%s] : GENERATED FROM FILE[ %s ]@FUNCTION[ %s ]@LINE[ %i ]\n", #severity, __FILE__, __FUNCTION__, __LINE__); \
+    printf("\t"); \
+    printf(__VA_ARGS__); \
+    printf("\n\n"); \
+}
+
+/// minimum measured time of each case
+static constexpr double minSeconds = 0.5;
+
+/// messages each thread logs in the multi threaded end to end case
+static constexpr size_t messagesPerThread = 1 << 18;
+
+/// nanoseconds per call of function
+template<typename Function>
+[[nodiscard]] static double NanosecondsPerCall(const Function& function){
+    return 1e9 * Benchmark::Measure(minSeconds, [&](const size_t& iterations){
+        for(size_t i = 0; i < iterations; i++) function(i);
+    });
+}
+
+/// nanoseconds per call of function, including draining every message it logged
+template<typename Function>
+[[nodiscard]] static double NanosecondsPerCallDrained(const Function& function){
+    return 1e9 * Benchmark::Measure(minSeconds, [&](const size_t& iterations){
+        for(size_t i = 0; i < iterations; i++) function(i);
+        Vulkan::Log::GetLogger().Drain();
+    });
+}
+
+int main(){
+    const double compiledOut = NanosecondsPerCall([](const size_t& i){
+        LOG(success, "compiled out message %zu", i);
+    });
+    fprintf(stderr, "[Log] : compiled out level          | %8.1f ns/call\n", compiledOut);
+
+    const double logged = NanosecondsPerCall([](const size_t& i){
+        LOG(info, "logged message %zu with a float %f", i, 0.5);
+    });
+    Vulkan::Log::GetLogger().Drain();
+    fprintf(stderr, "[Log] : async, one thread           | %8.1f ns/call\n", logged);
+
+    const double loggedDrained = NanosecondsPerCallDrained([](const size_t& i){
+        LOG(info, "logged message %zu with a float %f", i, 0.5);
+    });
+    fprintf(stderr, "[Log] : async, one thread, drained  | %8.1f ns/call\n", loggedDrained);
+
+    // writers only contend on the ring position
+    const uint32 threadCount = std::min(8u, std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<double> threadTimes(threadCount);
+    std::vector<std::thread> threads;
+    for(uint32 t = 0; t < threadCount; t++){
+        threads.emplace_back([&threadTimes, t](){
+            threadTimes[t] = NanosecondsPerCall([t](const size_t& i){
+                LOG(info, "logged message %zu from thread %u", i, t);
+            });
+        });
+    }
+    for(auto& thread : threads) thread.join();
+    Vulkan::Log::GetLogger().Drain();
+
+    double average = 0.0;
+    for(const auto& time : threadTimes) average += time / threadCount;
+    fprintf(stderr, "[Log] : async, %u threads            | %8.1f ns/call\n", threadCount, average);
+
+    // wall time until every message of every thread is written, per message
+    threads.clear();
+    Benchmark::Clock::time_point start = Benchmark::Clock::now();
+    for(uint32 t = 0; t < threadCount; t++){
+        threads.emplace_back([t](){
+            for(size_t i = 0; i < messagesPerThread; i++){
+                LOG(info, "logged message %zu from thread %u", i, t);
+            }
+        });
+    }
+    for(auto& thread : threads) thread.join();
+    Vulkan::Log::GetLogger().Drain();
+    const double threadsDrained = 1e9 * Benchmark::Seconds(start) / static_cast<double>(messagesPerThread * threadCount);
+    fprintf(stderr, "[Log] : async, %u threads, drained   | %8.1f ns/message\n", threadCount, threadsDrained);
+
+    const double synchronous = NanosecondsPerCall([](const size_t& i){
+        SYNCHRONOUS_LOG(info, "logged message %zu with a float %f", i, 0.5);
+    });
+    fflush(stdout);
+    fprintf(stderr, "[Log] : synchronous (old LOG)       | %8.1f ns/call\n", synchronous);
+    return 0;
+}
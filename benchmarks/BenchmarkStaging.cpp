@@ -0,0 +1,73 @@
+#include <VulkanHelper.hpp>
+#include "Benchmark.hpp"
+
+// upload throughput of StagingRing for different upload sizes, host side and with the GPU copies
+
+/// bytes uploaded per size
+static constexpr VkDeviceSize totalSize = 256ull * 1024 * 1024;
+
+/// size of ring and destination buffer
+static constexpr VkDeviceSize capacity = 32ull * 1024 * 1024;
+
+int main(){
+    Vulkan::Tools::VulkanBase base;
+    base.InitializeHeadless({64, 64});
+
+    Vulkan::Memory memory;
+    memory.Init(base.physicalDevice, base.device);
+
+    VkBuffer dstBuffer = Vulkan::CreateBuffer(base.device, Vulkan::Init::BufferCreateInfo(capacity, VK_BUFFER_USAGE_TRANSFER_DST_BIT));
+    Vulkan::Memory::Allocation dstAllocation = memory.AllocateBufferMemory(dstBuffer, 0);
+
+    Vulkan::CommandPoolManager pools;
+    pools.Init(base.device, base.graphicsIdx.value(), 1, 2);
+
+    std::vector<uint8> data(capacity / 4, 0xAB);
+    for(const VkDeviceSize uploadSize : {VkDeviceSize(256), VkDeviceSize(4096), VkDeviceSize(64 * 1024), VkDeviceSize(1024 * 1024)}){
+        // a frame uploads a quarter of the ring so two frames are in flight without stalling
+        const uint64 uploadsPerFrame = (capacity / 4) / uploadSize;
+        const uint64 frameCount = totalSize / (uploadsPerFrame * uploadSize);
+
+        Vulkan::StagingRing ring;
+        ring.Init(base.device, memory, capacity, 2);
+
+        double hostSeconds = 0.0;
+        Benchmark::Clock::time_point start = Benchmark::Clock::now();
+        for(uint64 frame = 0; frame < frameCount; frame++){
+            ring.BeginFrame();
+            pools.BeginFrame(ring.frameIdx);
+
+            Benchmark::Clock::time_point hostStart = Benchmark::Clock::now();
+            for(uint64 i = 0; i < uploadsPerFrame; i++){
+                ring.Upload(dstBuffer, (i * uploadSize) % capacity, data.data() + (i * uploadSize) % data.size(), uploadSize);
+            }
+            hostSeconds += Benchmark::Seconds(hostStart);
+
+            VkCommandBuffer cmdBuffer = pools.AllocatePrimary(0);
+            Vulkan::BeginCommandBuffer(cmdBuffer, Vulkan::Init::CommandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
+            ring.Record(cmdBuffer);
+            Vulkan::EndCommandBuffer(cmdBuffer);
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount   = 1;
+            submitInfo.pCommandBuffers      = &cmdBuffer;
+            Vulkan::QueueSumbit(base.graphicsQueue, submitInfo, ring.EndFrame());
+        }
+        Vulkan::DeviceWaitIdle(base.device);
+        double totalSeconds = Benchmark::Seconds(start);
+
+        const double megabytes = static_cast<double>(ring.uploadedBytes) / (1024.0 * 1024.0);
+        printf("[StagingRing] : upload size = %7" PRIu64 " B | host = %9.1f MB/s | with gpu copy = %9.1f MB/s | stalls = %" PRIu64 "\n",
+            static_cast<uint64>(uploadSize), megabytes / hostSeconds, megabytes / totalSeconds, ring.stallCount);
+
+        ring.Destroy();
+    }
+
+    pools.Destroy();
+    Vulkan::DestroyBuffer(base.device, dstBuffer);
+    memory.Free(dstAllocation);
+    memory.Destroy();
+    base.Destroy();
+    return 0;
+}
@@ -33,6 +33,15 @@
 #include <cstring>
 #include <string>
 #include <cinttypes>
+#include <array>
+#include <initializer_list>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <functional>
 
 // convinience typedefs
 typedef unsigned int uint;
@@ -43,6 +52,234 @@ typedef uint64_t uint64;
 
 typedef std::vector<const char*> Names;
 
+/**
+ * @brief Minimum severity of LOG messages that are compiled in.
+ *        Severities in increasing order : success, info, warning, error.
+ *        Messages below this level compile to nothing, eg. -DSETTING_LOG_LEVEL=error.
+ *        Release builds (NDEBUG) default to warning so wrappers don't log every call.
+ * 
+ */
+#ifndef SETTING_LOG_LEVEL
+    #ifdef NDEBUG
+        #define SETTING_LOG_LEVEL warning
+    #else
+        #define SETTING_LOG_LEVEL success
+    #endif//NDEBUG
+#endif//SETTING_LOG_LEVEL
+
+/**
+ * @brief Number of messages log ring can hold before writers have to wait, must be a power of two.
+ * 
+ */
+#ifndef SETTING_LOG_RING_SIZE
+    #define SETTING_LOG_RING_SIZE 1024
+#endif//SETTING_LOG_RING_SIZE
+
+#if defined(__GNUC__)
+    #define VULKAN_HELPER_PRINTF_FORMAT(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+    #define VULKAN_HELPER_PRINTF_FORMAT(fmt, args)
+#endif
+
+namespace Vulkan::Log{
+
+    /// severity of a log message
+    enum class Level : uint8{
+        success,
+        info,
+        warning,
+        error
+    };
+
+    /// name of severity as printed
+    [[nodiscard]] inline const char* LevelString(const Level& level){
+        switch(level){
+            case Level::success : return "success";
+            case Level::info    : return "info";
+            case Level::warning : return "warning";
+            case Level::error   : return "error";
+        }
+        return "unknown";
+    }
+
+    /**
+     * @brief Asynchronous logger. Calling threads only format the message into a slot
+     *        of a bounded lock-free ring, a background thread drains the ring and does
+     *        the actual (slow) writing to stdout. Writers never block on each other; if the
+     *        ring is full a writer drains it itself, so no message is lost.
+     *        The drain thread is started on first message and flushed at exit.
+     * 
+     */
+    struct Logger{
+        static_assert((SETTING_LOG_RING_SIZE & (SETTING_LOG_RING_SIZE - 1)) == 0, "SETTING_LOG_RING_SIZE must be a power of two");
+
+        /// maximum length of formatted message, longer messages are truncated
+        static constexpr size_t maxMessageLength = 256;
+
+        /**
+         * @brief one slot in ring
+         * 
+         */
+        struct Message{
+            /// position this slot is ready for : writable at pos, readable at pos + 1
+            std::atomic<uint64> sequence;
+
+            Level level;
+            const char* file;
+            const char* function;
+            int line;
+            char text[maxMessageLength];
+        };
+
+        /// ring of messages
+        std::array<Message, SETTING_LOG_RING_SIZE> ring;
+
+        /// next position to write, shared by writers
+        std::atomic<uint64> writePos = 0;
+
+        /// next position to read, only touched by the drainer
+        uint64 readPos = 0;
+
+        /// only one thread drains at a time (drain thread or Flush)
+        std::mutex drainMutex;
+
+        /// drain thread keeps running while true
+        std::atomic<bool> running = true;
+
+        /// drain thread
+        std::thread drainThread;
+
+        Logger(){
+            for(uint64 i = 0; i < ring.size(); i++){
+                ring[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            drainThread = std::thread([this](){
+                while(running.load(std::memory_order_relaxed)){
+                    if(Drain() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+        }
+
+        ~Logger(){
+            running = false;
+            drainThread.join();
+            Drain();
+        }
+
+        /**
+         * @brief format a message into ring. Thread safe and lock free.
+         * 
+         * @param level severity
+         * @param file source file
+         * @param function source function
+         * @param line source line
+         * @param format printf style format
+         * @param args format arguments
+         */
+        inline void Write(const Level& level, const char* file, const char* function, const int& line, const char* format, va_list args){
+            // claim a slot
+            uint64 pos = writePos.load(std::memory_order_relaxed);
+            Message* message;
+            for(;;){
+                message = &ring[pos & (ring.size() - 1)];
+                int64_t diff = static_cast<int64_t>(message->sequence.load(std::memory_order_acquire) - pos);
+                if(diff == 0){
+                    if(writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                }else if(diff < 0){
+                    // ring is full, help drain it instead of waiting for drain thread to wake up
+                    if(drainMutex.try_lock()){
+                        DrainLocked();
+                        drainMutex.unlock();
+                    }else{
+                        std::this_thread::yield();
+                    }
+                    pos = writePos.load(std::memory_order_relaxed);
+                }else{
+                    pos = writePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            // fill and publish
+            message->level = level;
+            message->file = file;
+            message->function = function;
+            message->line = line;
+            vsnprintf(message->text, maxMessageLength, format, args);
+            message->sequence.store(pos + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief write all published messages to stdout
+         * 
+         * @return size_t : number of messages written
+         */
+        inline size_t Drain(){
+            std::lock_guard<std::mutex> lock(drainMutex);
+            return DrainLocked();
+        }
+
+    private:
+        /// drain with drainMutex held
+        inline size_t DrainLocked(){
+            size_t count = 0;
+            for(;;){
+                Message& message = ring[readPos & (ring.size() - 1)];
+                if(message.sequence.load(std::memory_order_acquire) != readPos + 1) break;
+
+                printf("\n[%s] : GENERATED FROM FILE[ %s ]@FUNCTION[ %s ]@LINE[ %i ]\n\t%s\n\n",
+                    LevelString(message.level), message.file, message.function, message.line, message.text);
+
+                // slot can be reused one lap later
+                message.sequence.store(readPos + ring.size(), std::memory_order_release);
+                readPos++;
+                count++;
+            }
+
+            if(count) fflush(stdout);
+            return count;
+        }
+    };
+
+    /// logger shared by the whole program
+    [[nodiscard]] inline Logger& GetLogger(){
+        static Logger logger;
+        return logger;
+    }
+
+    /**
+     * @brief log a message asynchronously, used by LOG
+     * 
+     */
+    inline void Write(const Level& level, const char* file, const char* function, const int& line, const char* format, ...) VULKAN_HELPER_PRINTF_FORMAT(5, 6);
+    inline void Write(const Level& level, const char* file, const char* function, const int& line, const char* format, ...){
+        va_list args;
+        va_start(args, format);
+        GetLogger().Write(level, file, function, line, format, args);
+        va_end(args);
+    }
+
+    /**
+     * @brief print a failed assertion and exit, used by ASSERT.
+     *        Pending log messages are flushed first so they appear before the failure.
+     * 
+     */
+    [[noreturn]] inline void Fatal(const char* condition, const char* file, const char* function, const int& line, const char* format, ...) VULKAN_HELPER_PRINTF_FORMAT(5, 6);
+    [[noreturn]] inline void Fatal(const char* condition, const char* file, const char* function, const int& line, const char* format, ...){
+        GetLogger().Drain();
+
+        char text[Logger::maxMessageLength];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+
+        printf("\nASSERT::FAILURE [ %s ]\nERROR RAISED FROM FILE[ %s ]@FUNCTION[ %s ]@LINE[ %i ]\n\t%s\n\n", condition, file, function, line, text);
+        fflush(stdout);
+        exit(-1);
+    }
+
+} // namespace Vulkan::Log
+
 /**
  * @brief Convinient assert macro definition. Pass in the
  *        condition as first paramter and then the printf style
@@ -53,23 +290,17 @@ typedef std::vector<const char*> Names;
 #ifndef SETTING_DONT_ASSERT
 #define ASSERT(b, ...) \
     if(!(b)){ \
-        printf("\nASSERT::FAILURE [ %s ]\n", #b); \
-        printf("ERROR RAISED FROM FILE[ %s ]@FUNCTION[ %s ]@LINE[ %i ]\n", __FILE__, __FUNCTION__, __LINE__); \
-        printf("\t"); \
-        printf(__VA_ARGS__); \
-        printf("\n\n"); \
-        exit(-1); \
+        Vulkan::Log::Fatal(#b, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__); \
     }
 #endif//SETTING_DONT_ASSERT
 
 // if produce logs is defined then logging macro will be defined else it will be empty
 #ifndef SETTING_DONT_GENERATE_LOG
-    // simple log macro
+    // severities below SETTING_LOG_LEVEL are discarded at compile time
     #define LOG(severity, ...) { \
-        printf("\n[%s] : GENERATED FROM FILE[ %s ]@FUNCTION[ %s ]@LINE[ %i ]\n", #severity, __FILE__, __FUNCTION__, __LINE__); \
-        printf("\t"); \
-        printf(__VA_ARGS__); \
-        printf("\n\n"); \
+        if constexpr(Vulkan::Log::Level::severity >= Vulkan::Log::Level::SETTING_LOG_LEVEL){ \
+            Vulkan::Log::Write(Vulkan::Log::Level::severity, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__); \
+        } \
     }
 #else
     #define LOG(...)
@@ -151,4 +382,181 @@ typedef std::vector<const char*> Names;
         return false;
     }
 
+namespace Vulkan{
+
+    /**
+     * @brief Fixed capacity vector that lives on stack.
+     *        Use it instead of std::vector for small per draw lists
+     *        (vertex buffers, descriptor sets, dynamic offsets...) to avoid heap allocations.
+     *
+     * @tparam T type of element
+     * @tparam N maximum number of elements
+     */
+    template<typename T, size_t N>
+    struct InlineVector{
+        /// storage
+        std::array<T, N> elements = {};
+
+        /// number of elements in use
+        uint32 count = 0;
+
+        InlineVector() = default;
+
+        /// construct from a list of elements
+        InlineVector(std::initializer_list<T> list){
+            ASSERT(list.size() <= N, "[InlineVector] : %i elements don't fit in capacity of %i", static_cast<uint>(list.size()), static_cast<uint>(N));
+            for(const T& element : list) elements[count++] = element;
+        }
+
+        /// add an element at the end
+        inline void push_back(const T& element){
+            ASSERT(count < N, "[InlineVector] : Capacity of %i exceeded", static_cast<uint>(N));
+            elements[count++] = element;
+        }
+
+        /// remove all elements
+        inline void clear() { count = 0; }
+
+        [[nodiscard]] inline uint32 size() const { return count; }
+        [[nodiscard]] inline bool empty() const { return count == 0; }
+        [[nodiscard]] static constexpr size_t capacity() { return N; }
+        [[nodiscard]] inline T* data() { return elements.data(); }
+        [[nodiscard]] inline const T* data() const { return elements.data(); }
+        [[nodiscard]] inline T* begin() { return elements.data(); }
+        [[nodiscard]] inline T* end() { return elements.data() + count; }
+        [[nodiscard]] inline const T* begin() const { return elements.data(); }
+        [[nodiscard]] inline const T* end() const { return elements.data() + count; }
+        [[nodiscard]] inline T& operator[](const size_t& i) { return elements[i]; }
+        [[nodiscard]] inline const T& operator[](const size_t& i) const { return elements[i]; }
+    };
+
+    /**
+     * @brief Non owning view of contiguous elements (pointer + count).
+     *        Can be created from a std::vector, std::array, InlineVector, C array,
+     *        a braced list or a single element, so functions taking a Span accept
+     *        all of them without allocating.
+     *
+     *        Span doesn't own anything, so never keep one around longer than
+     *        the data it points to. Passing a braced list as function argument is fine.
+     *
+     * @tparam T type of element
+     */
+    template<typename T>
+    struct Span{
+        /// pointer to first element
+        const T* elements = nullptr;
+
+        /// number of elements
+        uint32 count = 0;
+
+        Span() = default;
+        Span(const T* elements, const uint32& count) : elements(elements), count(count) {}
+        Span(const T& element) : elements(&element), count(1) {}
+        Span(const std::vector<T>& vector) : elements(vector.data()), count(static_cast<uint32>(vector.size())) {}
+        // list only lives until end of full expression, which is fine for function arguments
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Winit-list-lifetime"
+#endif
+        Span(std::initializer_list<T> list) : elements(list.begin()), count(static_cast<uint32>(list.size())) {}
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+        template<size_t N> Span(const T (&array)[N]) : elements(array), count(static_cast<uint32>(N)) {}
+        template<size_t N> Span(const std::array<T, N>& array) : elements(array.data()), count(static_cast<uint32>(N)) {}
+        template<size_t N> Span(const InlineVector<T, N>& vector) : elements(vector.data()), count(vector.size()) {}
+
+        [[nodiscard]] inline uint32 size() const { return count; }
+        [[nodiscard]] inline bool empty() const { return count == 0; }
+        [[nodiscard]] inline const T* data() const { return elements; }
+        [[nodiscard]] inline const T* begin() const { return elements; }
+        [[nodiscard]] inline const T* end() const { return elements + count; }
+        [[nodiscard]] inline const T& operator[](const size_t& i) const { return elements[i]; }
+    };
+
+    /**
+     * @brief mix hash of a value into seed, for hashing structs field by field
+     * 
+     * @tparam T type of value, must be hashable by std::hash
+     * @param seed hash so far
+     * @param value to mix in
+     */
+    template<typename T>
+    inline void HashCombine(size_t& seed, const T& value){
+        seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+
+    /**
+     * @brief 64 bit xxHash (XXH64) of a block of memory. Fast enough to hash
+     *        whole shader binaries on every lookup. Assumes a little endian host.
+     *
+     * @param data pointer to memory, doesn't need to be aligned
+     * @param size of memory in bytes
+     * @param seed
+     * @return uint64 hash
+     */
+    [[nodiscard]] inline uint64 HashBytes(const void* data, const size_t& size, const uint64& seed = 0){
+        constexpr uint64 prime1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64 prime2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64 prime3 = 0x165667B19E3779F9ull;
+        constexpr uint64 prime4 = 0x85EBCA77C2B2AE63ull;
+        constexpr uint64 prime5 = 0x27D4EB2F165667C5ull;
+
+        auto rotl = [](const uint64& x, const int& r){ return (x << r) | (x >> (64 - r)); };
+        auto round = [&](uint64 acc, const uint64& input){ acc += input * prime2; return rotl(acc, 31) * prime1; };
+        auto read64 = [](const uint8* p){ uint64 v; memcpy(&v, p, sizeof(v)); return v; };
+        auto read32 = [](const uint8* p){ uint32 v; memcpy(&v, p, sizeof(v)); return v; };
+
+        const uint8* p = static_cast<const uint8*>(data);
+        const uint8* end = p + size;
+        uint64 hash;
+
+        // process 32 byte stripes with four accumulators
+        if(size >= 32){
+            uint64 v1 = seed + prime1 + prime2, v2 = seed + prime2, v3 = seed, v4 = seed - prime1;
+            for(; p + 32 <= end; p += 32){
+                v1 = round(v1, read64(p));
+                v2 = round(v2, read64(p + 8));
+                v3 = round(v3, read64(p + 16));
+                v4 = round(v4, read64(p + 24));
+            }
+
+            hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            for(uint64 v : {v1, v2, v3, v4}){
+                hash ^= round(0, v);
+                hash = hash * prime1 + prime4;
+            }
+        }else{
+            hash = seed + prime5;
+        }
+        hash += static_cast<uint64>(size);
+
+        // remaining bytes
+        for(; p + 8 <= end; p += 8){
+            hash ^= round(0, read64(p));
+            hash = rotl(hash, 27) * prime1 + prime4;
+        }
+        if(p + 4 <= end){
+            hash ^= static_cast<uint64>(read32(p)) * prime1;
+            hash = rotl(hash, 23) * prime2 + prime3;
+            p += 4;
+        }
+        for(; p < end; p++){
+            hash ^= static_cast<uint64>(*p) * prime5;
+            hash = rotl(hash, 11) * prime1;
+        }
+
+        // avalanche
+        hash ^= hash >> 33;
+        hash *= prime2;
+        hash ^= hash >> 29;
+        hash *= prime3;
+        hash ^= hash >> 32;
+
+        // return
+        return hash;
+    }
+
+} // namespace Vulkan
+
 #endif//VULKAN_HELPER_CORE_HPP
@@ -28,16 +28,20 @@
 #ifndef VULKAN_HELPER_VULKAN_HPP
 #define VULKAN_HELPER_VULKAN_HPP
 
-#include <SDL2/SDL_error.h>
-#include <SDL2/SDL_video.h>
 #include <algorithm>
 #include <string>
 #include <set>
 #include <fstream>
 #include <optional>
-#include <SDL2/SDL_vulkan.h>
 #include <vulkan/vulkan_core.h>
 #include "Core.hpp"
+
+// SDL is optional, define SETTING_DONT_USE_SDL for headless builds
+#ifndef SETTING_DONT_USE_SDL
+    #include <SDL2/SDL_error.h>
+    #include <SDL2/SDL_video.h>
+    #include <SDL2/SDL_vulkan.h>
+#endif//SETTING_DONT_USE_SDL
 #include "VulkanEnumStringifier.hpp"
 
 /// Vulkan namespace contains helpers
@@ -223,6 +227,44 @@ namespace Vulkan{
         return features;
     }
 
+    /**
+    * @brief get features of given physical device, including extension/core feature structs chained in next
+    * 
+    * @param physicalDevice handle
+    * @param next chain of feature structs to be filled (eg. VkPhysicalDeviceTimelineSemaphoreFeatures)
+    * @return VkPhysicalDeviceFeatures2 
+    */
+    [[nodiscard]] inline VkPhysicalDeviceFeatures2 GetPhysicalDeviceFeatures2(const VkPhysicalDevice& physicalDevice, void* next = nullptr) noexcept{
+        // check for valid handle
+        CHECK_VULKAN_HANDLE(physicalDevice)
+
+        // get and return features
+        VkPhysicalDeviceFeatures2 features = {};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = next;
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+        return features;
+    }
+
+    /**
+    * @brief get properties of given physical device, including extension/core property structs chained in next
+    * 
+    * @param physicalDevice handle
+    * @param next chain of property structs to be filled (eg. VkPhysicalDeviceVulkan12Properties)
+    * @return VkPhysicalDeviceProperties2 
+    */
+    [[nodiscard]] inline VkPhysicalDeviceProperties2 GetPhysicalDeviceProperties2(const VkPhysicalDevice& physicalDevice, void* next = nullptr) noexcept{
+        // check for valid handle
+        CHECK_VULKAN_HANDLE(physicalDevice)
+
+        // get and return properties
+        VkPhysicalDeviceProperties2 properties = {};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = next;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+        return properties;
+    }
+
     /**
      * @brief destroy vulkan surface
      * 
@@ -240,6 +282,7 @@ namespace Vulkan{
         vkDestroySurfaceKHR(instance, surface, nullptr);
     }
 
+#ifndef SETTING_DONT_USE_SDL
     /**
     * @brief create a Vulkan surface for given instance and window
     * 
@@ -269,6 +312,7 @@ namespace Vulkan{
         // return surface handle
         return surface;
     }
+#endif//SETTING_DONT_USE_SDL
 
     /**
      * @brief get device extension names
@@ -731,6 +775,27 @@ namespace Vulkan{
         return commandBuffers;
     }
 
+    /**
+     * @brief reset command pool, this resets all command buffers allocated from it at once
+     * 
+     * @param device 
+     * @param commandPool 
+     * @param flags 
+     */
+    inline void ResetCommandPool(const VkDevice& device, const VkCommandPool& commandPool, const VkCommandPoolResetFlags& flags = 0){
+        // check valid device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check command pool handle
+        CHECK_VULKAN_HANDLE(commandPool)
+
+        // reset
+        VkResult resResetCommandPool = vkResetCommandPool(device, commandPool, flags);
+
+        // check success
+        ASSERT(resResetCommandPool == VK_SUCCESS, "Reset Command Pool failed -> returned : %s", ResultString(resResetCommandPool));
+    }
+
     /**
      * @brief destroy renderpass
      * 
@@ -877,7 +942,7 @@ namespace Vulkan{
      * @param waitAll do we have to wait for all fences
      * @param timeout time in nanoseconds
      */
-    inline void WaitForFences(const VkDevice& device, const std::vector<VkFence>& fences, VkBool32 waitAll, uint64 timeout){
+    inline void WaitForFences(const VkDevice& device, const Span<VkFence>& fences, VkBool32 waitAll, uint64 timeout){
         // check valid device handle
         CHECK_VULKAN_HANDLE(device)
 
@@ -912,7 +977,7 @@ namespace Vulkan{
      * @param device 
      * @param fences 
      */
-    inline void ResetFences(const VkDevice& device, const std::vector<VkFence>& fences){
+    inline void ResetFences(const VkDevice& device, const Span<VkFence>& fences){
         // check valid device handle
         CHECK_VULKAN_HANDLE(device)
 
@@ -986,6 +1051,114 @@ namespace Vulkan{
         return semaphore;
     }
 
+    /**
+     * @brief create a timeline semaphore (Vulkan 1.2)
+     * 
+     * @param device must be created with timelineSemaphore feature enabled
+     * @param initialValue 
+     * @param allocator 
+     * @return VkSemaphore 
+     */
+    [[nodiscard]] inline VkSemaphore CreateTimelineSemaphore(const VkDevice& device, const uint64& initialValue = 0, const VkAllocationCallbacks* allocator = nullptr){
+        // chain semaphore type
+        VkSemaphoreTypeCreateInfo typeCreateInfo = {};
+        typeCreateInfo.sType            = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeCreateInfo.semaphoreType    = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeCreateInfo.initialValue     = initialValue;
+
+        VkSemaphoreCreateInfo createInfo = {};
+        createInfo.sType    = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        createInfo.pNext    = &typeCreateInfo;
+
+        // create
+        return CreateSemaphore(device, createInfo, allocator);
+    }
+
+    /**
+     * @brief wait on host for timeline semaphores to reach given values
+     * 
+     * @param device 
+     * @param semaphores timeline semaphores
+     * @param values one value for each semaphore
+     * @param timeout in nanoseconds
+     * @param waitAny wait for any one semaphore instead of all
+     * @return true if wait was satisfied
+     * @return false if timeout happened
+     */
+    inline bool WaitSemaphores(const VkDevice& device, const Span<VkSemaphore>& semaphores, const Span<uint64>& values, const uint64& timeout, const bool& waitAny = false){
+        // check valid device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // wait info
+        VkSemaphoreWaitInfo waitInfo = {};
+        waitInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.flags          = waitAny ? VK_SEMAPHORE_WAIT_ANY_BIT : 0;
+        waitInfo.semaphoreCount = semaphores.size();
+        waitInfo.pSemaphores    = semaphores.data();
+        waitInfo.pValues        = values.data();
+
+        // wait
+        VkResult resWaitSemaphores = vkWaitSemaphores(device, &waitInfo, timeout);
+
+        // check success
+        ASSERT(resWaitSemaphores == VK_SUCCESS || resWaitSemaphores == VK_TIMEOUT, "Something wrong happened while waiting for Semaphore(s) -> returned %s", ResultString(resWaitSemaphores));
+
+        // return
+        return resWaitSemaphores == VK_SUCCESS;
+    }
+
+    /**
+     * @brief signal a timeline semaphore from host
+     * 
+     * @param device 
+     * @param semaphore timeline semaphore
+     * @param value must be greater than current value of semaphore
+     */
+    inline void SignalSemaphore(const VkDevice& device, const VkSemaphore& semaphore, const uint64& value){
+        // check valid device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check valid semaphore handle
+        CHECK_VULKAN_HANDLE(semaphore)
+
+        // signal info
+        VkSemaphoreSignalInfo signalInfo = {};
+        signalInfo.sType        = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+        signalInfo.semaphore    = semaphore;
+        signalInfo.value        = value;
+
+        // signal
+        VkResult resSignalSemaphore = vkSignalSemaphore(device, &signalInfo);
+
+        // check success
+        ASSERT(resSignalSemaphore == VK_SUCCESS, "Semaphore signal failed -> returned : %s", ResultString(resSignalSemaphore));
+    }
+
+    /**
+     * @brief get current value of a timeline semaphore
+     * 
+     * @param device 
+     * @param semaphore timeline semaphore
+     * @return uint64 
+     */
+    [[nodiscard]] inline uint64 GetSemaphoreCounterValue(const VkDevice& device, const VkSemaphore& semaphore){
+        // check valid device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check valid semaphore handle
+        CHECK_VULKAN_HANDLE(semaphore)
+
+        // get value
+        uint64 value = 0;
+        VkResult resGetSemaphoreCounterValue = vkGetSemaphoreCounterValue(device, semaphore, &value);
+
+        // check success
+        ASSERT(resGetSemaphoreCounterValue == VK_SUCCESS, "Failed to get Semaphore counter value -> returned : %s", ResultString(resGetSemaphoreCounterValue));
+
+        // return
+        return value;
+    }
+
     [[nodiscard]] inline uint32 AcquireNextImage(const VkDevice& device, const VkSwapchainKHR& swapchain, const uint64& timeout, const VkSemaphore& semaphore, const VkFence& fence){
         // check valid device handle
         CHECK_VULKAN_HANDLE(device)
@@ -1062,10 +1235,10 @@ namespace Vulkan{
      * @param cmdBuffer 
      * @param firstBinding 
      * @param bindingCount 
-     * @param buffers vector of buffers that needs to be bound
-     * @param offsets vector of offsets for each buffer (each buffer may be a part of single large chunk of data)
+     * @param buffers buffers that needs to be bound
+     * @param offsets offsets for each buffer (each buffer may be a part of single large chunk of data)
      */
-    inline void CmdBindVertexBuffers(const VkCommandBuffer& cmdBuffer, const uint32& firstBinding, const uint32& bindingCount, const std::vector<VkBuffer>& buffers, const std::vector<VkDeviceSize>& offsets){
+    inline void CmdBindVertexBuffers(const VkCommandBuffer& cmdBuffer, const uint32& firstBinding, const uint32& bindingCount, const Span<VkBuffer>& buffers, const Span<VkDeviceSize>& offsets){
         // check valid command buffer handle
         CHECK_VULKAN_HANDLE(cmdBuffer)
 
@@ -1073,6 +1246,20 @@ namespace Vulkan{
         vkCmdBindVertexBuffers(cmdBuffer, firstBinding, bindingCount, buffers.data(), offsets.data());
     }
 
+    /**
+     * @brief execute secondary command buffers from a primary command buffer
+     * 
+     * @param cmdBuffer primary command buffer
+     * @param secondaryCmdBuffers 
+     */
+    inline void CmdExecuteCommands(const VkCommandBuffer& cmdBuffer, const Span<VkCommandBuffer>& secondaryCmdBuffers){
+        // check valid command buffer handle
+        CHECK_VULKAN_HANDLE(cmdBuffer)
+
+        // execute
+        vkCmdExecuteCommands(cmdBuffer, secondaryCmdBuffers.size(), secondaryCmdBuffers.data());
+    }
+
     /**
      * @brief push constants to shader stages
      * 
@@ -1098,7 +1285,7 @@ namespace Vulkan{
      * @param submitInfos 
      * @param fence 
      */
-    inline void QueueSumbit(const VkQueue& queue, const std::vector<VkSubmitInfo>& submitInfos, const VkFence& fence){
+    inline void QueueSumbit(const VkQueue& queue, const Span<VkSubmitInfo>& submitInfos, const VkFence& fence){
         // check valid queue handle
         CHECK_VULKAN_HANDLE(queue)
 
@@ -1169,6 +1356,26 @@ namespace Vulkan{
         vkCmdDraw(cmdBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
     }
 
+    /**
+     * @brief copy regions of one buffer to another
+     * 
+     * @param cmdBuffer 
+     * @param srcBuffer 
+     * @param dstBuffer 
+     * @param regions all regions to copy, recorded in one command
+     */
+    inline void CmdCopyBuffer(const VkCommandBuffer& cmdBuffer, const VkBuffer& srcBuffer, const VkBuffer& dstBuffer, const Span<VkBufferCopy>& regions){
+        // check valid command buffer handle
+        CHECK_VULKAN_HANDLE(cmdBuffer)
+
+        // check valid buffer handles
+        CHECK_VULKAN_HANDLE(srcBuffer)
+        CHECK_VULKAN_HANDLE(dstBuffer)
+
+        // copy
+        vkCmdCopyBuffer(cmdBuffer, srcBuffer, dstBuffer, static_cast<uint32>(regions.size()), regions.data());
+    }
+
     /**
      * @brief what for device until it becomes idle
      * 
@@ -1240,6 +1447,26 @@ namespace Vulkan{
         return pool;
     }
 
+    /**
+     * @brief return all descriptor sets of a pool to it at once
+     * 
+     * @param device 
+     * @param descriptorPool 
+     */
+    inline void ResetDescriptorPool(const VkDevice& device, const VkDescriptorPool& descriptorPool){
+        // check valid device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check valid descriptor pool handle
+        CHECK_VULKAN_HANDLE(descriptorPool)
+
+        // reset
+        VkResult resResetDescriptorPool = vkResetDescriptorPool(device, descriptorPool, 0);
+
+        // check success
+        ASSERT(resResetDescriptorPool == VK_SUCCESS, "Descriptor Pool reset failed -> returned : %s", ResultString(resResetDescriptorPool));
+    }
+
 
     /**
      * @brief submit to present queue
@@ -1353,7 +1580,7 @@ namespace Vulkan{
      * @param descriptorWrites 
      * @param descriptorCopies 
      */
-    inline void UpdateDescriptorSets(const VkDevice& device, const std::vector<VkWriteDescriptorSet>& descriptorWrites, const std::vector<VkCopyDescriptorSet>& descriptorCopies = std::vector<VkCopyDescriptorSet>(0)){
+    inline void UpdateDescriptorSets(const VkDevice& device, const Span<VkWriteDescriptorSet>& descriptorWrites, const Span<VkCopyDescriptorSet>& descriptorCopies = {}){
         // check device handle
         CHECK_VULKAN_HANDLE(device)
 
@@ -1361,6 +1588,71 @@ namespace Vulkan{
         vkUpdateDescriptorSets(device, descriptorWrites.size(), descriptorWrites.data(), descriptorCopies.size(), descriptorCopies.data());
     }
 
+    /**
+     * @brief create descriptor update template
+     *
+     * @param device
+     * @param createInfo
+     * @param allocator
+     * @return VkDescriptorUpdateTemplate
+     */
+    [[nodiscard]] inline VkDescriptorUpdateTemplate CreateDescriptorUpdateTemplate(const VkDevice& device, const VkDescriptorUpdateTemplateCreateInfo& createInfo, const VkAllocationCallbacks* allocator = nullptr){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // template handle
+        VkDescriptorUpdateTemplate updateTemplate;
+
+        // create
+        VkResult resCreateDescriptorUpdateTemplate = vkCreateDescriptorUpdateTemplate(device, &createInfo, allocator, &updateTemplate);
+
+        // check success
+        ASSERT(resCreateDescriptorUpdateTemplate == VK_SUCCESS, "Descriptor Update Template creation failed -> returned : %s", ResultString(resCreateDescriptorUpdateTemplate));
+
+        // print success
+        LOG(success, "[CreateDescriptorUpdateTemplate] : Descriptor Update Template creation successful");
+
+        // return
+        return updateTemplate;
+    }
+
+    /**
+     * @brief destroy descriptor update template
+     *
+     * @param device
+     * @param updateTemplate
+     * @param allocator
+     */
+    inline void DestroyDescriptorUpdateTemplate(const VkDevice& device, const VkDescriptorUpdateTemplate& updateTemplate, const VkAllocationCallbacks* allocator = nullptr) noexcept{
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check template handle
+        CHECK_VULKAN_HANDLE(updateTemplate)
+
+        // destroy
+        vkDestroyDescriptorUpdateTemplate(device, updateTemplate, allocator);
+    }
+
+    /**
+     * @brief write all descriptors of a set in one call, data is laid out as described by template entries
+     *
+     * @param device
+     * @param descriptorSet
+     * @param updateTemplate
+     * @param data
+     */
+    inline void UpdateDescriptorSetWithTemplate(const VkDevice& device, const VkDescriptorSet& descriptorSet, const VkDescriptorUpdateTemplate& updateTemplate, const void* data){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check template handle
+        CHECK_VULKAN_HANDLE(updateTemplate)
+
+        // update
+        vkUpdateDescriptorSetWithTemplate(device, descriptorSet, updateTemplate, data);
+    }
+
     /**
      * @brief bind descriptor sets
      * 
@@ -1371,7 +1663,7 @@ namespace Vulkan{
      * @param descriptorSets 
      * @param dynamicOffsets 
      */
-    inline void CmdBindDescriptorSets(const VkCommandBuffer& commandBuffer, const VkPipelineBindPoint& pipelineBindPoint, const VkPipelineLayout& pipelineLayout, const uint32& firstSet, const std::vector<VkDescriptorSet>& descriptorSets, const std::vector<uint32>& dynamicOffsets = std::vector<uint32>(0)){
+    inline void CmdBindDescriptorSets(const VkCommandBuffer& commandBuffer, const VkPipelineBindPoint& pipelineBindPoint, const VkPipelineLayout& pipelineLayout, const uint32& firstSet, const Span<VkDescriptorSet>& descriptorSets, const Span<uint32>& dynamicOffsets = {}){
         // check valid command buffer handle
         CHECK_VULKAN_HANDLE(commandBuffer)
     
@@ -1522,6 +1814,631 @@ namespace Vulkan{
         return pipeline;
     }
 
+    /**
+     * @brief destroy buffer
+     * 
+     * @param device 
+     * @param buffer 
+     * @param allocator 
+     */
+    inline void DestroyBuffer(const VkDevice& device, const VkBuffer& buffer, const VkAllocationCallbacks* allocator = nullptr) noexcept{
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check buffer handle
+        CHECK_VULKAN_HANDLE(buffer)
+
+        // destroy
+        vkDestroyBuffer(device, buffer, allocator);
+    }
+
+    /**
+     * @brief create a buffer. memory is not allocated for the buffer,
+     *        use Vulkan::Memory or AllocateMemory + BindBufferMemory for that
+     * 
+     * @param device 
+     * @param bufferCreateInfo 
+     * @param allocator 
+     * @return VkBuffer 
+     */
+    [[nodiscard]] inline VkBuffer CreateBuffer(const VkDevice& device, const VkBufferCreateInfo& bufferCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // buffer handle
+        VkBuffer buffer;
+
+        // create
+        VkResult resCreateBuffer = vkCreateBuffer(device, &bufferCreateInfo, allocator, &buffer);
+
+        // check success
+        ASSERT(resCreateBuffer == VK_SUCCESS, "Buffer creation failed -> returned : %s", ResultString(resCreateBuffer));
+
+        // print success
+        LOG(success, "[CreateBuffer] : Buffer creation successful");
+
+        // return
+        return buffer;
+    }
+
+    /**
+     * @brief get memory requirements of a buffer
+     * 
+     * @param device 
+     * @param buffer 
+     * @return VkMemoryRequirements 
+     */
+    [[nodiscard]] inline VkMemoryRequirements GetBufferMemoryRequirements(const VkDevice& device, const VkBuffer& buffer) noexcept{
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check buffer handle
+        CHECK_VULKAN_HANDLE(buffer)
+
+        // get and return requirements
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device, buffer, &requirements);
+        return requirements;
+    }
+
+    /**
+     * @brief bind memory to a buffer
+     * 
+     * @param device 
+     * @param buffer 
+     * @param memory 
+     * @param offset in bytes from start of memory
+     */
+    inline void BindBufferMemory(const VkDevice& device, const VkBuffer& buffer, const VkDeviceMemory& memory, const VkDeviceSize& offset){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check buffer handle
+        CHECK_VULKAN_HANDLE(buffer)
+
+        // check memory handle
+        CHECK_VULKAN_HANDLE(memory)
+
+        // bind
+        VkResult resBindBufferMemory = vkBindBufferMemory(device, buffer, memory, offset);
+
+        // check success
+        ASSERT(resBindBufferMemory == VK_SUCCESS, "Failed to bind Buffer memory -> returned : %s", ResultString(resBindBufferMemory));
+    }
+
+    /**
+     * @brief destroy image
+     * 
+     * @param device 
+     * @param image 
+     * @param allocator 
+     */
+    inline void DestroyImage(const VkDevice& device, const VkImage& image, const VkAllocationCallbacks* allocator = nullptr) noexcept{
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check image handle
+        CHECK_VULKAN_HANDLE(image)
+
+        // destroy
+        vkDestroyImage(device, image, allocator);
+    }
+
+    /**
+     * @brief create an image. memory is not allocated for the image,
+     *        use Vulkan::Memory or AllocateMemory + BindImageMemory for that
+     * 
+     * @param device 
+     * @param imageCreateInfo 
+     * @param allocator 
+     * @return VkImage 
+     */
+    [[nodiscard]] inline VkImage CreateImage(const VkDevice& device, const VkImageCreateInfo& imageCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // image handle
+        VkImage image;
+
+        // create
+        VkResult resCreateImage = vkCreateImage(device, &imageCreateInfo, allocator, &image);
+
+        // check success
+        ASSERT(resCreateImage == VK_SUCCESS, "Image creation failed -> returned : %s", ResultString(resCreateImage));
+
+        // print success
+        LOG(success, "[CreateImage] : Image creation successful");
+
+        // return
+        return image;
+    }
+
+    /**
+     * @brief get memory requirements of an image
+     * 
+     * @param device 
+     * @param image 
+     * @return VkMemoryRequirements 
+     */
+    [[nodiscard]] inline VkMemoryRequirements GetImageMemoryRequirements(const VkDevice& device, const VkImage& image) noexcept{
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check image handle
+        CHECK_VULKAN_HANDLE(image)
+
+        // get and return requirements
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(device, image, &requirements);
+        return requirements;
+    }
+
+    /**
+     * @brief bind memory to an image
+     * 
+     * @param device 
+     * @param image 
+     * @param memory 
+     * @param offset in bytes from start of memory
+     */
+    inline void BindImageMemory(const VkDevice& device, const VkImage& image, const VkDeviceMemory& memory, const VkDeviceSize& offset){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check image handle
+        CHECK_VULKAN_HANDLE(image)
+
+        // check memory handle
+        CHECK_VULKAN_HANDLE(memory)
+
+        // bind
+        VkResult resBindImageMemory = vkBindImageMemory(device, image, memory, offset);
+
+        // check success
+        ASSERT(resBindImageMemory == VK_SUCCESS, "Failed to bind Image memory -> returned : %s", ResultString(resBindImageMemory));
+    }
+
+    /**
+     * @brief free device memory
+     * 
+     * @param device 
+     * @param memory 
+     * @param allocator 
+     */
+    inline void FreeMemory(const VkDevice& device, const VkDeviceMemory& memory, const VkAllocationCallbacks* allocator = nullptr) noexcept{
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check memory handle
+        CHECK_VULKAN_HANDLE(memory)
+
+        // free
+        vkFreeMemory(device, memory, allocator);
+    }
+
+    /**
+     * @brief allocate device memory.
+     *        every call is one allocation out of maxMemoryAllocationCount,
+     *        prefer sub-allocating with Vulkan::Memory
+     * 
+     * @param device 
+     * @param allocateInfo 
+     * @param allocator 
+     * @return VkDeviceMemory 
+     */
+    [[nodiscard]] inline VkDeviceMemory AllocateMemory(const VkDevice& device, const VkMemoryAllocateInfo& allocateInfo, const VkAllocationCallbacks* allocator = nullptr){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // memory handle
+        VkDeviceMemory memory;
+
+        // allocate
+        VkResult resAllocateMemory = vkAllocateMemory(device, &allocateInfo, allocator, &memory);
+
+        // check success
+        ASSERT(resAllocateMemory == VK_SUCCESS, "Memory allocation failed -> returned : %s", ResultString(resAllocateMemory));
+
+        // print success
+        LOG(success, "[AllocateMemory] : Allocated %" PRIu64 " bytes from memory type %i", static_cast<uint64>(allocateInfo.allocationSize), allocateInfo.memoryTypeIndex);
+
+        // return
+        return memory;
+    }
+
+    /**
+     * @brief map device memory into host address space
+     * 
+     * @param device 
+     * @param memory must be allocated from a HOST_VISIBLE memory type
+     * @param offset 
+     * @param size use VK_WHOLE_SIZE to map till the end of allocation
+     * @return void* host pointer to mapped memory
+     */
+    [[nodiscard]] inline void* MapMemory(const VkDevice& device, const VkDeviceMemory& memory, const VkDeviceSize& offset = 0, const VkDeviceSize& size = VK_WHOLE_SIZE){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check memory handle
+        CHECK_VULKAN_HANDLE(memory)
+
+        // map
+        void* data = nullptr;
+        VkResult resMapMemory = vkMapMemory(device, memory, offset, size, 0, &data);
+
+        // check success
+        ASSERT(resMapMemory == VK_SUCCESS, "Failed to map memory -> returned : %s", ResultString(resMapMemory));
+
+        // return
+        return data;
+    }
+
+    /**
+     * @brief unmap previously mapped device memory
+     * 
+     * @param device 
+     * @param memory 
+     */
+    inline void UnmapMemory(const VkDevice& device, const VkDeviceMemory& memory) noexcept{
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check memory handle
+        CHECK_VULKAN_HANDLE(memory)
+
+        // unmap
+        vkUnmapMemory(device, memory);
+    }
+
+    /**
+     * @brief destroy pipeline cache
+     * 
+     * @param device 
+     * @param pipelineCache 
+     * @param allocator 
+     */
+    inline void DestroyPipelineCache(const VkDevice& device, const VkPipelineCache& pipelineCache, const VkAllocationCallbacks* allocator = nullptr) noexcept{
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check pipeline cache handle
+        CHECK_VULKAN_HANDLE(pipelineCache)
+
+        // destroy
+        vkDestroyPipelineCache(device, pipelineCache, allocator);
+    }
+
+    /**
+     * @brief create pipeline cache
+     * 
+     * @param device 
+     * @param createInfo 
+     * @param allocator 
+     * @return VkPipelineCache 
+     */
+    [[nodiscard]] inline VkPipelineCache CreatePipelineCache(const VkDevice& device, const VkPipelineCacheCreateInfo& createInfo, const VkAllocationCallbacks* allocator = nullptr){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // pipeline cache handle
+        VkPipelineCache pipelineCache;
+
+        // create
+        VkResult resCreatePipelineCache = vkCreatePipelineCache(device, &createInfo, allocator, &pipelineCache);
+
+        // check success
+        ASSERT(resCreatePipelineCache == VK_SUCCESS, "Pipeline Cache creation failed -> returned : %s", ResultString(resCreatePipelineCache));
+
+        // print success
+        LOG(success, "[CreatePipelineCache] : Pipeline Cache creation successful");
+
+        // return
+        return pipelineCache;
+    }
+
+    /**
+     * @brief get serialized data of a pipeline cache
+     * 
+     * @param device 
+     * @param pipelineCache 
+     * @return std::vector<uint8> : cache blob, starts with a VkPipelineCacheHeaderVersionOne
+     */
+    [[nodiscard]] inline std::vector<uint8> GetPipelineCacheData(const VkDevice& device, const VkPipelineCache& pipelineCache){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check pipeline cache handle
+        CHECK_VULKAN_HANDLE(pipelineCache)
+
+        // get data size
+        size_t size = 0;
+        VkResult res = vkGetPipelineCacheData(device, pipelineCache, &size, nullptr);
+        if(res != VK_SUCCESS) LOG(error, "[GetPipelineCacheData] : %s", ResultString(res));
+
+        // get data
+        std::vector<uint8> data(size);
+        res = vkGetPipelineCacheData(device, pipelineCache, &size, data.data());
+        if(res != VK_SUCCESS) LOG(error, "[GetPipelineCacheData] : %s", ResultString(res));
+        data.resize(size);
+
+        return data;
+    }
+
+    /**
+     * @brief merge pipeline caches into one
+     * 
+     * @param device 
+     * @param dstCache cache to merge into
+     * @param srcCaches caches to merge from
+     */
+    inline void MergePipelineCaches(const VkDevice& device, const VkPipelineCache& dstCache, const std::vector<VkPipelineCache>& srcCaches){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check destination cache handle
+        CHECK_VULKAN_HANDLE(dstCache)
+
+        // merge
+        VkResult resMergePipelineCaches = vkMergePipelineCaches(device, dstCache, static_cast<uint32>(srcCaches.size()), srcCaches.data());
+
+        // check success
+        ASSERT(resMergePipelineCaches == VK_SUCCESS, "Pipeline Cache merge failed -> returned : %s", ResultString(resMergePipelineCaches));
+    }
+
+    /**
+     * @brief create query pool
+     * 
+     * @param device 
+     * @param createInfo 
+     * @param allocator 
+     * @return VkQueryPool 
+     */
+    [[nodiscard]] inline VkQueryPool CreateQueryPool(const VkDevice& device, const VkQueryPoolCreateInfo& createInfo, const VkAllocationCallbacks* allocator = nullptr){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // query pool handle
+        VkQueryPool queryPool;
+
+        // create
+        VkResult resCreateQueryPool = vkCreateQueryPool(device, &createInfo, allocator, &queryPool);
+
+        // check success
+        ASSERT(resCreateQueryPool == VK_SUCCESS, "Query Pool creation failed -> returned : %s", ResultString(resCreateQueryPool));
+
+        // print success
+        LOG(success, "[CreateQueryPool] : Query Pool creation successful");
+
+        // return
+        return queryPool;
+    }
+
+    /**
+     * @brief destroy query pool
+     * 
+     * @param device 
+     * @param queryPool 
+     * @param allocator 
+     */
+    inline void DestroyQueryPool(const VkDevice& device, const VkQueryPool& queryPool, const VkAllocationCallbacks* allocator = nullptr) noexcept{
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check query pool handle
+        CHECK_VULKAN_HANDLE(queryPool)
+
+        // destroy
+        vkDestroyQueryPool(device, queryPool, allocator);
+    }
+
+    /**
+     * @brief reset a range of queries, must be recorded before queries are written again
+     * 
+     * @param cmdBuffer 
+     * @param queryPool 
+     * @param firstQuery 
+     * @param queryCount 
+     */
+    inline void CmdResetQueryPool(const VkCommandBuffer& cmdBuffer, const VkQueryPool& queryPool, const uint32& firstQuery, const uint32& queryCount){
+        // check valid command buffer handle
+        CHECK_VULKAN_HANDLE(cmdBuffer)
+
+        // check query pool handle
+        CHECK_VULKAN_HANDLE(queryPool)
+
+        // reset
+        vkCmdResetQueryPool(cmdBuffer, queryPool, firstQuery, queryCount);
+    }
+
+    /**
+     * @brief write GPU timestamp to a query when all previous commands reach given stage
+     * 
+     * @param cmdBuffer 
+     * @param stage 
+     * @param queryPool 
+     * @param query 
+     */
+    inline void CmdWriteTimestamp(const VkCommandBuffer& cmdBuffer, const VkPipelineStageFlagBits& stage, const VkQueryPool& queryPool, const uint32& query){
+        // check valid command buffer handle
+        CHECK_VULKAN_HANDLE(cmdBuffer)
+
+        // check query pool handle
+        CHECK_VULKAN_HANDLE(queryPool)
+
+        // write
+        vkCmdWriteTimestamp(cmdBuffer, stage, queryPool, query);
+    }
+
+    /**
+     * @brief read back 64 bit results of a range of queries without waiting for them
+     * 
+     * @param device 
+     * @param queryPool 
+     * @param firstQuery 
+     * @param queryCount 
+     * @param results resized to queryCount and filled with results
+     * @param flags VK_QUERY_RESULT_64_BIT is always added
+     * @return true if all results were available
+     * @return false if some results are not ready yet
+     */
+    inline bool GetQueryPoolResults(const VkDevice& device, const VkQueryPool& queryPool, const uint32& firstQuery, const uint32& queryCount, std::vector<uint64>& results, const VkQueryResultFlags& flags = 0){
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // check query pool handle
+        CHECK_VULKAN_HANDLE(queryPool)
+
+        // get results
+        results.resize(queryCount);
+        VkResult res = vkGetQueryPoolResults(device, queryPool, firstQuery, queryCount, results.size() * sizeof(uint64), results.data(), sizeof(uint64), flags | VK_QUERY_RESULT_64_BIT);
+        if(res == VK_NOT_READY) return false;
+
+        // check success
+        ASSERT(res == VK_SUCCESS, "Get Query Pool Results failed -> returned : %s", ResultString(res));
+
+        // return
+        return true;
+    }
+
+    /// vkCmdPipelineBarrier2KHR, loader doesn't export device extension commands so it's loaded by LoadSynchronization2
+    inline PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2 = nullptr;
+
+    /**
+     * @brief load VK_KHR_synchronization2 commands, device must be created with the extension and feature enabled
+     * 
+     * @param device 
+     * @return true if commands were found
+     * @return false otherwise, CmdPipelineBarrier2 then falls back to vkCmdPipelineBarrier
+     */
+    inline bool LoadSynchronization2(const VkDevice& device) noexcept{
+        // check device handle
+        CHECK_VULKAN_HANDLE(device)
+
+        // load
+        cmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2KHR>(vkGetDeviceProcAddr(device, "vkCmdPipelineBarrier2KHR"));
+        if(cmdPipelineBarrier2 != nullptr) LOG(success, "[LoadSynchronization2] : Loaded vkCmdPipelineBarrier2KHR");
+
+        // return
+        return cmdPipelineBarrier2 != nullptr;
+    }
+
+    /**
+     * @brief convert synchronization2 stages to vkCmdPipelineBarrier stages.
+     *        Split transfer, vertex input and pre-rasterization stages become the legacy
+     *        stages containing them, other synchronization2-only stages can't be converted.
+     * 
+     * @param stages 
+     * @return VkPipelineStageFlags 
+     */
+    [[nodiscard]] inline VkPipelineStageFlags LegacyPipelineStageFlags(const VkPipelineStageFlags2KHR& stages){
+        constexpr VkPipelineStageFlags2KHR transferStages = VK_PIPELINE_STAGE_2_COPY_BIT_KHR | VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR |
+                                                            VK_PIPELINE_STAGE_2_BLIT_BIT_KHR | VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR;
+        constexpr VkPipelineStageFlags2KHR vertexInputStages = VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR;
+        constexpr VkPipelineStageFlags2KHR legacyStages = 0xFFFFFFFFull;
+        ASSERT((stages & ~(legacyStages | transferStages | vertexInputStages | VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR)) == 0,
+               "Stage mask 0x%llx has synchronization2 stages with no vkCmdPipelineBarrier equivalent", static_cast<unsigned long long>(stages));
+
+        VkPipelineStageFlags legacy = static_cast<VkPipelineStageFlags>(stages & legacyStages);
+        if(stages & transferStages) legacy |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+        if(stages & vertexInputStages) legacy |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+        // tessellation and geometry stages need their features, all graphics is valid without them
+        if(stages & VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR) legacy |= VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT;
+
+        // return
+        return legacy;
+    }
+
+    /**
+     * @brief convert synchronization2 accesses to vkCmdPipelineBarrier accesses.
+     *        Sampled and storage shader accesses become shader read/write.
+     * 
+     * @param access 
+     * @return VkAccessFlags 
+     */
+    [[nodiscard]] inline VkAccessFlags LegacyAccessFlags(const VkAccessFlags2KHR& access){
+        constexpr VkAccessFlags2KHR shaderReads = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR;
+        constexpr VkAccessFlags2KHR legacyAccess = 0xFFFFFFFFull;
+        ASSERT((access & ~(legacyAccess | shaderReads | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR)) == 0,
+               "Access mask 0x%llx has synchronization2 accesses with no vkCmdPipelineBarrier equivalent", static_cast<unsigned long long>(access));
+
+        VkAccessFlags legacy = static_cast<VkAccessFlags>(access & legacyAccess);
+        if(access & shaderReads) legacy |= VK_ACCESS_SHADER_READ_BIT;
+        if(access & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR) legacy |= VK_ACCESS_SHADER_WRITE_BIT;
+
+        // return
+        return legacy;
+    }
+
+    /**
+     * @brief record a pipeline barrier from synchronization2 structs.
+     *        Without VK_KHR_synchronization2 (see LoadSynchronization2) barriers are converted to
+     *        vkCmdPipelineBarrier with LegacyPipelineStageFlags and LegacyAccessFlags.
+     * 
+     * @param cmdBuffer 
+     * @param dependencyInfo 
+     */
+    inline void CmdPipelineBarrier2(const VkCommandBuffer& cmdBuffer, const VkDependencyInfoKHR& dependencyInfo){
+        // check valid command buffer handle
+        CHECK_VULKAN_HANDLE(cmdBuffer)
+
+        if(cmdPipelineBarrier2 != nullptr){
+            cmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+            return;
+        }
+
+        // legacy barriers share one stage mask pair, so stages of all barriers are merged
+        VkPipelineStageFlags2KHR srcStages2 = 0;
+        VkPipelineStageFlags2KHR dstStages2 = 0;
+        for(uint32 i = 0; i < dependencyInfo.memoryBarrierCount; i++){
+            srcStages2 |= dependencyInfo.pMemoryBarriers[i].srcStageMask;
+            dstStages2 |= dependencyInfo.pMemoryBarriers[i].dstStageMask;
+        }
+        for(uint32 i = 0; i < dependencyInfo.bufferMemoryBarrierCount; i++){
+            srcStages2 |= dependencyInfo.pBufferMemoryBarriers[i].srcStageMask;
+            dstStages2 |= dependencyInfo.pBufferMemoryBarriers[i].dstStageMask;
+        }
+        for(uint32 i = 0; i < dependencyInfo.imageMemoryBarrierCount; i++){
+            srcStages2 |= dependencyInfo.pImageMemoryBarriers[i].srcStageMask;
+            dstStages2 |= dependencyInfo.pImageMemoryBarriers[i].dstStageMask;
+        }
+
+        // synchronization2 allows empty stage masks, legacy barriers don't
+        VkPipelineStageFlags srcStages = LegacyPipelineStageFlags(srcStages2);
+        VkPipelineStageFlags dstStages = LegacyPipelineStageFlags(dstStages2);
+        if(srcStages == 0) srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        if(dstStages == 0) dstStages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+        // convert on stack, in chunks. Every chunk has the same stages, and barriers of one call
+        // aren't ordered among themselves anyway, so this is the same as one call with all of them
+        constexpr uint32 chunkSize = 16;
+        uint32 memoryIndex = 0, bufferIndex = 0, imageIndex = 0;
+        do{
+            InlineVector<VkMemoryBarrier, chunkSize> memoryBarriers;
+            for(; memoryIndex < dependencyInfo.memoryBarrierCount && memoryBarriers.size() < chunkSize; memoryIndex++){
+                const VkMemoryBarrier2KHR& barrier = dependencyInfo.pMemoryBarriers[memoryIndex];
+                memoryBarriers.push_back({VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr, LegacyAccessFlags(barrier.srcAccessMask), LegacyAccessFlags(barrier.dstAccessMask)});
+            }
+
+            InlineVector<VkBufferMemoryBarrier, chunkSize> bufferBarriers;
+            for(; bufferIndex < dependencyInfo.bufferMemoryBarrierCount && bufferBarriers.size() < chunkSize; bufferIndex++){
+                const VkBufferMemoryBarrier2KHR& barrier = dependencyInfo.pBufferMemoryBarriers[bufferIndex];
+                bufferBarriers.push_back({VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, nullptr, LegacyAccessFlags(barrier.srcAccessMask), LegacyAccessFlags(barrier.dstAccessMask),
+                                          barrier.srcQueueFamilyIndex, barrier.dstQueueFamilyIndex, barrier.buffer, barrier.offset, barrier.size});
+            }
+
+            InlineVector<VkImageMemoryBarrier, chunkSize> imageBarriers;
+            for(; imageIndex < dependencyInfo.imageMemoryBarrierCount && imageBarriers.size() < chunkSize; imageIndex++){
+                const VkImageMemoryBarrier2KHR& barrier = dependencyInfo.pImageMemoryBarriers[imageIndex];
+                imageBarriers.push_back({VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER, nullptr, LegacyAccessFlags(barrier.srcAccessMask), LegacyAccessFlags(barrier.dstAccessMask),
+                                         barrier.oldLayout, barrier.newLayout, barrier.srcQueueFamilyIndex, barrier.dstQueueFamilyIndex, barrier.image, barrier.subresourceRange});
+            }
+
+            // record
+            vkCmdPipelineBarrier(cmdBuffer, srcStages, dstStages, dependencyInfo.dependencyFlags,
+                                 memoryBarriers.size(), memoryBarriers.data(), bufferBarriers.size(), bufferBarriers.data(), imageBarriers.size(), imageBarriers.data());
+        }while(memoryIndex < dependencyInfo.memoryBarrierCount || bufferIndex < dependencyInfo.bufferMemoryBarrierCount || imageIndex < dependencyInfo.imageMemoryBarrierCount);
+    }
+
 } // namespace Vulkan
 
 
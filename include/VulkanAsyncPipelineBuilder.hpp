@@ -0,0 +1,191 @@
+/**
+ * @file VulkanAsyncPipelineBuilder.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Builds batches of graphics pipelines on a pool of worker threads.
+ * @version 0.1
+ * @date 2021-05-07
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_ASYNC_PIPELINE_BUILDER_HPP
+#define VULKAN_HELPER_VULKAN_ASYNC_PIPELINE_BUILDER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+#include "VulkanPipelineCache.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Compiles graphics pipelines on worker threads.
+     *        A batch is sharded across the workers, every worker compiles its share
+     *        with its own VkPipelineCache so workers never contend on one cache.
+     *        Each pipeline gets a future that becomes ready as soon as that pipeline
+     *        is compiled. Wait() joins the workers and merges their caches back.
+     *
+     *        Everything a create info points to (shader stages, states, pNext chains)
+     *        must stay alive until the futures of that batch are ready.
+     *
+     */
+    struct AsyncPipelineBuilder{
+        /**
+         * @brief one call to Build and the workers compiling it
+         *
+         */
+        struct Batch{
+            /// copy of create infos passed to Build
+            std::vector<VkGraphicsPipelineCreateInfo> createInfos;
+
+            /// one promise per pipeline
+            std::vector<std::promise<VkPipeline>> promises;
+
+            /// worker threads of this batch
+            std::vector<std::thread> workers;
+
+            /// one cache for each worker
+            std::vector<VkPipelineCache> caches;
+        };
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// cache worker caches are seeded from and merged into, can be null
+        PipelineCache* pipelineCache = nullptr;
+
+        /// number of worker threads per batch
+        uint32 threadCount = 1;
+
+        /// batches that are not waited for yet
+        std::vector<std::unique_ptr<Batch>> batches;
+
+        /**
+         * @brief initialize builder
+         *
+         * @param device
+         * @param pipelineCache cache to seed workers from and merge results into, can be null
+         * @param threadCount number of workers, 0 means one per hardware thread
+         */
+        inline void Init(const VkDevice& device, PipelineCache* pipelineCache = nullptr, const uint32& threadCount = 0){
+            this->device = device;
+            this->pipelineCache = pipelineCache;
+            this->threadCount = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        /**
+         * @brief start compiling a batch of pipelines in background
+         *
+         * @param createInfos pipelines to create
+         * @return std::vector<std::shared_future<VkPipeline>> : one future per create info, in same order
+         */
+        [[nodiscard]] inline std::vector<std::shared_future<VkPipeline>> Build(const std::vector<VkGraphicsPipelineCreateInfo>& createInfos){
+            // nothing to compile, don't create caches or a batch
+            if(createInfos.empty()) return {};
+
+            std::unique_ptr<Batch> batch = std::make_unique<Batch>();
+            batch->createInfos = createInfos;
+            batch->promises.resize(createInfos.size());
+
+            std::vector<std::shared_future<VkPipeline>> futures;
+            futures.reserve(createInfos.size());
+            for(auto& promise : batch->promises){
+                futures.push_back(promise.get_future().share());
+            }
+
+            // no need for more workers than pipelines
+            uint32 workerCount = std::min(threadCount, static_cast<uint32>(createInfos.size()));
+
+            // seed worker caches with what is already known
+            std::vector<uint8> initialData;
+            if(pipelineCache != nullptr){
+                initialData = pipelineCache->GetData();
+            }
+
+            batch->caches.resize(workerCount);
+            for(auto& cache : batch->caches){
+                cache = CreatePipelineCache(device, Vulkan::Init::PipelineCacheCreateInfo(initialData.data(), initialData.size()));
+            }
+
+            // interleave pipelines so expensive neighbours end up on different workers
+            Batch* batchPtr = batch.get();
+            for(uint32 w = 0; w < workerCount; w++){
+                batch->workers.emplace_back([this, batchPtr, w, workerCount](){
+                    for(size_t i = w; i < batchPtr->createInfos.size(); i += workerCount){
+                        VkPipeline pipeline = CreateGraphicsPipeline(device, batchPtr->caches[w], batchPtr->createInfos[i]);
+                        batchPtr->promises[i].set_value(pipeline);
+                    }
+                });
+            }
+
+            batches.push_back(std::move(batch));
+            return futures;
+        }
+
+        /**
+         * @brief check if a pipeline is compiled without blocking
+         *
+         * @param future returned by Build
+         * @return true if pipeline can be retrieved with get()
+         * @return false otherwise
+         */
+        [[nodiscard]] static inline bool IsReady(const std::shared_future<VkPipeline>& future){
+            return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        /**
+         * @brief wait for all batches to finish and merge worker caches
+         *
+         */
+        inline void Wait(){
+            for(auto& batch : batches){
+                for(auto& worker : batch->workers){
+                    worker.join();
+                }
+
+                if(pipelineCache != nullptr && !batch->caches.empty()){
+                    pipelineCache->Merge(batch->caches);
+                }
+
+                for(auto& cache : batch->caches){
+                    DestroyPipelineCache(device, cache);
+                }
+            }
+
+            batches.clear();
+        }
+
+        /**
+         * @brief wait for all batches
+         *
+         */
+        inline void Destroy(){
+            Wait();
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_ASYNC_PIPELINE_BUILDER_HPP
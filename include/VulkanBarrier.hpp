@@ -0,0 +1,527 @@
+/**
+ * @file VulkanBarrier.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Resource state tracker that emits minimal batched pipeline barriers.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_BARRIER_HPP
+#define VULKAN_HELPER_VULKAN_BARRIER_HPP
+
+#include <iterator>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief how a command uses a resource
+     *
+     */
+    struct ResourceState{
+        /// stages that access the resource
+        VkPipelineStageFlags2KHR stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+
+        /// accesses done in those stages
+        VkAccessFlags2KHR access = VK_ACCESS_2_NONE_KHR;
+
+        /// layout images must be in, ignored for buffers
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+
+    /**
+     * @brief common resource states, all of them only use stage/access bits that
+     *        exist in Vulkan 1.0 too, so they work with the vkCmdPipelineBarrier fallback
+     *
+     */
+    namespace Access{
+        inline constexpr ResourceState None                 = {};
+        inline constexpr ResourceState TransferSrc          = {VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL};
+        inline constexpr ResourceState TransferDst          = {VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+        inline constexpr ResourceState VertexBuffer         = {VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR};
+        inline constexpr ResourceState IndexBuffer          = {VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR, VK_ACCESS_2_INDEX_READ_BIT_KHR};
+        inline constexpr ResourceState IndirectBuffer       = {VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR};
+        inline constexpr ResourceState UniformBuffer        = {VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_UNIFORM_READ_BIT_KHR};
+        inline constexpr ResourceState VertexShaderRead     = {VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        inline constexpr ResourceState FragmentShaderRead   = {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        inline constexpr ResourceState ComputeShaderRead    = {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        inline constexpr ResourceState ComputeShaderWrite   = {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_GENERAL};
+        inline constexpr ResourceState ComputeShaderReadWrite = {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_GENERAL};
+        inline constexpr ResourceState ColorAttachment      = {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+        inline constexpr ResourceState DepthAttachment      = {VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+        inline constexpr ResourceState DepthRead            = {VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+        inline constexpr ResourceState HostRead             = {VK_PIPELINE_STAGE_2_HOST_BIT_KHR, VK_ACCESS_2_HOST_READ_BIT_KHR};
+        inline constexpr ResourceState HostWrite            = {VK_PIPELINE_STAGE_2_HOST_BIT_KHR, VK_ACCESS_2_HOST_WRITE_BIT_KHR};
+        inline constexpr ResourceState Present              = {VK_PIPELINE_STAGE_2_NONE_KHR, VK_ACCESS_2_NONE_KHR, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR};
+
+        /// every access that writes memory
+        inline constexpr VkAccessFlags2KHR writeMask = VK_ACCESS_2_SHADER_WRITE_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR |
+                                                       VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR | VK_ACCESS_2_HOST_WRITE_BIT_KHR |
+                                                       VK_ACCESS_2_MEMORY_WRITE_BIT_KHR | VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR |
+                                                       VK_ACCESS_2_TRANSFORM_FEEDBACK_WRITE_BIT_EXT | VK_ACCESS_2_COMMAND_PREPROCESS_WRITE_BIT_NV;
+    } // namespace Access
+
+    /**
+     * @brief Tracks the last access of every image subresource and buffer range and
+     *        computes only the barriers needed for the next use:
+     *
+     *        - read after read in the same layout   : nothing
+     *        - read after write                     : write -> read, once per reading stage/access
+     *        - write after read                     : execution dependency only, no access masks
+     *        - write after write / layout change    : full memory dependency
+     *
+     *        Use* calls only queue barriers, Flush records all of them with a single
+     *        vkCmdPipelineBarrier2. Image barriers of neighbouring subresources with equal
+     *        masks are merged, buffer hazards are merged into one global memory barrier.
+     *        Using a subresource or range again while it has a queued barrier starts a new
+     *        batch, Flush records batches in order as if it had been called in between.
+     *
+     *        Uses must be declared in the order GPU executes them, so one tracker belongs to
+     *        one queue and is not thread safe.
+     *
+     */
+    struct BarrierTracker{
+        /**
+         * @brief access history of one image subresource or buffer range
+         *
+         */
+        struct TrackedState{
+            /// stages of last write or layout transition
+            VkPipelineStageFlags2KHR writeStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+
+            /// accesses of last write
+            VkAccessFlags2KHR writeAccess = VK_ACCESS_2_NONE_KHR;
+
+            /// stages that read since last write
+            VkPipelineStageFlags2KHR readStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+
+            /// stages last write has been made visible to
+            VkPipelineStageFlags2KHR visibleStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+
+            /// accesses last write has been made visible to
+            VkAccessFlags2KHR visibleAccess = VK_ACCESS_2_NONE_KHR;
+
+            /// current layout, images only
+            VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+            [[nodiscard]] inline bool operator==(const TrackedState& other) const{
+                return writeStages == other.writeStages && writeAccess == other.writeAccess && readStages == other.readStages &&
+                       visibleStages == other.visibleStages && visibleAccess == other.visibleAccess && layout == other.layout;
+            }
+        };
+
+        /**
+         * @brief masks of one required dependency
+         *
+         */
+        struct Dependency{
+            VkPipelineStageFlags2KHR srcStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+            VkAccessFlags2KHR srcAccess = VK_ACCESS_2_NONE_KHR;
+            VkPipelineStageFlags2KHR dstStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+            VkAccessFlags2KHR dstAccess = VK_ACCESS_2_NONE_KHR;
+            VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+            [[nodiscard]] inline bool operator==(const Dependency& other) const{
+                return srcStages == other.srcStages && srcAccess == other.srcAccess && dstStages == other.dstStages &&
+                       dstAccess == other.dstAccess && oldLayout == other.oldLayout && newLayout == other.newLayout;
+            }
+        };
+
+        /**
+         * @brief tracked subresources of one image, indexed [mip * arrayLayers + layer]
+         *
+         */
+        struct ImageEntry{
+            uint32 mipLevels = 1;
+            uint32 arrayLayers = 1;
+            VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+            std::vector<TrackedState> subresources;
+        };
+
+        /**
+         * @brief tracked range of a buffer, key of map is offset of range
+         *
+         */
+        struct BufferRange{
+            VkDeviceSize end = VK_WHOLE_SIZE;
+            TrackedState state;
+        };
+
+        /**
+         * @brief a buffer range that has a queued barrier
+         *
+         */
+        struct PendingRange{
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkDeviceSize begin = 0;
+            VkDeviceSize end = VK_WHOLE_SIZE;
+        };
+
+        /**
+         * @brief barriers recorded with one vkCmdPipelineBarrier2, each subresource or range appears at most once
+         *
+         */
+        struct Batch{
+            /// image barriers
+            std::vector<VkImageMemoryBarrier2KHR> imageBarriers;
+
+            /// buffer hazards, merged
+            VkMemoryBarrier2KHR memoryBarrier = {};
+
+            /// ranges covered by memoryBarrier
+            std::vector<PendingRange> bufferRanges;
+
+            [[nodiscard]] inline bool Empty() const{
+                return imageBarriers.empty() && bufferRanges.empty();
+            }
+
+            inline void Clear(){
+                imageBarriers.clear();
+                memoryBarrier = {};
+                bufferRanges.clear();
+            }
+        };
+
+        /// registered images
+        std::unordered_map<VkImage, ImageEntry> images;
+
+        /// buffers, each covers [0, VK_WHOLE_SIZE) with ranges of equal state
+        std::unordered_map<VkBuffer, std::map<VkDeviceSize, BufferRange>> buffers;
+
+        /// queued barriers in recording order, only first batchCount are in use. Batches are kept to reuse their memory
+        std::vector<Batch> batches = std::vector<Batch>(1);
+
+        /// number of batches in use, always at least one
+        size_t batchCount = 1;
+
+        /**
+         * @brief compute dependency for next use of a subresource/range and update its state
+         *
+         * @param state tracked state, updated to include next use
+         * @param next use
+         * @param isImage whether layouts matter
+         * @param dependency filled when a barrier is needed
+         * @return true if a barrier is needed
+         */
+        [[nodiscard]] static inline bool Transition(TrackedState& state, const ResourceState& next, const bool& isImage, Dependency& dependency){
+            const bool writes = (next.access & Access::writeMask) != 0;
+            const bool layoutChange = isImage && next.layout != state.layout;
+            dependency = {};
+            dependency.oldLayout = state.layout;
+            dependency.newLayout = isImage ? next.layout : state.layout;
+
+            if(writes || layoutChange){
+                // wait for every earlier access, earlier reads only need execution order.
+                // a write some barrier already made available is ordered by chaining through the reads after it
+                const bool writeAvailable = state.visibleStages != 0;
+                dependency.srcStages = writeAvailable ? state.readStages : state.writeStages | state.readStages;
+                dependency.srcAccess = writeAvailable ? VK_ACCESS_2_NONE_KHR : state.writeAccess;
+                dependency.dstStages = next.stages;
+                dependency.dstAccess = (dependency.srcAccess != 0 || layoutChange) ? next.access : VK_ACCESS_2_NONE_KHR;
+                const bool needed = layoutChange || dependency.srcStages != 0;
+
+                state.writeStages   = next.stages;
+                state.writeAccess   = next.access & Access::writeMask;
+                state.readStages    = writes ? VK_PIPELINE_STAGE_2_NONE_KHR : next.stages;
+                state.visibleStages = writes ? VK_PIPELINE_STAGE_2_NONE_KHR : next.stages;
+                state.visibleAccess = writes ? VK_ACCESS_2_NONE_KHR : next.access;
+                if(isImage) state.layout = next.layout;
+                return needed;
+            }
+
+            // read, only needs a barrier if last write isn't visible to it yet
+            bool needed = false;
+            if(state.writeStages != 0 && ((next.stages & ~state.visibleStages) != 0 || (next.access & ~state.visibleAccess) != 0)){
+                dependency.srcStages = state.writeStages;
+                dependency.srcAccess = state.writeAccess;
+                dependency.dstStages = next.stages;
+                dependency.dstAccess = next.access;
+                state.visibleStages |= next.stages;
+                state.visibleAccess |= next.access;
+                needed = true;
+            }
+            state.readStages |= next.stages;
+            return needed;
+        }
+
+        /**
+         * @brief start tracking an image, replaces previous tracking of it (eg. for swapchain images after acquire)
+         *
+         * @param image
+         * @param mipLevels
+         * @param arrayLayers
+         * @param aspect
+         * @param layout current layout of all subresources
+         */
+        inline void RegisterImage(const VkImage& image, const uint32& mipLevels = 1, const uint32& arrayLayers = 1, const VkImageAspectFlags& aspect = VK_IMAGE_ASPECT_COLOR_BIT, const VkImageLayout& layout = VK_IMAGE_LAYOUT_UNDEFINED){
+            ImageEntry& entry = images[image];
+            entry.mipLevels = mipLevels;
+            entry.arrayLayers = arrayLayers;
+            entry.aspect = aspect;
+            entry.subresources.assign(mipLevels * arrayLayers, TrackedState{});
+            for(auto& subresource : entry.subresources) subresource.layout = layout;
+        }
+
+        /**
+         * @brief start tracking an image that earlier work still uses, eg. a swapchain image
+         *        whose acquire semaphore is waited for in current.stages
+         *
+         * @param image
+         * @param mipLevels
+         * @param arrayLayers
+         * @param aspect
+         * @param current last use of all subresources
+         */
+        inline void RegisterImage(const VkImage& image, const uint32& mipLevels, const uint32& arrayLayers, const VkImageAspectFlags& aspect, const ResourceState& current){
+            RegisterImage(image, mipLevels, arrayLayers, aspect, current.layout);
+            const bool writes = (current.access & Access::writeMask) != 0;
+            for(auto& subresource : images[image].subresources){
+                subresource.writeStages = writes ? current.stages : VK_PIPELINE_STAGE_2_NONE_KHR;
+                subresource.writeAccess = current.access & Access::writeMask;
+                subresource.readStages  = writes ? VK_PIPELINE_STAGE_2_NONE_KHR : current.stages;
+            }
+        }
+
+        /// stop tracking an image, eg. before destroying it
+        inline void ForgetImage(const VkImage& image){
+            images.erase(image);
+        }
+
+        /// stop tracking a buffer, eg. before destroying it
+        inline void ForgetBuffer(const VkBuffer& buffer){
+            buffers.erase(buffer);
+        }
+
+        /**
+         * @brief declare next use of image subresources, barrier is recorded by Flush
+         *
+         * @param image registered with RegisterImage
+         * @param next how image will be used
+         * @param baseMip
+         * @param mipCount or VK_REMAINING_MIP_LEVELS
+         * @param baseLayer
+         * @param layerCount or VK_REMAINING_ARRAY_LAYERS
+         * @param discard previous contents aren't needed, transition from VK_IMAGE_LAYOUT_UNDEFINED
+         */
+        inline void UseImage(const VkImage& image, const ResourceState& next, const uint32& baseMip = 0, const uint32& mipCount = VK_REMAINING_MIP_LEVELS,
+                             const uint32& baseLayer = 0, const uint32& layerCount = VK_REMAINING_ARRAY_LAYERS, const bool& discard = false){
+            auto it = images.find(image);
+            ASSERT(it != images.end(), "[BarrierTracker] : Image must be registered before use");
+            ImageEntry& entry = it->second;
+
+            const uint32 mipEnd = mipCount == VK_REMAINING_MIP_LEVELS ? entry.mipLevels : baseMip + mipCount;
+            const uint32 layerEnd = layerCount == VK_REMAINING_ARRAY_LAYERS ? entry.arrayLayers : baseLayer + layerCount;
+            ASSERT(mipEnd <= entry.mipLevels && layerEnd <= entry.arrayLayers, "[BarrierTracker] : Subresource range out of bounds");
+
+            // same subresource twice in one batch would give two unordered transitions
+            for(const auto& barrier : batches[batchCount - 1].imageBarriers){
+                const VkImageSubresourceRange& range = barrier.subresourceRange;
+                if(barrier.image == image && range.baseMipLevel < mipEnd && baseMip < range.baseMipLevel + range.levelCount &&
+                   range.baseArrayLayer < layerEnd && baseLayer < range.baseArrayLayer + range.layerCount){
+                    NextBatch();
+                    break;
+                }
+            }
+
+            std::vector<VkImageMemoryBarrier2KHR>& barriers = batches[batchCount - 1].imageBarriers;
+            const size_t firstBarrier = barriers.size();
+            for(uint32 mip = baseMip; mip < mipEnd; mip++){
+                for(uint32 layer = baseLayer; layer < layerEnd; layer++){
+                    TrackedState& state = entry.subresources[mip * entry.arrayLayers + layer];
+                    if(discard) state.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+                    Dependency dependency;
+                    if(!Transition(state, next, true, dependency)) continue;
+
+                    // extend previous barrier when it's the neighbouring layer with same masks
+                    if(barriers.size() > firstBarrier){
+                        VkImageMemoryBarrier2KHR& last = barriers.back();
+                        const VkImageSubresourceRange& range = last.subresourceRange;
+                        if(range.baseMipLevel == mip && range.baseArrayLayer + range.layerCount == layer && Matches(last, dependency)){
+                            last.subresourceRange.layerCount++;
+                            continue;
+                        }
+                    }
+                    barriers.push_back(MakeImageBarrier(image, entry.aspect, mip, layer, dependency));
+                }
+            }
+
+            // merge barriers of consecutive mips covering the same layers
+            size_t merged = firstBarrier;
+            for(size_t i = firstBarrier; i < barriers.size(); i++){
+                const VkImageMemoryBarrier2KHR& barrier = barriers[i];
+                if(merged > firstBarrier){
+                    VkImageMemoryBarrier2KHR& last = barriers[merged - 1];
+                    VkImageSubresourceRange& range = last.subresourceRange;
+                    if(range.baseMipLevel + range.levelCount == barrier.subresourceRange.baseMipLevel && range.baseArrayLayer == barrier.subresourceRange.baseArrayLayer &&
+                       range.layerCount == barrier.subresourceRange.layerCount && SameMasks(last, barrier)){
+                        range.levelCount++;
+                        continue;
+                    }
+                }
+                barriers[merged++] = barrier;
+            }
+            barriers.resize(merged);
+        }
+
+        /**
+         * @brief declare next use of a buffer range, barrier is recorded by Flush
+         *
+         * @param buffer tracked automatically on first use
+         * @param next how buffer will be used
+         * @param offset
+         * @param size or VK_WHOLE_SIZE
+         */
+        inline void UseBuffer(const VkBuffer& buffer, const ResourceState& next, const VkDeviceSize& offset = 0, const VkDeviceSize& size = VK_WHOLE_SIZE){
+            auto& ranges = buffers[buffer];
+            if(ranges.empty()) ranges[0] = BufferRange{};
+
+            const VkDeviceSize end = size == VK_WHOLE_SIZE ? VK_WHOLE_SIZE : offset + size;
+            Split(ranges, offset);
+            if(end != VK_WHOLE_SIZE) Split(ranges, end);
+
+            // masks of a range used twice in one batch would be merged into one unordered dependency
+            for(const auto& range : batches[batchCount - 1].bufferRanges){
+                if(range.buffer == buffer && range.begin < end && offset < range.end){
+                    NextBatch();
+                    break;
+                }
+            }
+
+            Batch& batch = batches[batchCount - 1];
+            for(auto it = ranges.find(offset); it != ranges.end() && it->first < end; it++){
+                Dependency dependency;
+                if(!Transition(it->second.state, next, false, dependency)) continue;
+                batch.memoryBarrier.srcStageMask  |= dependency.srcStages;
+                batch.memoryBarrier.srcAccessMask |= dependency.srcAccess;
+                batch.memoryBarrier.dstStageMask  |= dependency.dstStages;
+                batch.memoryBarrier.dstAccessMask |= dependency.dstAccess;
+                batch.bufferRanges.push_back(PendingRange{buffer, it->first, it->second.end});
+            }
+
+            // join neighbouring ranges that ended up in the same state
+            auto it = ranges.find(offset);
+            if(it != ranges.begin()) it = std::prev(it);
+            while(it != ranges.end()){
+                auto following = std::next(it);
+                if(following == ranges.end() || it->first > end) break;
+                if(following->second.state == it->second.state){
+                    it->second.end = following->second.end;
+                    ranges.erase(following);
+                }
+                else it = following;
+            }
+        }
+
+        /// whether Flush would record anything
+        [[nodiscard]] inline bool HasPendingBarriers() const{
+            for(size_t i = 0; i < batchCount; i++){
+                if(!batches[i].Empty()) return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief record queued barriers, one vkCmdPipelineBarrier2 per batch (usually one),
+         *        call before the commands that use the resources
+         *
+         * @param cmdBuffer
+         */
+        inline void Flush(const VkCommandBuffer& cmdBuffer){
+            for(size_t i = 0; i < batchCount; i++){
+                Batch& batch = batches[i];
+                if(batch.Empty()) continue;
+
+                batch.memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+                VkDependencyInfoKHR dependencyInfo = {};
+                dependencyInfo.sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+                dependencyInfo.memoryBarrierCount       = batch.bufferRanges.empty() ? 0 : 1;
+                dependencyInfo.pMemoryBarriers          = &batch.memoryBarrier;
+                dependencyInfo.imageMemoryBarrierCount  = static_cast<uint32>(batch.imageBarriers.size());
+                dependencyInfo.pImageMemoryBarriers     = batch.imageBarriers.data();
+                CmdPipelineBarrier2(cmdBuffer, dependencyInfo);
+                batch.Clear();
+            }
+            batchCount = 1;
+        }
+
+        /**
+         * @brief drop all tracking and queued barriers
+         *
+         */
+        inline void Reset(){
+            images.clear();
+            buffers.clear();
+            for(auto& batch : batches) batch.Clear();
+            batchCount = 1;
+        }
+
+    private:
+        /// start a new batch, barriers queued after this are recorded after the current ones
+        inline void NextBatch(){
+            if(batchCount == batches.size()) batches.emplace_back();
+            batchCount++;
+        }
+
+        /// split range containing offset so a range starts at offset
+        static inline void Split(std::map<VkDeviceSize, BufferRange>& ranges, const VkDeviceSize& offset){
+            auto it = std::prev(ranges.upper_bound(offset));
+            if(it->first == offset || it->second.end <= offset) return;
+            ranges[offset] = BufferRange{it->second.end, it->second.state};
+            it->second.end = offset;
+        }
+
+        [[nodiscard]] static inline VkImageMemoryBarrier2KHR MakeImageBarrier(const VkImage& image, const VkImageAspectFlags& aspect, const uint32& mip, const uint32& layer, const Dependency& dependency){
+            VkImageMemoryBarrier2KHR barrier = {};
+            barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+            barrier.srcStageMask        = dependency.srcStages;
+            barrier.srcAccessMask       = dependency.srcAccess;
+            barrier.dstStageMask        = dependency.dstStages;
+            barrier.dstAccessMask       = dependency.dstAccess;
+            barrier.oldLayout           = dependency.oldLayout;
+            barrier.newLayout           = dependency.newLayout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image               = image;
+            barrier.subresourceRange    = {aspect, mip, 1, layer, 1};
+            return barrier;
+        }
+
+        [[nodiscard]] static inline bool Matches(const VkImageMemoryBarrier2KHR& barrier, const Dependency& dependency){
+            return barrier.srcStageMask == dependency.srcStages && barrier.srcAccessMask == dependency.srcAccess && barrier.dstStageMask == dependency.dstStages &&
+                   barrier.dstAccessMask == dependency.dstAccess && barrier.oldLayout == dependency.oldLayout && barrier.newLayout == dependency.newLayout;
+        }
+
+        [[nodiscard]] static inline bool SameMasks(const VkImageMemoryBarrier2KHR& a, const VkImageMemoryBarrier2KHR& b){
+            return a.srcStageMask == b.srcStageMask && a.srcAccessMask == b.srcAccessMask && a.dstStageMask == b.dstStageMask &&
+                   a.dstAccessMask == b.dstAccessMask && a.oldLayout == b.oldLayout && a.newLayout == b.newLayout;
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_BARRIER_HPP
@@ -29,7 +29,11 @@
 
 #include "VulkanInitializers.hpp"
 #include "VulkanTools.hpp"
+#include "VulkanCommandPool.hpp"
+#include "VulkanDeletionQueue.hpp"
+#include "VulkanResult.hpp"
 #include <Vulkan.hpp>
+#include <map>
 #include <vulkan/vulkan_core.h>
 
 namespace Vulkan{
@@ -43,6 +47,21 @@ namespace Vulkan{
         *      
         */
         struct VulkanBase{
+            /**
+             * @brief per frame synchronization objects and command buffer
+             *
+             */
+            struct Frame{
+                /// signaled when GPU is done with this frame
+                VkFence inFlightFence = VK_NULL_HANDLE;
+
+                /// signaled when swapchain image is ready to be rendered to
+                VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;
+
+                /// primary command buffer of this frame, allocated from thread 0 pool
+                VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            };
+
             /**
             * @brief Construct a new Vulkan Base object.
             * 
@@ -50,6 +69,8 @@ namespace Vulkan{
             VulkanBase() {
                 availableInstanceExtensions = Vulkan::EnumerateInstanceExtensionNames();
                 availableInstanceLayers = Vulkan::EnumerateInstanceLayerNames();
+                deviceFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+                synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
             };
 
             /// list of all available instance extensions
@@ -73,8 +94,10 @@ namespace Vulkan{
             /// created vulkan instance handle
             VkInstance instance = VK_NULL_HANDLE;
 
+#ifndef SETTING_DONT_USE_SDL
             /// given sdl window handle, if set to nullptr then surface won't be created
             SDL_Window* window = nullptr;
+#endif//SETTING_DONT_USE_SDL
 
             /// created vulkan surface handle i.e created for given sdl window
             VkSurfaceKHR surface = VK_NULL_HANDLE;
@@ -88,12 +111,33 @@ namespace Vulkan{
             /// extensions for device creation
             Names deviceExtensions;
 
+            /// Vulkan 1.2 features to enable, chained in device creation when physical device supports Vulkan 1.2
+            VkPhysicalDeviceVulkan12Features deviceFeatures12 = {};
+
+            /// VK_KHR_synchronization2 feature, chained in device creation when enabled
+            VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features = {};
+
             /// graphics family index
             std::optional<uint32> graphicsIdx;
 
             /// presentation family index, it has value only when a surface is created
             std::optional<uint32> presentIdx; 
 
+            /// transfer family index, a transfer only family if device has one
+            std::optional<uint32> transferIdx;
+
+            /// compute family index, a compute family without graphics if device has one
+            std::optional<uint32> computeIdx;
+
+            /// priority of graphics queue
+            float graphicsQueuePriority = 1.f;
+
+            /// priority of compute queue
+            float computeQueuePriority = 1.f;
+
+            /// priority of transfer queue
+            float transferQueuePriority = 0.5f;
+
             /// created logical device handle
             VkDevice device = VK_NULL_HANDLE;
 
@@ -103,12 +147,21 @@ namespace Vulkan{
             /// device presentation queue handle (queue that supports surface presentation)
             VkQueue presentQueue;
 
+            /// device transfer queue handle, may be same as graphicsQueue if device has no other queue
+            VkQueue transferQueue = VK_NULL_HANDLE;
+
+            /// device compute queue handle, may be same as graphicsQueue if device has no other queue
+            VkQueue computeQueue = VK_NULL_HANDLE;
+
             /// created swapchain handle
             VkSwapchainKHR swapchain = VK_NULL_HANDLE;
 
             /// swapchain image extent
             VkExtent2D imageExtent;
 
+            /// graphics and present family indices swapchain create info points to
+            uint32 swapchainQueueFamilyIndices[2] = {};
+
             /// swapchain image format
             VkFormat imageFormat;
 
@@ -121,6 +174,45 @@ namespace Vulkan{
             /// created image views for swapchain images
             std::vector<VkImageView> imageViews;
 
+            /// memory of offscreen images, used in place of swapchain images when running headless
+            std::vector<VkDeviceMemory> offscreenMemory;
+
+            /// number of frames CPU can record ahead of GPU, set before CreateFrames
+            uint32 framesInFlight = 2;
+
+            /// number of threads that record commands, set before CreateFrames
+            uint32 recordingThreadCount = 1;
+
+            /// per frame synchronization objects
+            std::vector<Frame> frames;
+
+            /// one command pool per (recording thread, frame in flight)
+            CommandPoolManager commandPools;
+
+            /// signaled when rendering to a swapchain image is done, one per swapchain image
+            std::vector<VkSemaphore> renderFinishedSemaphores;
+
+            /// fence of the frame that last used each swapchain image
+            std::vector<VkFence> imagesInFlight;
+
+            /// index of current frame in frames
+            uint32 frameIdx = 0;
+
+            /// number of frames that were ended
+            uint64 frameNumber = 0;
+
+            /// index of swapchain image acquired in BeginFrame
+            uint32 imageIdx = 0;
+
+            /// objects destroyed once frames that used them are done, values are frame numbers
+            DeletionQueue deletionQueue;
+
+            /// set when acquire or present reports that swapchain doesn't match surface anymore
+            bool swapchainOutOfDate = false;
+
+            /// true for one frame after BeginFrame recreated swapchain, rebuild framebuffers when set
+            bool swapchainRecreated = false;
+
             /**
              * @brief Enable an instance extension.
              *        If extension is already enabled in nothing will happen (true will be returned)
@@ -179,10 +271,13 @@ namespace Vulkan{
                 instance = Vulkan::CreateInstance(instanceCreateInfo);
             }
 
+#ifndef SETTING_DONT_USE_SDL
             /// create vulkan surface, if window is nullptr in constructor then surface will be VK_NULL_HANDLE
             inline void CreateSurface(SDL_Window* window){
+                this->window = window;
                 surface = Vulkan::CreateSurface(instance, window);
             }
+#endif//SETTING_DONT_USE_SDL
 
             /// select vulkan capable physical device
             inline void SelectPhysicalDevice(){
@@ -210,14 +305,89 @@ namespace Vulkan{
                 return false;
             }
 
+            /**
+             * @brief Enable timeline semaphores (Vulkan 1.2 core) for device creation.
+             *
+             * @warning a physical device must be selected before using this function
+             *
+             * @return true if physical device supports timeline semaphores
+             * @return false otherwise
+             */
+            inline bool EnableTimelineSemaphores(){
+                if(Vulkan::GetPhysicalDeviceProperties(physicalDevice).apiVersion < VK_API_VERSION_1_2) return false;
+
+                VkPhysicalDeviceVulkan12Features supported = {};
+                supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+                (void)Vulkan::GetPhysicalDeviceFeatures2(physicalDevice, &supported);
+                deviceFeatures12.timelineSemaphore = supported.timelineSemaphore;
+                return supported.timelineSemaphore == VK_TRUE;
+            }
+
+            /**
+             * @brief Enable descriptor indexing features (Vulkan 1.2 core) needed by Vulkan::BindlessTable.
+             *
+             * @warning a physical device must be selected before using this function
+             *
+             * @return true if physical device supports all of them
+             * @return false otherwise
+             */
+            inline bool EnableDescriptorIndexing(){
+                if(Vulkan::GetPhysicalDeviceProperties(physicalDevice).apiVersion < VK_API_VERSION_1_2) return false;
+
+                VkPhysicalDeviceVulkan12Features supported = {};
+                supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+                (void)Vulkan::GetPhysicalDeviceFeatures2(physicalDevice, &supported);
+                if(!supported.descriptorIndexing || !supported.runtimeDescriptorArray || !supported.descriptorBindingPartiallyBound ||
+                   !supported.descriptorBindingUpdateUnusedWhilePending || !supported.descriptorBindingSampledImageUpdateAfterBind ||
+                   !supported.descriptorBindingStorageBufferUpdateAfterBind || !supported.shaderSampledImageArrayNonUniformIndexing) return false;
+
+                deviceFeatures12.descriptorIndexing                             = VK_TRUE;
+                deviceFeatures12.runtimeDescriptorArray                         = VK_TRUE;
+                deviceFeatures12.descriptorBindingPartiallyBound                = VK_TRUE;
+                deviceFeatures12.descriptorBindingUpdateUnusedWhilePending      = VK_TRUE;
+                deviceFeatures12.descriptorBindingSampledImageUpdateAfterBind   = VK_TRUE;
+                deviceFeatures12.descriptorBindingStorageBufferUpdateAfterBind  = VK_TRUE;
+                deviceFeatures12.shaderSampledImageArrayNonUniformIndexing      = VK_TRUE;
+                deviceFeatures12.shaderStorageBufferArrayNonUniformIndexing     = supported.shaderStorageBufferArrayNonUniformIndexing;
+                return true;
+            }
+
+            /**
+             * @brief Enable VK_KHR_synchronization2 for device creation, its commands are loaded in CreateDevice.
+             *        Without it Vulkan::CmdPipelineBarrier2 falls back to vkCmdPipelineBarrier.
+             *
+             * @warning a physical device must be selected before using this function
+             *
+             * @return true if physical device supports synchronization2
+             * @return false otherwise
+             */
+            inline bool EnableSynchronization2(){
+                if(!EnableDeviceExtension(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME)) return false;
+
+                VkPhysicalDeviceSynchronization2FeaturesKHR supported = {};
+                supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+                (void)Vulkan::GetPhysicalDeviceFeatures2(physicalDevice, &supported);
+                synchronization2Features.synchronization2 = supported.synchronization2;
+                return supported.synchronization2 == VK_TRUE;
+            }
 
-            /// create a logical device
+            /**
+             * @brief Create a logical device.
+             *        Besides graphics (and present) queue, a transfer queue and a compute queue
+             *        are created, preferring dedicated families so uploads and compute can
+             *        overlap graphics work. If a family is shared, a separate queue of that family
+             *        is used when available, otherwise queues are shared (and so is their synchronization).
+             *
+             */
             inline void CreateDevice(){
-                // queue create infos
-            std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-                // get graphics family indices
-                graphicsIdx = Vulkan::GetPhysicalDeviceQueueFamilyIndex(physicalDevice, VK_QUEUE_GRAPHICS_BIT);
+                // get queue families
+                std::vector<VkQueueFamilyProperties> queueFamilies = Vulkan::GetPhysicalDeviceQueueFamilyProperties(physicalDevice);
+
+                // get graphics, transfer and compute family indices
+                graphicsIdx  = Vulkan::GetPhysicalDeviceQueueFamilyIndex(queueFamilies, VK_QUEUE_GRAPHICS_BIT);
                 ASSERT(graphicsIdx.has_value(), "NO GRAPHICS QUEUE FAMILY PRESENT ON SELECTED DEVICE");
+                transferIdx  = Vulkan::Tools::FindQueueFamilyIndex(queueFamilies, VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+                computeIdx   = Vulkan::Tools::FindQueueFamilyIndex(queueFamilies, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
                 
                 // get presentation family index
                 if(surface != VK_NULL_HANDLE){
@@ -225,24 +395,57 @@ namespace Vulkan{
                     ASSERT(presentIdx.has_value(), "SELECTED DEVICE DOESN'T SUPPORT SURFACE PRESENTATION");
                 }
 
-                // unique queue indices
-                std::set<uint32> uniqueQueueIndices = {graphicsIdx.value(), presentIdx.value()};
+                // queue priorities of each family, one entry per queue created from family
+                std::map<uint32, std::vector<float>> queuePriorities;
 
-                // queue priorities : since we are creating only one queue, only one value in vector
-                std::vector<float> queuePriorities = {float{1.f}};
-                
-                // add unique queues to queue create infos vector
-                for(const auto& queueIdx : uniqueQueueIndices)
-                    queueCreateInfos.push_back(Vulkan::Init::DeviceQueueCreateInfo(queueIdx, queuePriorities));
+                // request a new queue from a family, or share its last queue if family is exhausted
+                auto requestQueue = [&](const uint32& familyIdx, const float& priority) -> uint32 {
+                    std::vector<float>& priorities = queuePriorities[familyIdx];
+                    if(priorities.size() < queueFamilies[familyIdx].queueCount){
+                        priorities.push_back(priority);
+                    }
+                    return static_cast<uint32>(priorities.size() - 1);
+                };
+
+                uint32 graphicsQueueIdx = requestQueue(graphicsIdx.value(), graphicsQueuePriority);
+                uint32 computeQueueIdx  = computeIdx.has_value() ? requestQueue(computeIdx.value(), computeQueuePriority) : 0;
+                uint32 transferQueueIdx = requestQueue(transferIdx.value(), transferQueuePriority);
+                if(presentIdx.has_value() && queuePriorities.count(presentIdx.value()) == 0){
+                    requestQueue(presentIdx.value(), graphicsQueuePriority);
+                }
+
+                // queue create infos
+                std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+                for(const auto& [familyIdx, priorities] : queuePriorities)
+                    queueCreateInfos.push_back(Vulkan::Init::DeviceQueueCreateInfo(familyIdx, priorities));
                 
                 // device create info
                 VkDeviceCreateInfo deviceCreateInfo = Vulkan::Init::DeviceCreateInfo(deviceExtensions, queueCreateInfos);
 
+                // chain feature structs
+                void* enabledFeatures = nullptr;
+                if(Vulkan::GetPhysicalDeviceProperties(physicalDevice).apiVersion >= VK_API_VERSION_1_2){
+                    deviceFeatures12.pNext = enabledFeatures;
+                    enabledFeatures = &deviceFeatures12;
+                }
+                if(synchronization2Features.synchronization2 == VK_TRUE){
+                    synchronization2Features.pNext = enabledFeatures;
+                    enabledFeatures = &synchronization2Features;
+                }
+                deviceCreateInfo.pNext = enabledFeatures;
+
                 // create device
                 device = Vulkan::CreateDevice(physicalDevice, deviceCreateInfo);
 
-                // get created device queue
-                graphicsQueue = Vulkan::GetDeviceQueue(device, graphicsIdx.value(), 0);
+                // load extension commands
+                if(synchronization2Features.synchronization2 == VK_TRUE) (void)Vulkan::LoadSynchronization2(device);
+
+                // get created device queues
+                graphicsQueue = Vulkan::GetDeviceQueue(device, graphicsIdx.value(), graphicsQueueIdx);
+                transferQueue = Vulkan::GetDeviceQueue(device, transferIdx.value(), transferQueueIdx);
+                if(computeIdx.has_value()){
+                    computeQueue = Vulkan::GetDeviceQueue(device, computeIdx.value(), computeQueueIdx);
+                }
                 if(surface!=VK_NULL_HANDLE){
                     if(presentIdx != graphicsIdx){
                         presentQueue = Vulkan::GetDeviceQueue(device, presentIdx.value(), 0);
@@ -258,7 +461,30 @@ namespace Vulkan{
              *
              */
             inline void CreateSwapchain(){
-                VkSwapchainCreateInfoKHR swapchainCreateInfo = Vulkan::Init::SwapchainCreateInfo(physicalDevice, surface, window);
+                CreateSwapchain(GetSwapchainCreateInfo(VK_NULL_HANDLE));
+            }
+
+            /**
+             * @brief create info for a swapchain matching current surface size
+             *
+             * @param oldSwapchain swapchain being replaced
+             * @return VkSwapchainCreateInfoKHR
+             */
+            [[nodiscard]] inline VkSwapchainCreateInfoKHR GetSwapchainCreateInfo(const VkSwapchainKHR& oldSwapchain){
+#ifndef SETTING_DONT_USE_SDL
+                return Vulkan::Init::SwapchainCreateInfo(physicalDevice, surface, window, swapchainQueueFamilyIndices, oldSwapchain);
+#else
+                // without SDL imageExtent must be set to size of window before creation
+                return Vulkan::Init::SwapchainCreateInfo(physicalDevice, surface, imageExtent, swapchainQueueFamilyIndices, oldSwapchain);
+#endif//SETTING_DONT_USE_SDL
+            }
+
+            /**
+             * @brief create swapchain from create info and get its images
+             *
+             * @param swapchainCreateInfo
+             */
+            inline void CreateSwapchain(const VkSwapchainCreateInfoKHR& swapchainCreateInfo){
                 imageExtent = swapchainCreateInfo.imageExtent;
                 imageFormat = swapchainCreateInfo.imageFormat;
                 swapchain = Vulkan::CreateSwapchain(device, swapchainCreateInfo);
@@ -268,6 +494,44 @@ namespace Vulkan{
                 numberOfImagesInSwapchain = images.size();
             }
 
+            /**
+             * @brief Recreate swapchain after a resize without waiting for the device.
+             *        Old swapchain is passed as oldSwapchain, so presentation continues
+             *        while new one is created. Old swapchain, views and semaphores go to deletionQueue
+             *        and are destroyed once the frames that used them are done. Only extent dependent
+             *        objects are rebuilt, frames and command pools are kept.
+             *        Framebuffers and other objects that use imageViews must be recreated by caller,
+             *        old ones can be passed to deletionQueue.
+             *
+             * @return true if swapchain was recreated
+             * @return false if surface has zero size (minimized window), try again later
+             */
+            inline bool RecreateSwapchain(){
+                VkSwapchainCreateInfoKHR swapchainCreateInfo = GetSwapchainCreateInfo(swapchain);
+                if(swapchainCreateInfo.imageExtent.width == 0 || swapchainCreateInfo.imageExtent.height == 0){
+                    return false;
+                }
+
+                // frames before this one may still use old objects
+                for(const auto& imageView : imageViews){
+                    deletionQueue.DestroyImageView(imageView);
+                }
+                for(const auto& semaphore : renderFinishedSemaphores){
+                    deletionQueue.DestroySemaphore(semaphore);
+                }
+                deletionQueue.DestroySwapchain(swapchain);
+
+                CreateSwapchain(swapchainCreateInfo);
+                CreateImageViews();
+                CreateImageSyncObjects();
+
+                swapchainOutOfDate = false;
+                swapchainRecreated = true;
+
+                LOG(info, "[VulkanBase] : Swapchain recreated with extent %ux%u", imageExtent.width, imageExtent.height);
+                return true;
+            }
+
             /// create image views for swapchain images
             inline void CreateImageViews(){
                 // resize image views vector
@@ -279,6 +543,226 @@ namespace Vulkan{
                 }
             }
 
+            /**
+             * @brief Create a ring of offscreen color images that stand in for swapchain images
+             *        when running without a surface. Images are stored in images and imageViews
+             *        just like swapchain images, so rest of the application doesn't have to care.
+             *
+             * @param extent size of images
+             * @param format of images
+             * @param imageCount number of images in ring
+             */
+            inline void CreateOffscreenImages(const VkExtent2D& extent, const VkFormat& format = VK_FORMAT_R8G8B8A8_UNORM, const uint32& imageCount = 3){
+                imageExtent = extent;
+                imageFormat = format;
+                numberOfImagesInSwapchain = imageCount;
+
+                // images can be rendered to and read back
+                VkPhysicalDeviceMemoryProperties memoryProperties = Vulkan::GetPhysicalDeviceMemoryProperties(physicalDevice);
+                VkImageCreateInfo imageCreateInfo = Vulkan::Init::ImageCreateInfo(format,
+                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VkExtent3D{extent.width, extent.height, 1});
+
+                images.resize(imageCount);
+                offscreenMemory.resize(imageCount);
+                for(uint32 i = 0; i < imageCount; i++){
+                    images[i] = Vulkan::CreateImage(device, imageCreateInfo);
+
+                    VkMemoryRequirements requirements = Vulkan::GetImageMemoryRequirements(device, images[i]);
+                    std::optional<uint32> memoryTypeIdx = Vulkan::Tools::FindMemoryTypeIndex(memoryProperties, requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                    if(!memoryTypeIdx.has_value()){
+                        // software implementations may not have device local memory
+                        memoryTypeIdx = Vulkan::Tools::FindMemoryTypeIndex(memoryProperties, requirements.memoryTypeBits, 0);
+                    }
+                    ASSERT(memoryTypeIdx.has_value(), "NO MEMORY TYPE FOR OFFSCREEN IMAGES");
+
+                    offscreenMemory[i] = Vulkan::AllocateMemory(device, Vulkan::Init::MemoryAllocateInfo(requirements.size, memoryTypeIdx.value()));
+                    Vulkan::BindImageMemory(device, images[i], offscreenMemory[i], 0);
+                }
+            }
+
+            /// destroy offscreen images and their memory, views are destroyed with image views
+            inline void DestroyOffscreenImages(){
+                for(uint32 i = 0; i < offscreenMemory.size(); i++){
+                    Vulkan::DestroyImage(device, images[i]);
+                    Vulkan::FreeMemory(device, offscreenMemory[i]);
+                }
+                offscreenMemory.clear();
+                images.clear();
+            }
+
+            /**
+             * @brief Create framesInFlight frames worth of fences, semaphores and command pools.
+             *        Graphics queue must be created before calling this.
+             *
+             */
+            inline void CreateFrames(){
+                // fences start signaled so first BeginFrame doesn't wait forever
+                frames.resize(framesInFlight);
+                for(auto& frame : frames){
+                    frame.inFlightFence = Vulkan::CreateFence(device, Vulkan::Init::FenceCreateInfo(VK_FENCE_CREATE_SIGNALED_BIT));
+                    frame.imageAvailableSemaphore = Vulkan::CreateSemaphore(device, Vulkan::Init::SemaphoreCreateInfo());
+                }
+
+                CreateImageSyncObjects();
+
+                commandPools.Init(device, graphicsIdx.value(), recordingThreadCount, framesInFlight);
+                deletionQueue.Init(device);
+                frameIdx = 0;
+                frameNumber = 0;
+            }
+
+            /// create per image semaphores and fence slots
+            inline void CreateImageSyncObjects(){
+                // render finished semaphores are per image, a semaphore can only be
+                // reused once the present that waits on it is done with the image
+                renderFinishedSemaphores.resize(images.size());
+                for(auto& semaphore : renderFinishedSemaphores){
+                    semaphore = Vulkan::CreateSemaphore(device, Vulkan::Init::SemaphoreCreateInfo());
+                }
+                imagesInFlight.assign(images.size(), VK_NULL_HANDLE);
+            }
+
+            /**
+             * @brief acquire next swapchain image in imageIdx, recreating swapchain when it is out of date
+             *
+             * @param frame current frame
+             * @return true if image was acquired
+             * @return false if window is minimized
+             */
+            inline bool AcquireSwapchainImage(Frame& frame){
+                for(;;){
+                    if(swapchainOutOfDate && !RecreateSwapchain()) return false;
+
+                    Vulkan::Result<uint32> acquired = Vulkan::Try::AcquireNextImage(device, swapchain, UINT64_MAX, frame.imageAvailableSemaphore, VK_NULL_HANDLE);
+                    if(acquired.error() == VK_ERROR_OUT_OF_DATE_KHR){
+                        swapchainOutOfDate = true;
+                        continue;
+                    }
+                    ASSERT(acquired, "Failed to acquire next image index -> returned : %s", ResultString(acquired.error()));
+
+                    // suboptimal image is still acquired and semaphore signaled, recreate next frame
+                    if(acquired.error() == VK_SUBOPTIMAL_KHR) swapchainOutOfDate = true;
+
+                    imageIdx = acquired.value();
+                    return true;
+                }
+            }
+
+            /// get frame being recorded
+            [[nodiscard]] inline Frame& GetCurrentFrame(){
+                return frames[frameIdx];
+            }
+
+            /**
+             * @brief Begin a new frame.
+             *        Waits only for the GPU to finish the frame that used this slot
+             *        framesInFlight frames ago, so recording overlaps with GPU work
+             *        of previous frames. Resets command pools of this frame and acquires
+             *        next swapchain image (if swapchain was created).
+             *
+             *        If swapchain is out of date it is recreated first and swapchainRecreated is set.
+             *
+             * @return VkCommandBuffer : primary command buffer of this frame in recording state,
+             *         VK_NULL_HANDLE if window is minimized; skip the frame and don't call EndFrame
+             */
+            [[nodiscard]] inline VkCommandBuffer BeginFrame(){
+                Frame& frame = frames[frameIdx];
+                swapchainRecreated = false;
+
+                // wait for GPU to finish with this slot, every frame up to
+                // frameNumber - framesInFlight is done now
+                Vulkan::WaitForFence(device, frame.inFlightFence, UINT64_MAX);
+                if(frameNumber >= framesInFlight) deletionQueue.Flush(frameNumber - framesInFlight);
+                deletionQueue.pendingValue = frameNumber;
+
+                // acquire image and wait if an older frame still renders to it
+                if(swapchain != VK_NULL_HANDLE){
+                    if(!AcquireSwapchainImage(frame)) return VK_NULL_HANDLE;
+                }else{
+                    // offscreen images are used round robin
+                    imageIdx = static_cast<uint32>(frameNumber % images.size());
+                }
+                if(imagesInFlight[imageIdx] != VK_NULL_HANDLE && imagesInFlight[imageIdx] != frame.inFlightFence){
+                    Vulkan::WaitForFence(device, imagesInFlight[imageIdx], UINT64_MAX);
+                }
+                imagesInFlight[imageIdx] = frame.inFlightFence;
+
+                Vulkan::ResetFence(device, frame.inFlightFence);
+
+                // reset all command buffers of this frame at once
+                commandPools.BeginFrame(frameIdx);
+                frame.commandBuffer = commandPools.AllocatePrimary(0);
+                Vulkan::BeginCommandBuffer(frame.commandBuffer, Vulkan::Init::CommandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
+
+                // return
+                return frame.commandBuffer;
+            }
+
+            /**
+             * @brief End current frame. Submits its command buffer to graphics queue,
+             *        presents acquired image (if swapchain was created) and moves to next frame.
+             *        Doesn't wait for the GPU.
+             *
+             */
+            inline void EndFrame(){
+                Frame& frame = frames[frameIdx];
+                Vulkan::EndCommandBuffer(frame.commandBuffer);
+
+                // submit, waiting for image only at color output
+                VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                VkSubmitInfo submitInfo = {};
+                submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+                submitInfo.commandBufferCount   = 1;
+                submitInfo.pCommandBuffers      = &frame.commandBuffer;
+                if(swapchain != VK_NULL_HANDLE){
+                    submitInfo.waitSemaphoreCount   = 1;
+                    submitInfo.pWaitSemaphores      = &frame.imageAvailableSemaphore;
+                    submitInfo.pWaitDstStageMask    = &waitStage;
+                    submitInfo.signalSemaphoreCount = 1;
+                    submitInfo.pSignalSemaphores    = &renderFinishedSemaphores[imageIdx];
+                }
+                Vulkan::QueueSumbit(graphicsQueue, submitInfo, frame.inFlightFence);
+
+                // present
+                if(swapchain != VK_NULL_HANDLE){
+                    VkPresentInfoKHR presentInfo = {};
+                    presentInfo.sType               = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+                    presentInfo.waitSemaphoreCount  = 1;
+                    presentInfo.pWaitSemaphores     = &renderFinishedSemaphores[imageIdx];
+                    presentInfo.swapchainCount      = 1;
+                    presentInfo.pSwapchains         = &swapchain;
+                    presentInfo.pImageIndices       = &imageIdx;
+
+                    // recreate on next BeginFrame, resizes don't stop the process
+                    Vulkan::Result<void> presented = Vulkan::Try::QueuePresent(presentQueue, presentInfo);
+                    if(presented.error() == VK_ERROR_OUT_OF_DATE_KHR || presented.error() == VK_SUBOPTIMAL_KHR){
+                        swapchainOutOfDate = true;
+                    }else{
+                        ASSERT(presented, "Queue present failed -> returned : %s", ResultString(presented.error()));
+                    }
+                }
+
+                frameIdx = (frameIdx + 1) % framesInFlight;
+                frameNumber++;
+            }
+
+            /// destroy frame synchronization objects and command pools, device must be idle
+            inline void DestroyFrames(){
+                commandPools.Destroy();
+
+                for(const auto& frame : frames){
+                    Vulkan::DestroyFence(device, frame.inFlightFence);
+                    Vulkan::DestroySemaphore(device, frame.imageAvailableSemaphore);
+                }
+                frames.clear();
+
+                for(const auto& semaphore : renderFinishedSemaphores){
+                    Vulkan::DestroySemaphore(device, semaphore);
+                }
+                renderFinishedSemaphores.clear();
+                imagesInFlight.clear();
+            }
+
             /**
              * @brief One call initialize everyting.
              *        Surface extensions are enabled and Swapchain device extenion is enabled
@@ -286,6 +770,7 @@ namespace Vulkan{
              * 
              * @param window 
              */
+#ifndef SETTING_DONT_USE_SDL
             inline void Initialize(SDL_Window* window){
                 EnableSurfaceExtensions();
                 CreateInstance();
@@ -295,6 +780,25 @@ namespace Vulkan{
                 CreateDevice();
                 CreateSwapchain();
                 CreateImageViews();
+                CreateFrames();
+            }
+#endif//SETTING_DONT_USE_SDL
+
+            /**
+             * @brief One call initialize without a window (CI, servers, batch jobs).
+             *        No surface or swapchain is created, a ring of offscreen images
+             *        is rendered to instead. Works on software implementations like lavapipe.
+             * 
+             * @param extent size of offscreen images
+             * @param format of offscreen images
+             */
+            inline void InitializeHeadless(const VkExtent2D& extent, const VkFormat& format = VK_FORMAT_R8G8B8A8_UNORM){
+                CreateInstance();
+                SelectPhysicalDevice();
+                CreateDevice();
+                CreateOffscreenImages(extent, format, framesInFlight);
+                CreateImageViews();
+                CreateFrames();
             }
 
             /**
@@ -307,19 +811,26 @@ namespace Vulkan{
                 // wait for device to be idle
                 Vulkan::DeviceWaitIdle(device);
 
+                // destroy frames
+                if(!frames.empty()) DestroyFrames();
+
+                // destroy everything that was deferred
+                deletionQueue.FlushAll();
+
                 // destroy image views
                 for(const auto& imageView : imageViews){
                     Vulkan::DestroyImageView(device, imageView);
                 }
 
-                // destroy swapchain
-                Vulkan::DestroySwapchain(device, swapchain);
+                // destroy swapchain or offscreen images
+                if(swapchain != VK_NULL_HANDLE) Vulkan::DestroySwapchain(device, swapchain);
+                else DestroyOffscreenImages();
 
                 // destroy device
                 Vulkan::DestroyDevice(device);
 
                 // destroy surface
-                Vulkan::DestroySurface(instance, surface);
+                if(surface != VK_NULL_HANDLE) Vulkan::DestroySurface(instance, surface);
 
                 // destroy instance
                 Vulkan::DestroyInstance(instance);
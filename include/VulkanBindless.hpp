@@ -0,0 +1,317 @@
+/**
+ * @file VulkanBindless.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Bindless resource table built on descriptor indexing.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_BINDLESS_HPP
+#define VULKAN_HELPER_VULKAN_BINDLESS_HPP
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief One big update-after-bind descriptor set holding every sampled image,
+     *        storage buffer and sampler of the application. Resources are added once and
+     *        referred to by index, shaders get the indices through push constants and the
+     *        set is bound once per frame instead of once per draw.
+     *
+     *        binding 0 : sampled images    -> layout(set = 0, binding = 0) uniform texture2D images[];
+     *        binding 1 : storage buffers   -> layout(set = 0, binding = 1) buffer Buffers { ... } buffers[];
+     *        binding 2 : samplers          -> layout(set = 0, binding = 2) uniform sampler samplers[];
+     *
+     *        Requires Vulkan 1.2 descriptor indexing, see VulkanBase::EnableDescriptorIndexing.
+     *        Bindings are partially bound, so unused indices don't need valid descriptors.
+     *        Removed indices are reused right away; when frames in flight may still read a
+     *        resource, defer Remove* with a DeletionQueue. Thread safe.
+     *
+     */
+    struct BindlessTable{
+        /// binding of sampled images
+        static constexpr uint32 imageBinding = 0;
+
+        /// binding of storage buffers
+        static constexpr uint32 bufferBinding = 1;
+
+        /// binding of samplers
+        static constexpr uint32 samplerBinding = 2;
+
+        /// never returned by Add*, use it in push constants for "no resource"
+        static constexpr uint32 invalidIndex = UINT32_MAX;
+
+        /**
+         * @brief free list of indices of one binding
+         *
+         */
+        struct IndexAllocator{
+            /// number of descriptors in binding
+            uint32 capacity = 0;
+
+            /// indices below this were handed out at least once
+            uint32 next = 0;
+
+            /// returned indices, reused first
+            std::vector<uint32> freeIndices;
+
+            [[nodiscard]] inline uint32 Allocate(){
+                if(!freeIndices.empty()){
+                    uint32 index = freeIndices.back();
+                    freeIndices.pop_back();
+                    return index;
+                }
+                ASSERT(next < capacity, "[BindlessTable] : Out of descriptors, capacity is %u", capacity);
+                return next++;
+            }
+
+            inline void Free(const uint32& index){
+                ASSERT(index < next, "[BindlessTable] : Freeing index %u that was never allocated", index);
+                freeIndices.push_back(index);
+            }
+
+            /// number of indices currently in use
+            [[nodiscard]] inline uint32 Count() const{
+                return next - static_cast<uint32>(freeIndices.size());
+            }
+        };
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// layout of the table set, use it as set layout when creating pipeline layouts
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+
+        /// pool the set is allocated from
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+
+        /// the table
+        VkDescriptorSet set = VK_NULL_HANDLE;
+
+        /// sampled image indices
+        IndexAllocator images;
+
+        /// storage buffer indices
+        IndexAllocator buffers;
+
+        /// sampler indices
+        IndexAllocator samplers;
+
+        /// protects index allocators and descriptor writes
+        std::mutex mutex;
+
+        /**
+         * @brief create table, counts are clamped to update-after-bind limits of physical device
+         *
+         * @param physicalDevice
+         * @param device created with descriptor indexing features enabled
+         * @param maxImages number of sampled image descriptors
+         * @param maxBuffers number of storage buffer descriptors
+         * @param maxSamplers number of sampler descriptors
+         */
+        inline void Init(const VkPhysicalDevice& physicalDevice, const VkDevice& device, const uint32& maxImages = 16384, const uint32& maxBuffers = 16384, const uint32& maxSamplers = 256){
+            this->device = device;
+
+            // clamp to device limits
+            VkPhysicalDeviceVulkan12Properties limits = {};
+            limits.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+            (void)Vulkan::GetPhysicalDeviceProperties2(physicalDevice, &limits);
+            images   = {std::min({maxImages, limits.maxDescriptorSetUpdateAfterBindSampledImages, limits.maxPerStageDescriptorUpdateAfterBindSampledImages}), 0, {}};
+            buffers  = {std::min({maxBuffers, limits.maxDescriptorSetUpdateAfterBindStorageBuffers, limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers}), 0, {}};
+            samplers = {std::min({maxSamplers, limits.maxDescriptorSetUpdateAfterBindSamplers, limits.maxPerStageDescriptorUpdateAfterBindSamplers}), 0, {}};
+
+            // layout
+            std::vector<VkDescriptorSetLayoutBinding> bindings = {
+                Vulkan::Init::DescriptorSetLayoutBinding(imageBinding, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_SHADER_STAGE_ALL),
+                Vulkan::Init::DescriptorSetLayoutBinding(bufferBinding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_ALL),
+                Vulkan::Init::DescriptorSetLayoutBinding(samplerBinding, VK_DESCRIPTOR_TYPE_SAMPLER, VK_SHADER_STAGE_ALL)
+            };
+            bindings[imageBinding].descriptorCount   = images.capacity;
+            bindings[bufferBinding].descriptorCount  = buffers.capacity;
+            bindings[samplerBinding].descriptorCount = samplers.capacity;
+
+            const VkDescriptorBindingFlags flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+            std::array<VkDescriptorBindingFlags, 3> bindingFlags = {flags, flags, flags};
+
+            VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = {};
+            bindingFlagsInfo.sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+            bindingFlagsInfo.bindingCount   = static_cast<uint32>(bindingFlags.size());
+            bindingFlagsInfo.pBindingFlags  = bindingFlags.data();
+
+            VkDescriptorSetLayoutCreateInfo layoutInfo = Vulkan::Init::DescriptorSetLayoutCreateInfo(bindings);
+            layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+            layoutInfo.pNext = &bindingFlagsInfo;
+            layout = CreateDescriptorSetLayout(device, layoutInfo);
+
+            // pool with exactly one set
+            std::vector<VkDescriptorPoolSize> poolSizes = {
+                {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, images.capacity},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, buffers.capacity},
+                {VK_DESCRIPTOR_TYPE_SAMPLER, samplers.capacity}
+            };
+            pool = CreateDescriptorPool(device, Vulkan::Init::DescriptorPoolCreateInfo(poolSizes, 1, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT));
+
+            // the set
+            set = AllocateDescriptorSets(device, Vulkan::Init::DescriptorSetAllocateInfo(pool, layout))[0];
+
+            LOG(success, "[BindlessTable] : Created with %u images | %u buffers | %u samplers", images.capacity, buffers.capacity, samplers.capacity);
+        }
+
+        /**
+         * @brief add a sampled image
+         *
+         * @param imageView
+         * @param imageLayout layout image will be in when shaders read it
+         * @return uint32 : index into images[] in shaders
+         */
+        [[nodiscard]] inline uint32 AddImage(const VkImageView& imageView, const VkImageLayout& imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL){
+            std::lock_guard<std::mutex> lock(mutex);
+            uint32 index = images.Allocate();
+            WriteImage(index, imageView, imageLayout);
+            return index;
+        }
+
+        /**
+         * @brief add a storage buffer
+         *
+         * @param buffer
+         * @param offset
+         * @param range
+         * @return uint32 : index into buffers[] in shaders
+         */
+        [[nodiscard]] inline uint32 AddBuffer(const VkBuffer& buffer, const VkDeviceSize& offset = 0, const VkDeviceSize& range = VK_WHOLE_SIZE){
+            std::lock_guard<std::mutex> lock(mutex);
+            uint32 index = buffers.Allocate();
+            WriteBuffer(index, buffer, offset, range);
+            return index;
+        }
+
+        /**
+         * @brief add a sampler
+         *
+         * @param sampler
+         * @return uint32 : index into samplers[] in shaders
+         */
+        [[nodiscard]] inline uint32 AddSampler(const VkSampler& sampler){
+            std::lock_guard<std::mutex> lock(mutex);
+            uint32 index = samplers.Allocate();
+
+            VkDescriptorImageInfo imageInfo = {};
+            imageInfo.sampler = sampler;
+            UpdateDescriptorSets(device, Vulkan::Init::WriteDescriptorSet(samplerBinding, set, VK_DESCRIPTOR_TYPE_SAMPLER, imageInfo, index));
+            return index;
+        }
+
+        /**
+         * @brief point an existing image index to another view, eg. after a resize or hot reload
+         *
+         * @param index returned by AddImage
+         * @param imageView
+         * @param imageLayout
+         */
+        inline void UpdateImage(const uint32& index, const VkImageView& imageView, const VkImageLayout& imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL){
+            std::lock_guard<std::mutex> lock(mutex);
+            WriteImage(index, imageView, imageLayout);
+        }
+
+        /**
+         * @brief point an existing buffer index to another buffer
+         *
+         * @param index returned by AddBuffer
+         * @param buffer
+         * @param offset
+         * @param range
+         */
+        inline void UpdateBuffer(const uint32& index, const VkBuffer& buffer, const VkDeviceSize& offset = 0, const VkDeviceSize& range = VK_WHOLE_SIZE){
+            std::lock_guard<std::mutex> lock(mutex);
+            WriteBuffer(index, buffer, offset, range);
+        }
+
+        /// return an image index, GPU must not use it anymore
+        inline void RemoveImage(const uint32& index){
+            std::lock_guard<std::mutex> lock(mutex);
+            images.Free(index);
+        }
+
+        /// return a buffer index, GPU must not use it anymore
+        inline void RemoveBuffer(const uint32& index){
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers.Free(index);
+        }
+
+        /// return a sampler index, GPU must not use it anymore
+        inline void RemoveSampler(const uint32& index){
+            std::lock_guard<std::mutex> lock(mutex);
+            samplers.Free(index);
+        }
+
+        /**
+         * @brief bind the table, once per command buffer and bind point
+         *
+         * @param cmdBuffer
+         * @param bindPoint graphics/compute
+         * @param pipelineLayout any pipeline layout that has table layout at setIdx
+         * @param setIdx set number of table in shaders
+         */
+        inline void Bind(const VkCommandBuffer& cmdBuffer, const VkPipelineBindPoint& bindPoint, const VkPipelineLayout& pipelineLayout, const uint32& setIdx = 0) const{
+            CmdBindDescriptorSets(cmdBuffer, bindPoint, pipelineLayout, setIdx, set);
+        }
+
+        /**
+         * @brief destroy table, device must be idle
+         *
+         */
+        inline void Destroy(){
+            if(pool != VK_NULL_HANDLE) DestroyDescriptorPool(device, pool);
+            if(layout != VK_NULL_HANDLE) DestroyDescriptorSetLayout(device, layout);
+            pool = VK_NULL_HANDLE;
+            layout = VK_NULL_HANDLE;
+            set = VK_NULL_HANDLE;
+            images = buffers = samplers = {};
+        }
+
+    private:
+        inline void WriteImage(const uint32& index, const VkImageView& imageView, const VkImageLayout& imageLayout){
+            VkDescriptorImageInfo imageInfo = {};
+            imageInfo.imageView   = imageView;
+            imageInfo.imageLayout = imageLayout;
+            UpdateDescriptorSets(device, Vulkan::Init::WriteDescriptorSet(imageBinding, set, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, imageInfo, index));
+        }
+
+        inline void WriteBuffer(const uint32& index, const VkBuffer& buffer, const VkDeviceSize& offset, const VkDeviceSize& range){
+            VkDescriptorBufferInfo bufferInfo = {};
+            bufferInfo.buffer = buffer;
+            bufferInfo.offset = offset;
+            bufferInfo.range  = range;
+            UpdateDescriptorSets(device, Vulkan::Init::WriteDescriptorSet(bufferBinding, set, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, bufferInfo, index));
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_BINDLESS_HPP
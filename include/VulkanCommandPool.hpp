@@ -0,0 +1,198 @@
+/**
+ * @file VulkanCommandPool.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Command pool per (thread, frame in flight) for parallel command recording.
+ * @version 0.1
+ * @date 2021-05-08
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_COMMAND_POOL_HPP
+#define VULKAN_HELPER_VULKAN_COMMAND_POOL_HPP
+
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Keeps one command pool for every (thread, frame in flight) pair.
+     *        VkCommandPool is externally synchronized, so giving every recording thread
+     *        its own pool lets threads record without any locking.
+     *        Pools are reset as a whole at the start of a frame, which is much cheaper
+     *        than resetting individual command buffers, and command buffers are
+     *        recycled instead of being freed and allocated again.
+     *
+     *        Usage every frame :
+     *          // after waiting for the fence of this frame
+     *          pools.BeginFrame(frameIdx);
+     *          // on worker thread t
+     *          VkCommandBuffer secondary = pools.BeginSecondary(t, inheritanceInfo);
+     *          ...
+     *          Vulkan::EndCommandBuffer(secondary);
+     *          // on main thread
+     *          Vulkan::CmdExecuteCommands(primary, secondaries);
+     *
+     */
+    struct CommandPoolManager{
+        /**
+         * @brief pool of one thread in one frame
+         *
+         */
+        struct ThreadPool{
+            /// command pool
+            VkCommandPool pool = VK_NULL_HANDLE;
+
+            /// primary command buffers ever allocated from pool
+            std::vector<VkCommandBuffer> primaries;
+
+            /// secondary command buffers ever allocated from pool
+            std::vector<VkCommandBuffer> secondaries;
+
+            /// number of primaries handed out this frame
+            uint32 primaryCount = 0;
+
+            /// number of secondaries handed out this frame
+            uint32 secondaryCount = 0;
+        };
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// number of recording threads
+        uint32 threadCount = 0;
+
+        /// number of frames in flight
+        uint32 framesInFlight = 0;
+
+        /// frame being recorded
+        uint32 frameIdx = 0;
+
+        /// pools, indexed by frameIdx * threadCount + threadIdx
+        std::vector<ThreadPool> pools;
+
+        /**
+         * @brief create pools
+         *
+         * @param device
+         * @param queueFamilyIdx queue family command buffers will be submitted to
+         * @param threadCount number of threads that will record commands
+         * @param framesInFlight number of frames that can be in flight at once
+         */
+        inline void Init(const VkDevice& device, const uint32& queueFamilyIdx, const uint32& threadCount, const uint32& framesInFlight){
+            this->device = device;
+            this->threadCount = threadCount;
+            this->framesInFlight = framesInFlight;
+            frameIdx = 0;
+
+            // command buffers are short lived and never reset individually
+            pools.resize(threadCount * framesInFlight);
+            for(auto& threadPool : pools){
+                threadPool.pool = CreateCommandPool(device, Vulkan::Init::CommandPoolCreateInfo(queueFamilyIdx, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT));
+            }
+        }
+
+        /**
+         * @brief start recording a frame. Resets all pools of that frame, so the
+         *        GPU must be done with the command buffers submitted for it.
+         *        Must not be called while other threads are recording.
+         *
+         * @param frameIdx index of frame in [0, framesInFlight)
+         */
+        inline void BeginFrame(const uint32& frameIdx){
+            this->frameIdx = frameIdx;
+
+            for(uint32 t = 0; t < threadCount; t++){
+                ThreadPool& threadPool = pools[frameIdx * threadCount + t];
+                ResetCommandPool(device, threadPool.pool);
+                threadPool.primaryCount = 0;
+                threadPool.secondaryCount = 0;
+            }
+        }
+
+        /**
+         * @brief get a primary command buffer of a thread for current frame
+         *
+         * @param threadIdx index of calling thread in [0, threadCount)
+         * @return VkCommandBuffer in initial state
+         */
+        [[nodiscard]] inline VkCommandBuffer AllocatePrimary(const uint32& threadIdx){
+            ThreadPool& threadPool = GetThreadPool(threadIdx);
+            return Get(threadPool.pool, threadPool.primaries, threadPool.primaryCount, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        }
+
+        /**
+         * @brief get a secondary command buffer of a thread for current frame
+         *
+         * @param threadIdx index of calling thread in [0, threadCount)
+         * @return VkCommandBuffer in initial state
+         */
+        [[nodiscard]] inline VkCommandBuffer AllocateSecondary(const uint32& threadIdx){
+            ThreadPool& threadPool = GetThreadPool(threadIdx);
+            return Get(threadPool.pool, threadPool.secondaries, threadPool.secondaryCount, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+        }
+
+        /**
+         * @brief get a secondary command buffer and begin recording it for use inside a render pass
+         *
+         * @param threadIdx index of calling thread in [0, threadCount)
+         * @param inheritanceInfo render pass, subpass and framebuffer the buffer will be executed in
+         * @return VkCommandBuffer in recording state
+         */
+        [[nodiscard]] inline VkCommandBuffer BeginSecondary(const uint32& threadIdx, const VkCommandBufferInheritanceInfo& inheritanceInfo){
+            VkCommandBuffer cmdBuffer = AllocateSecondary(threadIdx);
+            BeginCommandBuffer(cmdBuffer, Vulkan::Init::CommandBufferBeginInfo(
+                VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &inheritanceInfo));
+            return cmdBuffer;
+        }
+
+        /**
+         * @brief destroy all pools, device must be idle
+         *
+         */
+        inline void Destroy(){
+            // destroying pool frees its command buffers
+            for(auto& threadPool : pools){
+                DestroyCommandPool(device, threadPool.pool);
+            }
+            pools.clear();
+        }
+
+    private:
+        /// pool of a thread in current frame
+        [[nodiscard]] inline ThreadPool& GetThreadPool(const uint32& threadIdx){
+            ASSERT(threadIdx < threadCount, "[CommandPoolManager] : Thread index %u out of range, manager was created for %u threads", threadIdx, threadCount);
+            return pools[frameIdx * threadCount + threadIdx];
+        }
+
+        /// reuse a command buffer from list or allocate a new one
+        [[nodiscard]] inline VkCommandBuffer Get(const VkCommandPool& pool, std::vector<VkCommandBuffer>& cmdBuffers, uint32& usedCount, const VkCommandBufferLevel& level){
+            if(usedCount == cmdBuffers.size()){
+                cmdBuffers.push_back(AllocateCommandBuffers(device, Vulkan::Init::CommandBufferAllocateInfo(pool, 1, level))[0]);
+            }
+            return cmdBuffers[usedCount++];
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_COMMAND_POOL_HPP
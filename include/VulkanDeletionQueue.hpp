@@ -0,0 +1,207 @@
+/**
+ * @file VulkanDeletionQueue.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Defers destruction of Vulkan objects until the GPU is done with them.
+ * @version 0.1
+ * @date 2021-05-14
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_DELETION_QUEUE_HPP
+#define VULKAN_HELPER_VULKAN_DELETION_QUEUE_HPP
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Queue of destroy operations tagged with the GPU work that may still use the objects.
+     *        Destroy* functions mirror the wrappers in Vulkan namespace, but only record the
+     *        handle with current pendingValue. Flush(completedValue) then destroys everything
+     *        tagged with a value the GPU has passed, so objects can be released while
+     *        frames are in flight without DeviceWaitIdle.
+     *
+     *        Values can be frame numbers (flush with the last frame whose fence was waited for)
+     *        or timeline semaphore values (flush with TimelineScheduler::GetCompletedValue).
+     *        pendingValue must never decrease. Thread safe.
+     *
+     */
+    struct DeletionQueue{
+        /**
+         * @brief one deferred destroy operation
+         *
+         */
+        struct Entry{
+            /// destroy once GPU passed this value
+            uint64 value = 0;
+
+            /// type of handle, VK_OBJECT_TYPE_UNKNOWN for callbacks
+            VkObjectType type = VK_OBJECT_TYPE_UNKNOWN;
+
+            /// handle stored as integer
+            uint64 handle = 0;
+
+            /// custom destroy operation
+            std::function<void()> callback;
+        };
+
+        /// device objects belong to
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// value of last GPU work that may use objects destroyed now
+        uint64 pendingValue = 0;
+
+        /// recorded operations, in order of value
+        std::deque<Entry> entries;
+
+        /// protects entries
+        std::mutex mutex;
+
+        /**
+         * @brief initialize queue
+         *
+         * @param device
+         */
+        inline void Init(const VkDevice& device){
+            this->device = device;
+            pendingValue = 0;
+        }
+
+        /// defer a custom destroy operation, eg. freeing a sub-allocation
+        inline void Push(std::function<void()> callback){
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.push_back(Entry{pendingValue, VK_OBJECT_TYPE_UNKNOWN, 0, std::move(callback)});
+        }
+
+        inline void DestroyBuffer(const VkBuffer& buffer) { Push(VK_OBJECT_TYPE_BUFFER, buffer); }
+        inline void DestroyImage(const VkImage& image) { Push(VK_OBJECT_TYPE_IMAGE, image); }
+        inline void DestroyImageView(const VkImageView& imageView) { Push(VK_OBJECT_TYPE_IMAGE_VIEW, imageView); }
+        inline void FreeMemory(const VkDeviceMemory& memory) { Push(VK_OBJECT_TYPE_DEVICE_MEMORY, memory); }
+        inline void DestroyFramebuffer(const VkFramebuffer& framebuffer) { Push(VK_OBJECT_TYPE_FRAMEBUFFER, framebuffer); }
+        inline void DestroyRenderPass(const VkRenderPass& renderPass) { Push(VK_OBJECT_TYPE_RENDER_PASS, renderPass); }
+        inline void DestroyPipeline(const VkPipeline& pipeline) { Push(VK_OBJECT_TYPE_PIPELINE, pipeline); }
+        inline void DestroyPipelineLayout(const VkPipelineLayout& pipelineLayout) { Push(VK_OBJECT_TYPE_PIPELINE_LAYOUT, pipelineLayout); }
+        inline void DestroyPipelineCache(const VkPipelineCache& pipelineCache) { Push(VK_OBJECT_TYPE_PIPELINE_CACHE, pipelineCache); }
+        inline void DestroyShaderModule(const VkShaderModule& shaderModule) { Push(VK_OBJECT_TYPE_SHADER_MODULE, shaderModule); }
+        inline void DestroyDescriptorSetLayout(const VkDescriptorSetLayout& layout) { Push(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, layout); }
+        inline void DestroyDescriptorPool(const VkDescriptorPool& pool) { Push(VK_OBJECT_TYPE_DESCRIPTOR_POOL, pool); }
+        inline void DestroyDescriptorUpdateTemplate(const VkDescriptorUpdateTemplate& updateTemplate) { Push(VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE, updateTemplate); }
+        inline void DestroySemaphore(const VkSemaphore& semaphore) { Push(VK_OBJECT_TYPE_SEMAPHORE, semaphore); }
+        inline void DestroyFence(const VkFence& fence) { Push(VK_OBJECT_TYPE_FENCE, fence); }
+        inline void DestroyCommandPool(const VkCommandPool& commandPool) { Push(VK_OBJECT_TYPE_COMMAND_POOL, commandPool); }
+        inline void DestroyQueryPool(const VkQueryPool& queryPool) { Push(VK_OBJECT_TYPE_QUERY_POOL, queryPool); }
+        inline void DestroySwapchain(const VkSwapchainKHR& swapchain) { Push(VK_OBJECT_TYPE_SWAPCHAIN_KHR, swapchain); }
+
+        /**
+         * @brief destroy everything the GPU is done with
+         *
+         * @param completedValue all GPU work with value <= this is complete
+         * @return size_t : number of objects destroyed
+         */
+        inline size_t Flush(const uint64& completedValue){
+            // take ready entries out so destroy calls run without the lock
+            std::deque<Entry> ready;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                while(!entries.empty() && entries.front().value <= completedValue){
+                    ready.push_back(std::move(entries.front()));
+                    entries.pop_front();
+                }
+            }
+
+            for(auto& entry : ready){
+                Execute(entry);
+            }
+            return ready.size();
+        }
+
+        /**
+         * @brief destroy everything, device must be idle
+         *
+         */
+        inline void FlushAll(){
+            Flush(UINT64_MAX);
+        }
+
+        /**
+         * @brief destroy everything and reset queue
+         *
+         */
+        inline void Destroy(){
+            FlushAll();
+        }
+
+    private:
+        /// non dispatchable handles are pointers on 64 bit platforms and uint64 on others
+        template<typename Handle>
+        [[nodiscard]] static inline uint64 ToInteger(const Handle& handle){
+            if constexpr(std::is_pointer_v<Handle>) return reinterpret_cast<uint64>(handle);
+            else return static_cast<uint64>(handle);
+        }
+
+        template<typename Handle>
+        [[nodiscard]] static inline Handle FromInteger(const uint64& handle){
+            if constexpr(std::is_pointer_v<Handle>) return reinterpret_cast<Handle>(handle);
+            else return static_cast<Handle>(handle);
+        }
+
+        /// record a typed handle
+        template<typename Handle>
+        inline void Push(const VkObjectType& type, const Handle& handle){
+            if(handle == VK_NULL_HANDLE) return;
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.push_back(Entry{pendingValue, type, ToInteger(handle), {}});
+        }
+
+        /// run destroy operation of an entry
+        inline void Execute(Entry& entry){
+            switch(entry.type){
+                case VK_OBJECT_TYPE_BUFFER                  : Vulkan::DestroyBuffer(device, FromInteger<VkBuffer>(entry.handle)); break;
+                case VK_OBJECT_TYPE_IMAGE                   : Vulkan::DestroyImage(device, FromInteger<VkImage>(entry.handle)); break;
+                case VK_OBJECT_TYPE_IMAGE_VIEW              : Vulkan::DestroyImageView(device, FromInteger<VkImageView>(entry.handle)); break;
+                case VK_OBJECT_TYPE_DEVICE_MEMORY           : Vulkan::FreeMemory(device, FromInteger<VkDeviceMemory>(entry.handle)); break;
+                case VK_OBJECT_TYPE_FRAMEBUFFER             : Vulkan::DestroyFramebuffer(device, FromInteger<VkFramebuffer>(entry.handle)); break;
+                case VK_OBJECT_TYPE_RENDER_PASS             : Vulkan::DestroyRenderPass(device, FromInteger<VkRenderPass>(entry.handle)); break;
+                case VK_OBJECT_TYPE_PIPELINE                : Vulkan::DestroyPipeline(device, FromInteger<VkPipeline>(entry.handle)); break;
+                case VK_OBJECT_TYPE_PIPELINE_LAYOUT         : Vulkan::DestroyPipelineLayout(device, FromInteger<VkPipelineLayout>(entry.handle)); break;
+                case VK_OBJECT_TYPE_PIPELINE_CACHE          : Vulkan::DestroyPipelineCache(device, FromInteger<VkPipelineCache>(entry.handle)); break;
+                case VK_OBJECT_TYPE_SHADER_MODULE           : Vulkan::DestroyShaderModule(device, FromInteger<VkShaderModule>(entry.handle)); break;
+                case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT   : Vulkan::DestroyDescriptorSetLayout(device, FromInteger<VkDescriptorSetLayout>(entry.handle)); break;
+                case VK_OBJECT_TYPE_DESCRIPTOR_POOL         : Vulkan::DestroyDescriptorPool(device, FromInteger<VkDescriptorPool>(entry.handle)); break;
+                case VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE : Vulkan::DestroyDescriptorUpdateTemplate(device, FromInteger<VkDescriptorUpdateTemplate>(entry.handle)); break;
+                case VK_OBJECT_TYPE_SEMAPHORE               : Vulkan::DestroySemaphore(device, FromInteger<VkSemaphore>(entry.handle)); break;
+                case VK_OBJECT_TYPE_FENCE                   : Vulkan::DestroyFence(device, FromInteger<VkFence>(entry.handle)); break;
+                case VK_OBJECT_TYPE_COMMAND_POOL            : Vulkan::DestroyCommandPool(device, FromInteger<VkCommandPool>(entry.handle)); break;
+                case VK_OBJECT_TYPE_QUERY_POOL              : Vulkan::DestroyQueryPool(device, FromInteger<VkQueryPool>(entry.handle)); break;
+                case VK_OBJECT_TYPE_SWAPCHAIN_KHR           : Vulkan::DestroySwapchain(device, FromInteger<VkSwapchainKHR>(entry.handle)); break;
+                default                                     : if(entry.callback) entry.callback(); break;
+            }
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_DELETION_QUEUE_HPP
@@ -0,0 +1,247 @@
+/**
+ * @file VulkanDescriptorAllocator.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Descriptor set allocator with growable pools and per frame reset.
+ * @version 0.1
+ * @date 2021-05-15
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_DESCRIPTOR_ALLOCATOR_HPP
+#define VULKAN_HELPER_VULKAN_DESCRIPTOR_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Linear descriptor set allocator.
+     *        Sets are allocated from a list of pools, when a pool runs out
+     *        (VK_ERROR_OUT_OF_POOL_MEMORY or VK_ERROR_FRAGMENTED_POOL) it is put aside and
+     *        allocation continues from a new, bigger pool. Sets are never freed one by one,
+     *        Reset() returns all of them with one vkResetDescriptorPool per pool.
+     *
+     */
+    struct DescriptorAllocator{
+        /**
+         * @brief number of descriptors of a type reserved per set in a pool
+         *
+         */
+        struct PoolSizeRatio{
+            VkDescriptorType type;
+            float ratio;
+        };
+
+        /// maximum sets in one pool, growth stops here
+        static constexpr uint32 maxSetsPerPool = 4096;
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// descriptors per set of each type
+        std::vector<PoolSizeRatio> ratios;
+
+        /// number of sets next created pool will hold
+        uint32 setsPerPool = 0;
+
+        /// pool sets are allocated from
+        VkDescriptorPool currentPool = VK_NULL_HANDLE;
+
+        /// empty pools ready to be used
+        std::vector<VkDescriptorPool> readyPools;
+
+        /// pools that ran out since last reset
+        std::vector<VkDescriptorPool> fullPools;
+
+        /**
+         * @brief initialize allocator, no pool is created until first allocation
+         *
+         * @param device
+         * @param initialSetsPerPool number of sets in first pool, doubled for every new pool
+         * @param ratios descriptors per set of each type, defaults to a mix for common materials
+         */
+        inline void Init(const VkDevice& device, const uint32& initialSetsPerPool = 64, const std::vector<PoolSizeRatio>& ratios = {}){
+            this->device = device;
+            this->setsPerPool = initialSetsPerPool;
+            this->ratios = ratios;
+            if(this->ratios.empty()){
+                this->ratios = {
+                    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+                    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+                    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2},
+                    {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+                    {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2},
+                    {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1},
+                    {VK_DESCRIPTOR_TYPE_SAMPLER, 1}
+                };
+            }
+        }
+
+        /**
+         * @brief allocate a descriptor set, grows when current pool is exhausted
+         *
+         * @param layout of set
+         * @param next pNext of allocate info, eg. variable descriptor count info
+         * @return VkDescriptorSet
+         */
+        [[nodiscard]] inline VkDescriptorSet Allocate(const VkDescriptorSetLayout& layout, const void* next = nullptr){
+            if(currentPool == VK_NULL_HANDLE) currentPool = GetPool();
+
+            VkDescriptorSetAllocateInfo allocateInfo = Vulkan::Init::DescriptorSetAllocateInfo(currentPool, layout);
+            allocateInfo.pNext = next;
+
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            VkResult res = vkAllocateDescriptorSets(device, &allocateInfo, &set);
+
+            // pool is exhausted, retry once with a fresh one
+            if(res == VK_ERROR_OUT_OF_POOL_MEMORY || res == VK_ERROR_FRAGMENTED_POOL){
+                fullPools.push_back(currentPool);
+                currentPool = GetPool();
+                allocateInfo.descriptorPool = currentPool;
+                res = vkAllocateDescriptorSets(device, &allocateInfo, &set);
+            }
+
+            ASSERT(res == VK_SUCCESS, "[DescriptorAllocator] : Descriptor Set allocation failed -> returned : %s", ResultString(res));
+            return set;
+        }
+
+        /**
+         * @brief return every allocated set, GPU must be done with all of them
+         *
+         */
+        inline void Reset(){
+            for(const auto& pool : fullPools){
+                ResetDescriptorPool(device, pool);
+                readyPools.push_back(pool);
+            }
+            fullPools.clear();
+
+            if(currentPool != VK_NULL_HANDLE){
+                ResetDescriptorPool(device, currentPool);
+                readyPools.push_back(currentPool);
+                currentPool = VK_NULL_HANDLE;
+            }
+        }
+
+        /**
+         * @brief destroy all pools, device must be idle
+         *
+         */
+        inline void Destroy(){
+            Reset();
+            for(const auto& pool : readyPools){
+                DestroyDescriptorPool(device, pool);
+            }
+            readyPools.clear();
+        }
+
+    private:
+        /// reuse an empty pool or create a bigger one
+        [[nodiscard]] inline VkDescriptorPool GetPool(){
+            if(!readyPools.empty()){
+                VkDescriptorPool pool = readyPools.back();
+                readyPools.pop_back();
+                return pool;
+            }
+
+            std::vector<VkDescriptorPoolSize> poolSizes;
+            poolSizes.reserve(ratios.size());
+            for(const auto& ratio : ratios){
+                poolSizes.push_back({ratio.type, std::max(1u, static_cast<uint32>(ratio.ratio * setsPerPool))});
+            }
+
+            VkDescriptorPool pool = CreateDescriptorPool(device, Vulkan::Init::DescriptorPoolCreateInfo(poolSizes, setsPerPool));
+            setsPerPool = std::min(setsPerPool * 2, maxSetsPerPool);
+            return pool;
+        }
+    };
+
+    /**
+     * @brief One DescriptorAllocator per frame in flight.
+     *        Sets allocated in a frame live until the same frame slot comes around again,
+     *        then all of them are returned with one reset. Use it for sets that change
+     *        every frame; long lived sets should come from a DescriptorAllocator that is
+     *        never reset.
+     *
+     */
+    struct FrameDescriptorAllocator{
+        /// allocator of each frame in flight
+        std::vector<DescriptorAllocator> allocators;
+
+        /// frame being recorded
+        uint32 frameIdx = 0;
+
+        /**
+         * @brief create allocators
+         *
+         * @param device
+         * @param framesInFlight number of frames that can be in flight at once
+         * @param initialSetsPerPool number of sets in first pool of each frame
+         * @param ratios descriptors per set of each type
+         */
+        inline void Init(const VkDevice& device, const uint32& framesInFlight, const uint32& initialSetsPerPool = 64, const std::vector<DescriptorAllocator::PoolSizeRatio>& ratios = {}){
+            allocators.resize(framesInFlight);
+            for(auto& allocator : allocators){
+                allocator.Init(device, initialSetsPerPool, ratios);
+            }
+            frameIdx = 0;
+        }
+
+        /**
+         * @brief start a frame, returns all sets allocated in this slot.
+         *        Fence of the frame must be waited for.
+         *
+         * @param frameIdx index of frame in [0, framesInFlight)
+         */
+        inline void BeginFrame(const uint32& frameIdx){
+            this->frameIdx = frameIdx;
+            allocators[frameIdx].Reset();
+        }
+
+        /**
+         * @brief allocate a set that lives until this frame slot is begun again
+         *
+         * @param layout of set
+         * @param next pNext of allocate info
+         * @return VkDescriptorSet
+         */
+        [[nodiscard]] inline VkDescriptorSet Allocate(const VkDescriptorSetLayout& layout, const void* next = nullptr){
+            return allocators[frameIdx].Allocate(layout, next);
+        }
+
+        /**
+         * @brief destroy all pools, device must be idle
+         *
+         */
+        inline void Destroy(){
+            for(auto& allocator : allocators){
+                allocator.Destroy();
+            }
+            allocators.clear();
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_DESCRIPTOR_ALLOCATOR_HPP
@@ -0,0 +1,174 @@
+/**
+ * @file VulkanDescriptorTemplate.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Typed descriptor update templates, update a whole set from one struct.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_DESCRIPTOR_TEMPLATE_HPP
+#define VULKAN_HELPER_VULKAN_DESCRIPTOR_TEMPLATE_HPP
+
+#include <array>
+#include <type_traits>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief element type and count of a descriptor member, arrays become array descriptors
+     *
+     */
+    template<typename Member>
+    struct DescriptorMemberTraits{
+        using Element = Member;
+        static constexpr uint32 count = 1;
+    };
+
+    template<typename Element_, size_t N>
+    struct DescriptorMemberTraits<Element_[N]>{
+        using Element = Element_;
+        static constexpr uint32 count = static_cast<uint32>(N);
+    };
+
+    template<typename Element_, size_t N>
+    struct DescriptorMemberTraits<std::array<Element_, N>>{
+        using Element = Element_;
+        static constexpr uint32 count = static_cast<uint32>(N);
+    };
+
+    /**
+     * @brief Descriptor update template built from the layout of a C++ struct.
+     *        Each Add() maps one member of T to a binding; members must be
+     *        VkDescriptorBufferInfo, VkDescriptorImageInfo or VkBufferView, or arrays of them.
+     *        Update() then writes every binding of a set with one
+     *        vkUpdateDescriptorSetWithTemplate, no VkWriteDescriptorSet is built.
+     *
+     *        struct FrameDescriptors{
+     *            VkDescriptorBufferInfo camera;
+     *            VkDescriptorImageInfo shadowMaps[4];
+     *        };
+     *
+     */
+    template<typename T>
+    struct DescriptorTemplate{
+        static_assert(std::is_trivially_copyable_v<T>, "[DescriptorTemplate] : Update data must be trivially copyable");
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// template handle, created by Create
+        VkDescriptorUpdateTemplate handle = VK_NULL_HANDLE;
+
+        /// one entry per added member
+        std::vector<VkDescriptorUpdateTemplateEntry> entries;
+
+        /**
+         * @brief map a member of T to a binding
+         *
+         * @param binding binding number in shader
+         * @param descriptorType type of descriptors at binding, must match member type
+         * @param member pointer to member, eg. &FrameDescriptors::camera
+         * @param arrayElement first array element of binding the member is written to
+         * @return DescriptorTemplate& : for chaining
+         */
+        template<typename Member>
+        inline DescriptorTemplate& Add(const uint32& binding, const VkDescriptorType& descriptorType, Member T::* member, const uint32& arrayElement = 0){
+            using Element = typename DescriptorMemberTraits<Member>::Element;
+            static_assert(std::is_same_v<Element, VkDescriptorBufferInfo> || std::is_same_v<Element, VkDescriptorImageInfo> || std::is_same_v<Element, VkBufferView>,
+                          "[DescriptorTemplate] : Member must be VkDescriptorBufferInfo, VkDescriptorImageInfo, VkBufferView or an array of them");
+            ASSERT(IsCompatible<Element>(descriptorType), "[DescriptorTemplate] : Member type doesn't match descriptor type of binding %u", binding);
+
+            entries.push_back(Vulkan::Init::DescriptorUpdateTemplateEntry(binding, descriptorType, OffsetOf(member), sizeof(Element), DescriptorMemberTraits<Member>::count, arrayElement));
+            return *this;
+        }
+
+        /**
+         * @brief create template for sets of given layout, call after all members are added
+         *
+         * @param device
+         * @param setLayout layout of sets that will be updated
+         */
+        inline void Create(const VkDevice& device, const VkDescriptorSetLayout& setLayout){
+            ASSERT(!entries.empty(), "[DescriptorTemplate] : No members were added");
+            this->device = device;
+            handle = CreateDescriptorUpdateTemplate(device, Vulkan::Init::DescriptorUpdateTemplateCreateInfo(entries, setLayout));
+        }
+
+        /**
+         * @brief write all mapped bindings of a set
+         *
+         * @param set to update, GPU must not be using it
+         * @param data descriptor infos
+         */
+        inline void Update(const VkDescriptorSet& set, const T& data) const{
+            UpdateDescriptorSetWithTemplate(device, set, handle, &data);
+        }
+
+        /**
+         * @brief destroy template
+         *
+         */
+        inline void Destroy(){
+            if(handle != VK_NULL_HANDLE) DestroyDescriptorUpdateTemplate(device, handle);
+            handle = VK_NULL_HANDLE;
+            entries.clear();
+        }
+
+    private:
+        /// byte offset of a member in T, computed on raw storage so T isn't constructed
+        template<typename Member>
+        [[nodiscard]] static inline size_t OffsetOf(Member T::* member){
+            alignas(T) static unsigned char storage[sizeof(T)];
+            const T* object = reinterpret_cast<const T*>(storage);
+            return static_cast<size_t>(reinterpret_cast<const unsigned char*>(&(object->*member)) - storage);
+        }
+
+        /// check member type can hold descriptors of given type
+        template<typename Element>
+        [[nodiscard]] static inline bool IsCompatible(const VkDescriptorType& descriptorType){
+            switch(descriptorType){
+                case VK_DESCRIPTOR_TYPE_SAMPLER:
+                case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                    return std::is_same_v<Element, VkDescriptorImageInfo>;
+                case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+                case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                    return std::is_same_v<Element, VkBufferView>;
+                case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+                case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+                case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                    return std::is_same_v<Element, VkDescriptorBufferInfo>;
+                default:
+                    return false;
+            }
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_DESCRIPTOR_TEMPLATE_HPP
@@ -32,6 +32,9 @@
 // Vulkan C function wrappers
 #include "Vulkan.hpp"
 
+// non fatal wrappers returning VkResult
+#include "VulkanResult.hpp"
+
 // enum to string converter
 #include "VulkanEnumStringifier.hpp"
 
@@ -44,5 +47,59 @@
 // vulkan base for speedy initialization of vulkan
 #include "VulkanBase.hpp"
 
+// device memory sub-allocator
+#include "VulkanMemory.hpp"
+
+// staging ring buffer for streaming uploads
+#include "VulkanStaging.hpp"
+
+// disk persistent pipeline cache
+#include "VulkanPipelineCache.hpp"
+
+// multithreaded pipeline compilation
+#include "VulkanAsyncPipelineBuilder.hpp"
+
+// deferred destruction of in flight objects
+#include "VulkanDeletionQueue.hpp"
+
+// growable descriptor set allocator
+#include "VulkanDescriptorAllocator.hpp"
+
+// deduplicated descriptor set and pipeline layouts
+#include "VulkanLayoutCache.hpp"
+
+// typed descriptor update templates
+#include "VulkanDescriptorTemplate.hpp"
+
+// bindless resource table
+#include "VulkanBindless.hpp"
+
+// automatic pipeline barriers
+#include "VulkanBarrier.hpp"
+
+// frame graph with transient memory aliasing
+#include "VulkanRenderGraph.hpp"
+
+// memory mapped shader loading and shader archives
+#include "VulkanShaderArchive.hpp"
+
+// shader module cache with hot reload
+#include "VulkanShaderCache.hpp"
+
+// spir-v reflection
+#include "VulkanReflection.hpp"
+
+// hashable pipeline state and pipeline registry
+#include "VulkanPipelineState.hpp"
+
+// per thread command pools
+#include "VulkanCommandPool.hpp"
+
+// timeline semaphore submission scheduler
+#include "VulkanTimeline.hpp"
+
+// GPU timestamp profiler
+#include "VulkanProfiler.hpp"
+
 
 #endif//VULKAN_HELPER_HEADER
\ No newline at end of file
@@ -27,7 +27,6 @@
 #ifndef VULKAN_HELPER_INITIALIZERS_HPP
 #define VULKAN_HELPER_INITIALIZERS_HPP
 
-#include <SDL2/SDL_video.h>
 #include <vector>
 
 #include <vulkan/vulkan.h>
@@ -36,6 +35,10 @@
 #include "Vulkan.hpp"
 #include "VulkanTools.hpp"
 
+#ifndef SETTING_DONT_USE_SDL
+    #include <SDL2/SDL_video.h>
+#endif//SETTING_DONT_USE_SDL
+
 // Vulkan Namespace contains vulkan initializers, helpers etc
 namespace Vulkan{
 
@@ -135,10 +138,13 @@ namespace Vulkan{
         * 
         * @param physicalDevice 
         * @param surface 
+        * @param windowExtent size of window, used when surface doesn't dictate the extent
+        * @param queueFamilyIndices storage for graphics and present family indices, create info points to it so it must outlive create info
+        * @param oldSwapchain swapchain being replaced, lets driver reuse its resources
         * @return VkSwapchainCreateInfoKHR 
         */
         [[nodiscard]] inline VkSwapchainCreateInfoKHR SwapchainCreateInfo(const VkPhysicalDevice& physicalDevice, 
-            const VkSurfaceKHR& surface, SDL_Window* window) noexcept{
+            const VkSurfaceKHR& surface, const VkExtent2D& windowExtent, uint32 (&queueFamilyIndices)[2], const VkSwapchainKHR& oldSwapchain = VK_NULL_HANDLE) noexcept{
             // get surface information required for swapchain creation
             auto surfacePresentModes = Vulkan::GetPhysicalDeviceSurfacePresentModes(physicalDevice, surface);
             auto surfaceCapabilities = Vulkan::GetPhysicalDeviceSurfaceCapabilities(physicalDevice, surface);
@@ -150,7 +156,7 @@ namespace Vulkan{
             auto surfacePresentMode      = Vulkan::Tools::SelectSwapchainSurfacePresentMode(surfacePresentModes);
             
             // store image extent
-            auto swapchainImageExtent    = Vulkan::Tools::SelectSwapchainSurfaceImageExtent(window, surfaceCapabilities);
+            auto swapchainImageExtent    = Vulkan::Tools::SelectSwapchainSurfaceImageExtent(windowExtent, surfaceCapabilities);
             
             // it is recommended to set minimum image count one more than given min count
             uint32 imageCount   = surfaceCapabilities.minImageCount + 1;
@@ -163,7 +169,7 @@ namespace Vulkan{
             // first we need swapchain create info
             VkSwapchainCreateInfoKHR swapchainCreateInfo = {};
             swapchainCreateInfo.sType               = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-            swapchainCreateInfo.oldSwapchain        = VK_NULL_HANDLE;
+            swapchainCreateInfo.oldSwapchain        = oldSwapchain;
             swapchainCreateInfo.surface             = surface;
             swapchainCreateInfo.presentMode         = surfacePresentMode;
             swapchainCreateInfo.imageFormat         = surfaceFormat.format;
@@ -181,7 +187,8 @@ namespace Vulkan{
             auto presentQueueIdx  = GetPhysicalDeviceSurfaceSupportQueueIndex(physicalDevice, surface);
 
             // check whehter the image will be used by multiple queues or not
-            uint32 queueFamilyIndices[] = {graphicsQueueIdx.value(), presentQueueIdx.value()};
+            queueFamilyIndices[0] = graphicsQueueIdx.value();
+            queueFamilyIndices[1] = presentQueueIdx.value();
             
             // if it is to be used in different queus then
             // set to concurrent mode (many access at once (slow))
@@ -208,6 +215,25 @@ namespace Vulkan{
             return swapchainCreateInfo;
         }
 
+#ifndef SETTING_DONT_USE_SDL
+        /**
+        * @brief swapchain create info initializer
+        * 
+        * @param physicalDevice 
+        * @param surface 
+        * @param window surface was created for
+        * @param queueFamilyIndices storage for graphics and present family indices, create info points to it so it must outlive create info
+        * @param oldSwapchain swapchain being replaced, lets driver reuse its resources
+        * @return VkSwapchainCreateInfoKHR 
+        */
+        [[nodiscard]] inline VkSwapchainCreateInfoKHR SwapchainCreateInfo(const VkPhysicalDevice& physicalDevice, 
+            const VkSurfaceKHR& surface, SDL_Window* window, uint32 (&queueFamilyIndices)[2], const VkSwapchainKHR& oldSwapchain = VK_NULL_HANDLE) noexcept{
+            int w, h;
+            SDL_GetWindowSize(window, &w, &h);
+            return SwapchainCreateInfo(physicalDevice, surface, VkExtent2D{static_cast<uint32>(w), static_cast<uint32>(h)}, queueFamilyIndices, oldSwapchain);
+        }
+#endif//SETTING_DONT_USE_SDL
+
         /**
          * @brief image view create info
          * 
@@ -273,14 +299,15 @@ namespace Vulkan{
          * 
          * @param commandPool 
          * @param commandBufferCount 
+         * @param level primary or secondary
          * @return VkCommandBufferAllocateInfo 
          */
-        [[nodiscard]] inline VkCommandBufferAllocateInfo CommandBufferAllocateInfo(const VkCommandPool& commandPool, uint32 commandBufferCount){
+        [[nodiscard]] inline VkCommandBufferAllocateInfo CommandBufferAllocateInfo(const VkCommandPool& commandPool, uint32 commandBufferCount, const VkCommandBufferLevel& level = VK_COMMAND_BUFFER_LEVEL_PRIMARY){
             // initialize
             VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
             commandBufferAllocateInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
             commandBufferAllocateInfo.commandPool        = commandPool;
-            commandBufferAllocateInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            commandBufferAllocateInfo.level              = level;
             commandBufferAllocateInfo.commandBufferCount = commandBufferCount;
 
             // return
@@ -428,18 +455,38 @@ namespace Vulkan{
         /**
          * @brief semaphore create info initializer 
          * 
+         * @param next chained struct, eg. VkSemaphoreTypeCreateInfo for timeline semaphores
          * @return VkSemaphoreCreateInfo 
          */
-        [[nodiscard]] inline VkSemaphoreCreateInfo SemaphoreCreateInfo(){
+        [[nodiscard]] inline VkSemaphoreCreateInfo SemaphoreCreateInfo(const void* next = nullptr){
             // initialize
             VkSemaphoreCreateInfo semaphoreInfo = {};
             semaphoreInfo.sType     = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            semaphoreInfo.pNext     = next;
             // for semaphore we dont need any flags
 
             // return
             return semaphoreInfo;
         }
 
+        /**
+         * @brief semaphore type create info initializer, chain it to VkSemaphoreCreateInfo
+         * 
+         * @param semaphoreType binary or timeline
+         * @param initialValue initial value of timeline semaphore
+         * @return VkSemaphoreTypeCreateInfo 
+         */
+        [[nodiscard]] inline VkSemaphoreTypeCreateInfo SemaphoreTypeCreateInfo(const VkSemaphoreType& semaphoreType, const uint64& initialValue = 0){
+            // initialize
+            VkSemaphoreTypeCreateInfo typeInfo = {};
+            typeInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+            typeInfo.semaphoreType  = semaphoreType;
+            typeInfo.initialValue   = initialValue;
+
+            // return
+            return typeInfo;
+        }
+
         /**
          * @brief Shader Module Create Info initializer
          * 
@@ -457,22 +504,63 @@ namespace Vulkan{
             return shaderModuleCreateInfo;
         }
 
+        /**
+         * @brief Shader Module Create Info initializer for code that is already
+         *        in memory as spir-v words (for example a mapped file)
+         *
+         * @param code pointer to 4 byte aligned spir-v code
+         * @param codeSize size of code in bytes, must be a multiple of 4
+         * @return VkShaderModuleCreateInfo
+         */
+        [[nodiscard]] inline VkShaderModuleCreateInfo ShaderModuleCreateInfo(const uint32* code, const size_t& codeSize){
+            // intialize
+            VkShaderModuleCreateInfo shaderModuleCreateInfo = {};
+            shaderModuleCreateInfo.sType        = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            shaderModuleCreateInfo.codeSize     = codeSize;
+            shaderModuleCreateInfo.pCode        = code;
+
+            // return
+            return shaderModuleCreateInfo;
+        }
+
         /**
          * @brief command buffer begin info initializer
          * 
          * @param usageFlags 
+         * @param inheritanceInfo required for secondary command buffers
          * @return VkCommandBufferBeginInfo 
          */
-        [[nodiscard]] inline VkCommandBufferBeginInfo CommandBufferBeginInfo(const VkCommandBufferUsageFlagBits& usageFlags){
+        [[nodiscard]] inline VkCommandBufferBeginInfo CommandBufferBeginInfo(const VkCommandBufferUsageFlags& usageFlags, const VkCommandBufferInheritanceInfo* inheritanceInfo = nullptr){
             // initialize
             VkCommandBufferBeginInfo beginInfo = {};
-            beginInfo.sType         = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            beginInfo.flags         = usageFlags;
+            beginInfo.sType             = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags             = usageFlags;
+            beginInfo.pInheritanceInfo  = inheritanceInfo;
 
             // return
             return beginInfo;
         }
 
+        /**
+         * @brief command buffer inheritance info initializer, for secondary command buffers
+         * 
+         * @param renderPass secondary command buffer will be executed in
+         * @param subpass index of subpass in render pass
+         * @param framebuffer can be VK_NULL_HANDLE if not known while recording
+         * @return VkCommandBufferInheritanceInfo 
+         */
+        [[nodiscard]] inline VkCommandBufferInheritanceInfo CommandBufferInheritanceInfo(const VkRenderPass& renderPass, const uint32& subpass, const VkFramebuffer& framebuffer = VK_NULL_HANDLE){
+            // initialize
+            VkCommandBufferInheritanceInfo inheritanceInfo = {};
+            inheritanceInfo.sType       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritanceInfo.renderPass  = renderPass;
+            inheritanceInfo.subpass     = subpass;
+            inheritanceInfo.framebuffer = framebuffer;
+
+            // return
+            return inheritanceInfo;
+        }
+
         /**
          * @brief render pass begin info initializer
          * 
@@ -703,6 +791,23 @@ namespace Vulkan{
             return viewportInfo;
         }
 
+        /**
+         * @brief dynamic state create info initializer
+         *
+         * @param dynamicStates states that are set in command buffer instead of pipeline
+         * @return VkPipelineDynamicStateCreateInfo
+         */
+        [[nodiscard]] inline VkPipelineDynamicStateCreateInfo PipelineDynamicStateCreateInfo(const std::vector<VkDynamicState>& dynamicStates){
+            // initialize
+            VkPipelineDynamicStateCreateInfo dynamicStateInfo = {};
+            dynamicStateInfo.sType              = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+            dynamicStateInfo.dynamicStateCount  = dynamicStates.size();
+            dynamicStateInfo.pDynamicStates     = dynamicStates.data();
+
+            // return
+            return dynamicStateInfo;
+        }
+
         /**
          * @brief returns empty graphics pipeline create info
          * 
@@ -740,7 +845,7 @@ namespace Vulkan{
          * @param usageFlags is how do you want to use this buffer?
          * @return VkBufferCreateInfo 
          */
-        [[nodiscard]] inline VkBufferCreateInfo BufferCreateInfo(const uint32 size, const VkBufferUsageFlags& usageFlags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT){
+        [[nodiscard]] inline VkBufferCreateInfo BufferCreateInfo(const VkDeviceSize& size, const VkBufferUsageFlags& usageFlags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT){
             // initialize
             VkBufferCreateInfo bufferCreateInfo = {};
             bufferCreateInfo.sType              = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -773,20 +878,42 @@ namespace Vulkan{
          * @brief VkDescriptorPoolCreateInfo initializer
          * 
          * @param poolSizes 
+         * @param maxSets maximum number of sets that can be allocated from pool
+         * @param flags 
          * @return VkDescriptorPoolCreateInfo 
          */
-        [[nodiscard]] inline VkDescriptorPoolCreateInfo DescriptorPoolCreateInfo(const std::vector<VkDescriptorPoolSize>& poolSizes){
+        [[nodiscard]] inline VkDescriptorPoolCreateInfo DescriptorPoolCreateInfo(const std::vector<VkDescriptorPoolSize>& poolSizes, const uint32& maxSets = 10, const VkDescriptorPoolCreateFlags& flags = 0){
             // initialize
             VkDescriptorPoolCreateInfo createInfo = {};
             createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            createInfo.flags = flags;
             createInfo.pPoolSizes = poolSizes.data();
             createInfo.poolSizeCount = static_cast<uint32>(poolSizes.size());
-            createInfo.maxSets = 10;
+            createInfo.maxSets = maxSets;
 
             // return
             return createInfo;
         }
 
+        /**
+         * @brief VkDescriptorSetAllocateInfo initializer
+         * 
+         * @param descriptorPool pool to allocate from
+         * @param layouts one set is allocated for every layout
+         * @return VkDescriptorSetAllocateInfo 
+         */
+        [[nodiscard]] inline VkDescriptorSetAllocateInfo DescriptorSetAllocateInfo(const VkDescriptorPool& descriptorPool, const Span<VkDescriptorSetLayout>& layouts){
+            // initialize
+            VkDescriptorSetAllocateInfo allocateInfo = {};
+            allocateInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocateInfo.descriptorPool     = descriptorPool;
+            allocateInfo.descriptorSetCount = layouts.size();
+            allocateInfo.pSetLayouts        = layouts.data();
+
+            // return
+            return allocateInfo;
+        }
+
         /**
          * @brief image create info initializer
          * 
@@ -859,15 +986,17 @@ namespace Vulkan{
          * @param dstSet is what set to write to
          * @param descriptorType is uniform/sampler/storage... ?
          * @param bufferInfo is information of buffer that will be written
+         * @param arrayElement is first array element of binding to write to
          * 
          * @return 
          */
-        [[nodiscard]] inline VkWriteDescriptorSet WriteDescriptorSet(const uint32& binding, const VkDescriptorSet& dstSet, const VkDescriptorType& descriptorType, const VkDescriptorBufferInfo& bufferInfo){
+        [[nodiscard]] inline VkWriteDescriptorSet WriteDescriptorSet(const uint32& binding, const VkDescriptorSet& dstSet, const VkDescriptorType& descriptorType, const VkDescriptorBufferInfo& bufferInfo, const uint32& arrayElement = 0){
             // initialize
             VkWriteDescriptorSet write = {};
             write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
             write.dstBinding = binding;
             write.dstSet = dstSet;
+            write.dstArrayElement = arrayElement;
             write.descriptorCount = 1;
             write.descriptorType = descriptorType;
             write.pBufferInfo = &bufferInfo;
@@ -876,6 +1005,133 @@ namespace Vulkan{
             return write;
         }
 
+        /**
+         * @brief write descriptor set initializer for image descriptors
+         *
+         * @param binding is binding number in shader to write to
+         * @param dstSet is what set to write to
+         * @param descriptorType is sampler/sampled image/storage image... ?
+         * @param imageInfo is information of image that will be written
+         * @param arrayElement is first array element of binding to write to
+         *
+         * @return
+         */
+        [[nodiscard]] inline VkWriteDescriptorSet WriteDescriptorSet(const uint32& binding, const VkDescriptorSet& dstSet, const VkDescriptorType& descriptorType, const VkDescriptorImageInfo& imageInfo, const uint32& arrayElement = 0){
+            // initialize
+            VkWriteDescriptorSet write = {};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstBinding = binding;
+            write.dstSet = dstSet;
+            write.dstArrayElement = arrayElement;
+            write.descriptorCount = 1;
+            write.descriptorType = descriptorType;
+            write.pImageInfo = &imageInfo;
+
+            // return
+            return write;
+        }
+
+        /**
+         * @brief descriptor update template entry initializer
+         *
+         * @param binding is binding number in shader to write to
+         * @param descriptorType type of descriptors at binding
+         * @param offset byte offset of first info in update data
+         * @param stride byte distance between consecutive infos in update data
+         * @param descriptorCount number of array elements to write
+         * @param arrayElement first array element to write
+         * @return VkDescriptorUpdateTemplateEntry
+         */
+        [[nodiscard]] inline VkDescriptorUpdateTemplateEntry DescriptorUpdateTemplateEntry(const uint32& binding, const VkDescriptorType& descriptorType, const size_t& offset, const size_t& stride, const uint32& descriptorCount = 1, const uint32& arrayElement = 0){
+            // initialize
+            VkDescriptorUpdateTemplateEntry entry = {};
+            entry.dstBinding       = binding;
+            entry.dstArrayElement  = arrayElement;
+            entry.descriptorCount  = descriptorCount;
+            entry.descriptorType   = descriptorType;
+            entry.offset           = offset;
+            entry.stride           = stride;
+
+            // return
+            return entry;
+        }
+
+        /**
+         * @brief descriptor update template create info initializer, for updating descriptor sets of a layout
+         *
+         * @param entries where each descriptor is found in update data
+         * @param setLayout layout of sets that will be updated
+         * @return VkDescriptorUpdateTemplateCreateInfo
+         */
+        [[nodiscard]] inline VkDescriptorUpdateTemplateCreateInfo DescriptorUpdateTemplateCreateInfo(const Span<VkDescriptorUpdateTemplateEntry>& entries, const VkDescriptorSetLayout& setLayout){
+            // initialize
+            VkDescriptorUpdateTemplateCreateInfo createInfo = {};
+            createInfo.sType                        = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+            createInfo.descriptorUpdateEntryCount   = entries.size();
+            createInfo.pDescriptorUpdateEntries     = entries.data();
+            createInfo.templateType                 = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+            createInfo.descriptorSetLayout          = setLayout;
+
+            // return
+            return createInfo;
+        }
+
+        /**
+         * @brief memory allocate info initializer
+         * 
+         * @param allocationSize size of allocation in bytes
+         * @param memoryTypeIndex index of memory type to allocate from
+         * @return VkMemoryAllocateInfo 
+         */
+        [[nodiscard]] inline VkMemoryAllocateInfo MemoryAllocateInfo(const VkDeviceSize& allocationSize, const uint32& memoryTypeIndex){
+            // initialize
+            VkMemoryAllocateInfo allocateInfo = {};
+            allocateInfo.sType              = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocateInfo.allocationSize     = allocationSize;
+            allocateInfo.memoryTypeIndex    = memoryTypeIndex;
+
+            // return
+            return allocateInfo;
+        }
+
+        /**
+         * @brief pipeline cache create info initializer
+         * 
+         * @param initialData previously serialized cache data, can be nullptr
+         * @param initialDataSize size of initial data in bytes
+         * @return VkPipelineCacheCreateInfo 
+         */
+        [[nodiscard]] inline VkPipelineCacheCreateInfo PipelineCacheCreateInfo(const void* initialData = nullptr, const size_t& initialDataSize = 0){
+            // initialize
+            VkPipelineCacheCreateInfo createInfo = {};
+            createInfo.sType            = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+            createInfo.initialDataSize  = initialDataSize;
+            createInfo.pInitialData     = initialData;
+
+            // return
+            return createInfo;
+        }
+
+        /**
+         * @brief query pool create info initializer
+         * 
+         * @param queryType type of queries in pool
+         * @param queryCount number of queries in pool
+         * @param pipelineStatistics statistics to count, only for VK_QUERY_TYPE_PIPELINE_STATISTICS
+         * @return VkQueryPoolCreateInfo 
+         */
+        [[nodiscard]] inline VkQueryPoolCreateInfo QueryPoolCreateInfo(const VkQueryType& queryType, const uint32& queryCount, const VkQueryPipelineStatisticFlags& pipelineStatistics = 0){
+            // initialize
+            VkQueryPoolCreateInfo createInfo = {};
+            createInfo.sType                = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            createInfo.queryType            = queryType;
+            createInfo.queryCount           = queryCount;
+            createInfo.pipelineStatistics   = pipelineStatistics;
+
+            // return
+            return createInfo;
+        }
+
     } // namespace Init
 
 } // namespace Vulkan
@@ -0,0 +1,315 @@
+/**
+ * @file VulkanLayoutCache.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Deduplicating cache for descriptor set layouts and pipeline layouts.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_LAYOUT_CACHE_HPP
+#define VULKAN_HELPER_VULKAN_LAYOUT_CACHE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Hash-consing cache for layouts. Identical descriptor set layout bindings
+     *        (in any order) always give back the same VkDescriptorSetLayout, and identical
+     *        set layout lists + push constant ranges give back the same VkPipelineLayout.
+     *        Besides saving driver memory this makes layouts of different pipelines
+     *        compatible, so descriptor sets stay bound across pipeline switches.
+     *
+     *        Lookups are thread safe. Entries are spread over shardCount maps, each with
+     *        its own lock, so threads building different pipelines rarely contend.
+     *        Handles are owned by the cache and destroyed in Destroy().
+     *
+     */
+    struct LayoutCache{
+        /// number of independently locked maps per layout kind
+        static constexpr uint32 shardCount = 16;
+
+        /**
+         * @brief everything that makes a descriptor set layout unique, bindings sorted by binding number
+         *
+         */
+        struct DescriptorSetLayoutKey{
+            /// layout create flags
+            VkDescriptorSetLayoutCreateFlags flags = 0;
+
+            /// bindings, pImmutableSamplers is always null, samplers are in immutableSamplers
+            std::vector<VkDescriptorSetLayoutBinding> bindings;
+
+            /// binding flags in same order as bindings, empty if none were given
+            std::vector<VkDescriptorBindingFlags> bindingFlags;
+
+            /// immutable samplers of each binding, same order as bindings, empty for bindings without any
+            std::vector<std::vector<VkSampler>> immutableSamplers;
+
+            [[nodiscard]] inline bool operator==(const DescriptorSetLayoutKey& other) const{
+                if(flags != other.flags || bindings.size() != other.bindings.size()) return false;
+                for(size_t i = 0; i < bindings.size(); i++){
+                    const auto& a = bindings[i];
+                    const auto& b = other.bindings[i];
+                    if(a.binding != b.binding || a.descriptorType != b.descriptorType ||
+                       a.descriptorCount != b.descriptorCount || a.stageFlags != b.stageFlags) return false;
+                }
+                return bindingFlags == other.bindingFlags && immutableSamplers == other.immutableSamplers;
+            }
+        };
+
+        /**
+         * @brief everything that makes a pipeline layout unique
+         *
+         */
+        struct PipelineLayoutKey{
+            /// set layouts, in set order
+            std::vector<VkDescriptorSetLayout> setLayouts;
+
+            /// push constant ranges
+            std::vector<VkPushConstantRange> pushConstantRanges;
+
+            [[nodiscard]] inline bool operator==(const PipelineLayoutKey& other) const{
+                if(setLayouts != other.setLayouts || pushConstantRanges.size() != other.pushConstantRanges.size()) return false;
+                for(size_t i = 0; i < pushConstantRanges.size(); i++){
+                    const auto& a = pushConstantRanges[i];
+                    const auto& b = other.pushConstantRanges[i];
+                    if(a.stageFlags != b.stageFlags || a.offset != b.offset || a.size != b.size) return false;
+                }
+                return true;
+            }
+        };
+
+        struct DescriptorSetLayoutKeyHash{
+            [[nodiscard]] inline size_t operator()(const DescriptorSetLayoutKey& key) const{
+                size_t seed = 0;
+                HashCombine(seed, key.flags);
+                for(const auto& binding : key.bindings){
+                    HashCombine(seed, binding.binding);
+                    HashCombine(seed, static_cast<uint32>(binding.descriptorType));
+                    HashCombine(seed, binding.descriptorCount);
+                    HashCombine(seed, binding.stageFlags);
+                }
+                for(const auto& flags : key.bindingFlags) HashCombine(seed, flags);
+                // size of each list too, so samplers can't move between bindings without changing hash
+                for(const auto& samplers : key.immutableSamplers){
+                    HashCombine(seed, samplers.size());
+                    for(const auto& sampler : samplers) HashCombine(seed, sampler);
+                }
+                return seed;
+            }
+        };
+
+        struct PipelineLayoutKeyHash{
+            [[nodiscard]] inline size_t operator()(const PipelineLayoutKey& key) const{
+                size_t seed = 0;
+                for(const auto& setLayout : key.setLayouts) HashCombine(seed, setLayout);
+                for(const auto& range : key.pushConstantRanges){
+                    HashCombine(seed, range.stageFlags);
+                    HashCombine(seed, range.offset);
+                    HashCombine(seed, range.size);
+                }
+                return seed;
+            }
+        };
+
+        /**
+         * @brief one locked map
+         *
+         */
+        template<typename Key, typename Handle, typename Hash>
+        struct Shard{
+            std::mutex mutex;
+            std::unordered_map<Key, Handle, Hash> map;
+        };
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// descriptor set layouts
+        std::array<Shard<DescriptorSetLayoutKey, VkDescriptorSetLayout, DescriptorSetLayoutKeyHash>, shardCount> setLayoutShards;
+
+        /// pipeline layouts
+        std::array<Shard<PipelineLayoutKey, VkPipelineLayout, PipelineLayoutKeyHash>, shardCount> pipelineLayoutShards;
+
+        /// number of Get calls
+        std::atomic<uint32> requests = 0;
+
+        /// number of layouts actually created
+        std::atomic<uint32> created = 0;
+
+        /**
+         * @brief initialize cache
+         *
+         * @param device
+         */
+        inline void Init(const VkDevice& device){
+            this->device = device;
+            requests = created = 0;
+        }
+
+        /**
+         * @brief make the key for a descriptor set layout, bindings sorted by binding number
+         *
+         * @param bindings
+         * @param flags layout create flags
+         * @param bindingFlags empty or same size as bindings
+         * @return DescriptorSetLayoutKey
+         */
+        [[nodiscard]] static inline DescriptorSetLayoutKey MakeKey(const Span<VkDescriptorSetLayoutBinding>& bindings, const VkDescriptorSetLayoutCreateFlags& flags, const Span<VkDescriptorBindingFlags>& bindingFlags){
+            // canonical order
+            std::vector<uint32> order(bindings.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](const uint32& a, const uint32& b){ return bindings[a].binding < bindings[b].binding; });
+
+            DescriptorSetLayoutKey key;
+            key.flags = flags;
+            key.bindings.reserve(bindings.size());
+            for(const auto& i : order){
+                VkDescriptorSetLayoutBinding binding = bindings[i];
+                if(binding.pImmutableSamplers != nullptr){
+                    key.immutableSamplers.emplace_back(binding.pImmutableSamplers, binding.pImmutableSamplers + binding.descriptorCount);
+                }else{
+                    key.immutableSamplers.emplace_back();
+                }
+                binding.pImmutableSamplers = nullptr;
+                key.bindings.push_back(binding);
+                if(!bindingFlags.empty()) key.bindingFlags.push_back(bindingFlags[i]);
+            }
+
+            // return
+            return key;
+        }
+
+        /**
+         * @brief get descriptor set layout for bindings, created on first request
+         *
+         * @param bindings eg. made with Init::DescriptorSetLayoutBinding, order doesn't matter
+         * @param flags layout create flags
+         * @param bindingFlags per binding flags (VkDescriptorSetLayoutBindingFlagsCreateInfo), empty or same size as bindings
+         * @return VkDescriptorSetLayout
+         */
+        [[nodiscard]] inline VkDescriptorSetLayout GetDescriptorSetLayout(const Span<VkDescriptorSetLayoutBinding>& bindings, const VkDescriptorSetLayoutCreateFlags& flags = 0, const Span<VkDescriptorBindingFlags>& bindingFlags = {}){
+            ASSERT(bindingFlags.empty() || bindingFlags.size() == bindings.size(), "[LayoutCache] : Binding flags must be given for every binding");
+
+            DescriptorSetLayoutKey key = MakeKey(bindings, flags, bindingFlags);
+
+            requests++;
+            auto& shard = setLayoutShards[DescriptorSetLayoutKeyHash{}(key) % shardCount];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if(it != shard.map.end()) return it->second;
+
+            // create with caller's bindings, they still point to immutable samplers
+            VkDescriptorSetLayoutCreateInfo createInfo = {};
+            createInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            createInfo.flags        = flags;
+            createInfo.bindingCount = bindings.size();
+            createInfo.pBindings    = bindings.data();
+
+            VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = {};
+            if(!bindingFlags.empty()){
+                bindingFlagsInfo.sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+                bindingFlagsInfo.bindingCount   = bindingFlags.size();
+                bindingFlagsInfo.pBindingFlags  = bindingFlags.data();
+                createInfo.pNext                = &bindingFlagsInfo;
+            }
+
+            VkDescriptorSetLayout layout = CreateDescriptorSetLayout(device, createInfo);
+            created++;
+            shard.map.emplace(std::move(key), layout);
+            return layout;
+        }
+
+        /**
+         * @brief get pipeline layout for set layouts and push constants, created on first request
+         *
+         * @param setLayouts in set order, preferably from GetDescriptorSetLayout
+         * @param pushConstantRanges
+         * @return VkPipelineLayout
+         */
+        [[nodiscard]] inline VkPipelineLayout GetPipelineLayout(const Span<VkDescriptorSetLayout>& setLayouts, const Span<VkPushConstantRange>& pushConstantRanges = {}){
+            PipelineLayoutKey key;
+            key.setLayouts.assign(setLayouts.begin(), setLayouts.end());
+            key.pushConstantRanges.assign(pushConstantRanges.begin(), pushConstantRanges.end());
+
+            requests++;
+            auto& shard = pipelineLayoutShards[PipelineLayoutKeyHash{}(key) % shardCount];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if(it != shard.map.end()) return it->second;
+
+            VkPipelineLayoutCreateInfo createInfo = Vulkan::Init::PipelineLayoutCreateInfo();
+            createInfo.setLayoutCount           = setLayouts.size();
+            createInfo.pSetLayouts              = setLayouts.data();
+            createInfo.pushConstantRangeCount   = pushConstantRanges.size();
+            createInfo.pPushConstantRanges      = pushConstantRanges.data();
+
+            VkPipelineLayout layout = CreatePipelineLayout(device, createInfo);
+            created++;
+            shard.map.emplace(std::move(key), layout);
+            return layout;
+        }
+
+        /**
+         * @brief fraction of requests that were served from cache
+         *
+         * @return float : 0 when nothing was shared, close to 1 when most requests were duplicates
+         */
+        [[nodiscard]] inline float DedupeRatio() const{
+            uint32 total = requests;
+            return total ? 1.0f - static_cast<float>(created) / static_cast<float>(total) : 0.0f;
+        }
+
+        /// print number of requests, created layouts and dedupe ratio
+        inline void PrintStats() const{
+            printf("[LayoutCache] : requests = %u | created = %u | dedupe ratio = %.3f\n", requests.load(), created.load(), DedupeRatio());
+        }
+
+        /**
+         * @brief destroy all cached layouts, device must be idle
+         *
+         */
+        inline void Destroy(){
+            for(auto& shard : pipelineLayoutShards){
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for(const auto& [key, layout] : shard.map) DestroyPipelineLayout(device, layout);
+                shard.map.clear();
+            }
+            for(auto& shard : setLayoutShards){
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for(const auto& [key, layout] : shard.map) DestroyDescriptorSetLayout(device, layout);
+                shard.map.clear();
+            }
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_LAYOUT_CACHE_HPP
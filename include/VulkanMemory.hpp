@@ -0,0 +1,439 @@
+/**
+ * @file VulkanMemory.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Device memory sub-allocator. Carves large blocks of device memory into
+ *        smaller allocations so that resources don't each need a vkAllocateMemory call.
+ * @version 0.1
+ * @date 2021-05-02
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_MEMORY_HPP
+#define VULKAN_HELPER_VULKAN_MEMORY_HPP
+
+#include <set>
+#include <mutex>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+#include "VulkanTools.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Buddy allocator that manages offsets inside a single block of memory.
+     *        It never touches Vulkan so it can be used (and checked) without a device.
+     *        Every allocation is rounded up to a power of two and is aligned to its own size,
+     *        so any power of two alignment less than allocation size is satisfied for free.
+     *
+     */
+    struct BuddyAllocator{
+        /// total size of managed block, must be a power of two
+        VkDeviceSize size = 0;
+
+        /// smallest allocation that will be handed out, must be a power of two
+        VkDeviceSize minSize = 0;
+
+        /// number of levels, level 0 is the whole block and last level is minSize
+        uint32 levelCount = 0;
+
+        /// free offsets for each level
+        std::vector<std::set<VkDeviceSize>> freeLists;
+
+        /// level of every live allocation mapped by its offset
+        std::unordered_map<VkDeviceSize, uint32> allocatedLevels;
+
+        /// number of bytes currently handed out (after rounding)
+        VkDeviceSize usedSize = 0;
+
+        /**
+         * @brief initialize allocator for a block
+         *
+         * @param blockSize size of block in bytes, must be a power of two
+         * @param minAllocationSize smallest allocation size in bytes, must be a power of two
+         */
+        inline void Init(const VkDeviceSize& blockSize, const VkDeviceSize& minAllocationSize){
+            ASSERT(IsPowerOfTwo(blockSize) && IsPowerOfTwo(minAllocationSize) && minAllocationSize <= blockSize,
+                "[BuddyAllocator] : block size and minimum allocation size must be powers of two");
+
+            size = blockSize;
+            minSize = minAllocationSize;
+
+            // count levels
+            levelCount = 1;
+            for(VkDeviceSize s = size; s > minSize; s >>= 1) levelCount++;
+
+            // whole block is free at start
+            freeLists.assign(levelCount, std::set<VkDeviceSize>());
+            freeLists[0].insert(0);
+            allocatedLevels.clear();
+            usedSize = 0;
+        }
+
+        /**
+         * @brief allocate a range from block
+         *
+         * @param allocationSize requested size in bytes
+         * @return std::optional<VkDeviceSize> : offset of allocation, no value when block is full
+         */
+        [[nodiscard]] inline std::optional<VkDeviceSize> Allocate(const VkDeviceSize& allocationSize){
+            // this block can never fit it
+            if(allocationSize > size) return std::nullopt;
+
+            // find level whose size fits the request
+            uint32 level = levelCount - 1;
+            VkDeviceSize levelSize = minSize;
+            while(levelSize < allocationSize){
+                levelSize <<= 1;
+                level--;
+            }
+
+            // find a free range at this level or split a larger one
+            int32_t freeLevel = static_cast<int32_t>(level);
+            while(freeLevel >= 0 && freeLists[freeLevel].empty()) freeLevel--;
+            if(freeLevel < 0) return std::nullopt;
+
+            // take lowest offset, this keeps allocations packed at start of block
+            VkDeviceSize offset = *freeLists[freeLevel].begin();
+            freeLists[freeLevel].erase(freeLists[freeLevel].begin());
+
+            // split until we reach required level, upper halves go to free lists
+            for(uint32 l = static_cast<uint32>(freeLevel); l < level; l++){
+                freeLists[l + 1].insert(offset + (size >> (l + 1)));
+            }
+
+            allocatedLevels[offset] = level;
+            usedSize += levelSize;
+            return offset;
+        }
+
+        /**
+         * @brief free a previously allocated range and merge it with its buddies
+         *
+         * @param offset returned by Allocate
+         */
+        inline void Free(VkDeviceSize offset){
+            auto it = allocatedLevels.find(offset);
+            ASSERT(it != allocatedLevels.end(), "[BuddyAllocator] : Freeing offset %" PRIu64 " that was never allocated", static_cast<uint64>(offset));
+
+            uint32 level = it->second;
+            allocatedLevels.erase(it);
+            usedSize -= size >> level;
+
+            // merge with buddy as long as buddy is free too
+            while(level > 0){
+                VkDeviceSize buddy = offset ^ (size >> level);
+                if(freeLists[level].erase(buddy) == 0) break;
+                offset = std::min(offset, buddy);
+                level--;
+            }
+
+            freeLists[level].insert(offset);
+        }
+
+        /// true when nothing is allocated from this block
+        [[nodiscard]] inline bool Empty() const{
+            return allocatedLevels.empty();
+        }
+
+        /// check if a value is a power of two
+        [[nodiscard]] static inline bool IsPowerOfTwo(const VkDeviceSize& value){
+            return value != 0 && (value & (value - 1)) == 0;
+        }
+    };
+
+    /**
+     * @brief Device memory allocator.
+     *        Keeps a list of large blocks for every memory type and sub-allocates
+     *        resources from them using a BuddyAllocator. Requests larger than half a block
+     *        get their own dedicated allocation. Host visible blocks are persistently mapped.
+     *        Linear (buffers) and optimal (images) resources are kept in separate blocks
+     *        so bufferImageGranularity never has to be considered.
+     *
+     */
+    struct Memory{
+        /**
+         * @brief a sub-allocation, i.e. a handle + offset pair
+         *
+         */
+        struct Allocation{
+            /// device memory the allocation lives in
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+
+            /// offset of allocation inside memory
+            VkDeviceSize offset = 0;
+
+            /// requested size of allocation
+            VkDeviceSize size = 0;
+
+            /// host pointer to start of allocation, nullptr when memory is not host visible
+            void* mapped = nullptr;
+
+            /// memory type index of memory
+            uint32 memoryTypeIndex = 0;
+
+            /// allocation is for a linear resource (buffer) or not (image)
+            bool linear = true;
+
+            /// allocation owns the whole device memory
+            bool dedicated = false;
+        };
+
+        /**
+         * @brief one vkAllocateMemory call that is split into many allocations
+         *
+         */
+        struct Block{
+            /// device memory of this block
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+
+            /// host pointer if block is host visible
+            void* mapped = nullptr;
+
+            /// manages offsets inside this block
+            BuddyAllocator allocator;
+        };
+
+        /// device to allocate from
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// memory properties used to select memory types
+        VkPhysicalDeviceMemoryProperties memoryProperties = {};
+
+        /// size of each block, must be a power of two
+        VkDeviceSize blockSize = 64ull * 1024 * 1024;
+
+        /// smallest sub-allocation size, must be a power of two
+        VkDeviceSize minAllocationSize = 256;
+
+        /// blocks for each memory type, index is memoryTypeIndex * 2 + (linear ? 0 : 1)
+        std::vector<std::unique_ptr<Block>> blocks[VK_MAX_MEMORY_TYPES * 2];
+
+        /// number of live vkAllocateMemory allocations (blocks + dedicated)
+        uint32 deviceAllocationCount = 0;
+
+        /// number of live allocations handed out
+        uint32 allocationCount = 0;
+
+        /// allocator can be used from multiple threads
+        std::mutex mutex;
+
+        /**
+         * @brief initialize memory allocator using given memory properties.
+         *        memory properties don't need to come from a real device.
+         *
+         * @param device
+         * @param properties memory properties to select memory types from
+         */
+        inline void Init(const VkDevice& device, const VkPhysicalDeviceMemoryProperties& properties){
+            ASSERT(BuddyAllocator::IsPowerOfTwo(blockSize) && BuddyAllocator::IsPowerOfTwo(minAllocationSize),
+                "[Memory] : blockSize and minAllocationSize must be powers of two");
+            this->device = device;
+            memoryProperties = properties;
+        }
+
+        /**
+         * @brief initialize memory allocator for given physical device
+         *
+         * @param physicalDevice
+         * @param device
+         */
+        inline void Init(const VkPhysicalDevice& physicalDevice, const VkDevice& device){
+            Init(device, GetPhysicalDeviceMemoryProperties(physicalDevice));
+        }
+
+        /**
+         * @brief allocate memory satisfying given requirements
+         *
+         * @param requirements memory requirements of resource
+         * @param propertyFlags required memory properties
+         * @param linear true for buffers and linear images, false for optimal images
+         * @return Allocation
+         */
+        [[nodiscard]] inline Allocation Allocate(const VkMemoryRequirements& requirements, const VkMemoryPropertyFlags& propertyFlags, bool linear = true){
+            // select memory type
+            std::optional<uint32> memoryTypeIndex = Tools::FindMemoryTypeIndex(memoryProperties, requirements.memoryTypeBits, propertyFlags);
+            ASSERT(memoryTypeIndex.has_value(), "[Memory] : No memory type found for requested memory properties");
+
+            // buddy allocations are aligned to their size
+            VkDeviceSize allocationSize = std::max(requirements.size, requirements.alignment);
+
+            Allocation allocation;
+            allocation.size             = requirements.size;
+            allocation.memoryTypeIndex  = memoryTypeIndex.value();
+            allocation.linear           = linear;
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            // large resources get their own memory
+            if(allocationSize > blockSize / 2){
+                allocation.memory       = AllocateMemory(device, Vulkan::Init::MemoryAllocateInfo(requirements.size, allocation.memoryTypeIndex));
+                allocation.offset       = 0;
+                allocation.mapped       = IsHostVisible(allocation.memoryTypeIndex) ? MapMemory(device, allocation.memory) : nullptr;
+                allocation.dedicated    = true;
+                deviceAllocationCount++;
+                allocationCount++;
+                return allocation;
+            }
+
+            // try existing blocks first
+            auto& pool = blocks[PoolIndex(allocation.memoryTypeIndex, linear)];
+            for(auto& block : pool){
+                std::optional<VkDeviceSize> offset = block->allocator.Allocate(allocationSize);
+                if(offset.has_value()){
+                    SetFromBlock(allocation, *block, offset.value());
+                    return allocation;
+                }
+            }
+
+            // all blocks are full, create a new one
+            pool.push_back(CreateBlock(allocation.memoryTypeIndex));
+            std::optional<VkDeviceSize> offset = pool.back()->allocator.Allocate(allocationSize);
+            ASSERT(offset.has_value(), "[Memory] : Failed to allocate %" PRIu64 " bytes from a new block", static_cast<uint64>(allocationSize));
+            SetFromBlock(allocation, *pool.back(), offset.value());
+            return allocation;
+        }
+
+        /**
+         * @brief free an allocation. Empty blocks are released except the last one of a pool.
+         *
+         * @param allocation
+         */
+        inline void Free(Allocation& allocation){
+            // nothing to free
+            if(allocation.memory == VK_NULL_HANDLE) return;
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if(allocation.dedicated){
+                if(allocation.mapped) UnmapMemory(device, allocation.memory);
+                FreeMemory(device, allocation.memory);
+                deviceAllocationCount--;
+            }else{
+                // find the block this allocation came from
+                auto& pool = blocks[PoolIndex(allocation.memoryTypeIndex, allocation.linear)];
+                auto it = std::find_if(pool.begin(), pool.end(), [&](const std::unique_ptr<Block>& block){
+                    return block->memory == allocation.memory;
+                });
+                ASSERT(it != pool.end(), "[Memory] : Freeing an allocation that doesn't belong to this allocator");
+
+                (*it)->allocator.Free(allocation.offset);
+
+                // keep one empty block around to avoid allocating again and again
+                if((*it)->allocator.Empty() && pool.size() > 1){
+                    DestroyBlock(**it);
+                    pool.erase(it);
+                }
+            }
+
+            allocationCount--;
+            allocation = Allocation();
+        }
+
+        /**
+         * @brief allocate memory for a buffer and bind it
+         *
+         * @param buffer
+         * @param propertyFlags required memory properties
+         * @return Allocation
+         */
+        [[nodiscard]] inline Allocation AllocateBufferMemory(const VkBuffer& buffer, const VkMemoryPropertyFlags& propertyFlags){
+            Allocation allocation = Allocate(GetBufferMemoryRequirements(device, buffer), propertyFlags, true);
+            BindBufferMemory(device, buffer, allocation.memory, allocation.offset);
+            return allocation;
+        }
+
+        /**
+         * @brief allocate memory for an image and bind it
+         *
+         * @param image
+         * @param propertyFlags required memory properties
+         * @param linear true only if image was created with VK_IMAGE_TILING_LINEAR
+         * @return Allocation
+         */
+        [[nodiscard]] inline Allocation AllocateImageMemory(const VkImage& image, const VkMemoryPropertyFlags& propertyFlags, bool linear = false){
+            Allocation allocation = Allocate(GetImageMemoryRequirements(device, image), propertyFlags, linear);
+            BindImageMemory(device, image, allocation.memory, allocation.offset);
+            return allocation;
+        }
+
+        /**
+         * @brief free all blocks.
+         *
+         * @warning all allocations must be freed (or no longer used) before calling this
+         *
+         */
+        inline void Destroy(){
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for(auto& pool : blocks){
+                for(auto& block : pool){
+                    DestroyBlock(*block);
+                }
+                pool.clear();
+            }
+        }
+
+    private:
+        /// index of pool in blocks
+        [[nodiscard]] static inline uint32 PoolIndex(const uint32& memoryTypeIndex, bool linear){
+            return memoryTypeIndex * 2 + (linear ? 0 : 1);
+        }
+
+        /// check if memory type is host visible
+        [[nodiscard]] inline bool IsHostVisible(const uint32& memoryTypeIndex) const{
+            return memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        }
+
+        /// fill allocation from a block sub-allocation
+        inline void SetFromBlock(Allocation& allocation, const Block& block, const VkDeviceSize& offset){
+            allocation.memory   = block.memory;
+            allocation.offset   = offset;
+            allocation.mapped   = block.mapped ? static_cast<uint8*>(block.mapped) + offset : nullptr;
+            allocationCount++;
+        }
+
+        /// allocate a new block from given memory type
+        [[nodiscard]] inline std::unique_ptr<Block> CreateBlock(const uint32& memoryTypeIndex){
+            auto block = std::make_unique<Block>();
+            block->memory = AllocateMemory(device, Vulkan::Init::MemoryAllocateInfo(blockSize, memoryTypeIndex));
+            block->mapped = IsHostVisible(memoryTypeIndex) ? MapMemory(device, block->memory) : nullptr;
+            block->allocator.Init(blockSize, minAllocationSize);
+            deviceAllocationCount++;
+            return block;
+        }
+
+        /// release memory of a block
+        inline void DestroyBlock(Block& block){
+            if(block.mapped) UnmapMemory(device, block.memory);
+            FreeMemory(device, block.memory);
+            block.memory = VK_NULL_HANDLE;
+            block.mapped = nullptr;
+            deviceAllocationCount--;
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_MEMORY_HPP
@@ -0,0 +1,309 @@
+/**
+ * @file VulkanPipelineCache.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Disk persistent pipeline cache. Loads, validates, merges and saves VkPipelineCache data.
+ * @version 0.1
+ * @date 2021-05-06
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_PIPELINE_CACHE_HPP
+#define VULKAN_HELPER_VULKAN_PIPELINE_CACHE_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+#include "VulkanTools.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Pipeline cache that lives on disk between runs.
+     *        On Init the cache file is mapped and its header is checked against the
+     *        physical device, a stale or foreign cache is simply ignored.
+     *        Pipelines created through this struct are timed and, when
+     *        VK_EXT_pipeline_creation_feedback is enabled, classified as cache hit or miss.
+     *        On Destroy the cache is written to a temporary file and renamed over the
+     *        old one, so a crash never leaves a half written cache behind.
+     *        Creating pipelines, merging and saving can be done from any thread.
+     *
+     */
+    struct PipelineCache{
+        /**
+         * @brief pipeline creation statistics
+         *
+         */
+        struct Stats{
+            /// pipelines that were found in cache
+            uint32 hits = 0;
+
+            /// pipelines that had to be compiled
+            uint32 misses = 0;
+
+            /// pipelines for which driver gave no feedback
+            uint32 unknown = 0;
+
+            /// total time spent creating hit pipelines in milliseconds
+            double hitTime = 0.0;
+
+            /// total time spent creating missed pipelines in milliseconds
+            double missTime = 0.0;
+
+            /// total time spent creating pipelines without feedback in milliseconds
+            double unknownTime = 0.0;
+        };
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// created pipeline cache
+        VkPipelineCache cache = VK_NULL_HANDLE;
+
+        /// file cache is loaded from and saved to
+        std::string filename;
+
+        /// properties of physical device cache is created for
+        VkPhysicalDeviceProperties properties = {};
+
+        /// true if cache was created from data on disk
+        bool loadedFromDisk = false;
+
+        /// set to true if VK_EXT_pipeline_creation_feedback is enabled on device
+        bool creationFeedback = false;
+
+        /// creation statistics
+        Stats stats;
+
+        /// guards statistics
+        std::mutex mutex;
+
+        /// guards cache, shared while creating pipelines or reading data (driver synchronizes those),
+        /// exclusive while merging since the destination of a merge must be externally synchronized
+        std::shared_mutex cacheMutex;
+
+        /**
+         * @brief check if a cache blob was created by given physical device
+         *
+         * @param data cache blob
+         * @param size size of blob in bytes
+         * @param properties of physical device
+         * @return true if blob can be used with this device
+         * @return false otherwise
+         */
+        [[nodiscard]] static inline bool ValidateHeader(const void* data, const size_t& size, const VkPhysicalDeviceProperties& properties){
+            if(data == nullptr || size < sizeof(VkPipelineCacheHeaderVersionOne)) return false;
+
+            // blob may not be aligned for the header struct
+            VkPipelineCacheHeaderVersionOne header;
+            memcpy(&header, data, sizeof(header));
+
+            return header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne) &&
+                header.headerSize <= size &&
+                header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                header.vendorID == properties.vendorID &&
+                header.deviceID == properties.deviceID &&
+                memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        }
+
+        /**
+         * @brief create pipeline cache, loading it from disk if a valid cache file exists
+         *
+         * @param physicalDevice
+         * @param device
+         * @param filename of cache file
+         */
+        inline void Init(const VkPhysicalDevice& physicalDevice, const VkDevice& device, const char* filename){
+            this->device = device;
+            this->filename = filename;
+            properties = GetPhysicalDeviceProperties(physicalDevice);
+
+            // driver copies initial data, so mapping can go away right after creation
+            Tools::MappedFile file;
+            loadedFromDisk = file.Open(filename) && ValidateHeader(file.data, file.size, properties);
+
+            if(loadedFromDisk){
+                cache = CreatePipelineCache(device, Vulkan::Init::PipelineCacheCreateInfo(file.data, file.size));
+                LOG(success, "[PipelineCache] : Loaded %i bytes from %s", static_cast<uint>(file.size), filename);
+            }else{
+                cache = CreatePipelineCache(device, Vulkan::Init::PipelineCacheCreateInfo());
+                LOG(warning, "[PipelineCache] : No valid cache found at %s, starting with empty cache", filename);
+            }
+        }
+
+        /**
+         * @brief merge caches (for example from worker threads) into this cache
+         *
+         * @param srcCaches
+         */
+        inline void Merge(const std::vector<VkPipelineCache>& srcCaches){
+            std::unique_lock<std::shared_mutex> lock(cacheMutex);
+            MergePipelineCaches(device, cache, srcCaches);
+        }
+
+        /**
+         * @brief get current cache data, eg. to seed other caches with
+         *
+         * @return std::vector<uint8>
+         */
+        [[nodiscard]] inline std::vector<uint8> GetData(){
+            std::shared_lock<std::shared_mutex> lock(cacheMutex);
+            return GetPipelineCacheData(device, cache);
+        }
+
+        /**
+         * @brief create a graphics pipeline using this cache and record its statistics
+         *
+         * @param createInfo
+         * @return VkPipeline
+         */
+        [[nodiscard]] inline VkPipeline CreateGraphicsPipeline(const VkGraphicsPipelineCreateInfo& createInfo){
+            return CreateGraphicsPipelines({createInfo})[0];
+        }
+
+        /**
+         * @brief create graphics pipelines using this cache and record their statistics
+         *
+         * @param createInfos
+         * @return std::vector<VkPipeline>
+         */
+        [[nodiscard]] inline std::vector<VkPipeline> CreateGraphicsPipelines(const std::vector<VkGraphicsPipelineCreateInfo>& createInfos){
+            // feedback for each pipeline
+            std::vector<VkPipelineCreationFeedbackEXT> feedbacks(createInfos.size());
+            std::vector<VkPipelineCreationFeedbackCreateInfoEXT> feedbackInfos(createInfos.size());
+
+            // chain feedback structs only when extension is enabled
+            std::vector<VkGraphicsPipelineCreateInfo> infos = createInfos;
+            if(creationFeedback){
+                for(size_t i = 0; i < infos.size(); i++){
+                    feedbackInfos[i] = {};
+                    feedbackInfos[i].sType                      = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+                    feedbackInfos[i].pNext                      = infos[i].pNext;
+                    feedbackInfos[i].pPipelineCreationFeedback  = &feedbacks[i];
+                    infos[i].pNext = &feedbackInfos[i];
+                }
+            }
+
+            // create and time
+            auto start = std::chrono::steady_clock::now();
+            std::vector<VkPipeline> pipelines;
+            {
+                std::shared_lock<std::shared_mutex> cacheLock(cacheMutex);
+                pipelines = Vulkan::CreateGraphicsPipelines(device, cache, infos);
+            }
+            double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            // record statistics
+            std::lock_guard<std::mutex> lock(mutex);
+            for(size_t i = 0; i < infos.size(); i++){
+                const VkPipelineCreationFeedbackEXT& feedback = feedbacks[i];
+                if(creationFeedback && (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT)){
+                    // driver reports duration in nanoseconds
+                    double duration = static_cast<double>(feedback.duration) / 1e6;
+                    if(feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT){
+                        stats.hits++;
+                        stats.hitTime += duration;
+                    }else{
+                        stats.misses++;
+                        stats.missTime += duration;
+                    }
+                }else{
+                    // no per pipeline timing, split batch time evenly
+                    stats.unknown++;
+                    stats.unknownTime += time / static_cast<double>(infos.size());
+                }
+            }
+
+            return pipelines;
+        }
+
+        /// print creation statistics
+        inline void PrintStats(){
+            std::lock_guard<std::mutex> lock(mutex);
+            printf("[PipelineCache] : hits = %u (%.3f ms) | misses = %u (%.3f ms) | unknown = %u (%.3f ms)\n",
+                stats.hits, stats.hitTime, stats.misses, stats.missTime, stats.unknown, stats.unknownTime);
+        }
+
+        /**
+         * @brief write cache to disk. Data is written to a temporary file first
+         *        which is then renamed over the cache file.
+         *
+         * @return true if cache was saved
+         * @return false otherwise
+         */
+        inline bool Save(){
+            std::vector<uint8> data = GetData();
+            if(data.empty()) return false;
+
+            std::string tmpFilename = filename + ".tmp";
+            FILE* file = fopen(tmpFilename.c_str(), "wb");
+            if(file == nullptr){
+                LOG(error, "[PipelineCache] : Failed to open %s for writing", tmpFilename.c_str());
+                return false;
+            }
+
+            bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+            written = (fflush(file) == 0) && written;
+        #ifdef VULKAN_HELPER_MAPPED_FILE_USE_MMAP
+            // make sure data hits the disk before rename makes it visible
+            written = (fsync(fileno(file)) == 0) && written;
+        #endif
+            fclose(file);
+
+            if(!written){
+                LOG(error, "[PipelineCache] : Failed to write %s", tmpFilename.c_str());
+                std::remove(tmpFilename.c_str());
+                return false;
+            }
+
+        #ifndef VULKAN_HELPER_MAPPED_FILE_USE_MMAP
+            // rename doesn't replace existing files here
+            std::remove(filename.c_str());
+        #endif
+            if(std::rename(tmpFilename.c_str(), filename.c_str()) != 0){
+                LOG(error, "[PipelineCache] : Failed to rename %s to %s", tmpFilename.c_str(), filename.c_str());
+                std::remove(tmpFilename.c_str());
+                return false;
+            }
+
+            LOG(success, "[PipelineCache] : Saved %i bytes to %s", static_cast<uint>(data.size()), filename.c_str());
+            return true;
+        }
+
+        /**
+         * @brief save cache (optionally) and destroy it
+         *
+         * @param save write cache to disk before destroying
+         */
+        inline void Destroy(bool save = true){
+            if(save) Save();
+            DestroyPipelineCache(device, cache);
+            cache = VK_NULL_HANDLE;
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_PIPELINE_CACHE_HPP
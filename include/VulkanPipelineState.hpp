@@ -0,0 +1,498 @@
+/**
+ * @file VulkanPipelineState.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Hashable graphics pipeline state and a registry that dedupes and lazily builds pipelines.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_PIPELINE_STATE_HPP
+#define VULKAN_HELPER_VULKAN_PIPELINE_STATE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+#include "VulkanPipelineCache.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Everything needed to create a graphics pipeline, stored by value.
+     *        Two states that compare equal create identical pipelines, so states can be
+     *        hashed and used as keys. Create infos are only assembled inside Create,
+     *        so nothing ever points into a temporary.
+     *
+     *        Viewport and scissor are always dynamic, so render target size doesn't
+     *        split otherwise identical pipelines. Entry point of every stage is "main".
+     *
+     */
+    struct GraphicsPipelineState{
+        /// a shader stage
+        struct ShaderStage{
+            VkShaderStageFlagBits stage = VK_SHADER_STAGE_VERTEX_BIT;
+            VkShaderModule module = VK_NULL_HANDLE;
+        };
+
+        /// shader stages
+        std::vector<ShaderStage> stages;
+
+        /// vertex buffer bindings
+        std::vector<VkVertexInputBindingDescription> vertexBindings;
+
+        /// vertex attributes
+        std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+
+        /// input assembly
+        VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        VkBool32 primitiveRestart = VK_FALSE;
+
+        /// rasterization, depth bias values are dynamic when depth bias is enabled
+        VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+        VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+        VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE;
+        VkBool32 depthClamp = VK_FALSE;
+        VkBool32 depthBias = VK_FALSE;
+
+        /// multisampling
+        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+
+        /// depth and stencil
+        VkBool32 depthTest = VK_FALSE;
+        VkBool32 depthWrite = VK_FALSE;
+        VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+        VkBool32 stencilTest = VK_FALSE;
+        VkStencilOpState stencilFront = {};
+        VkStencilOpState stencilBack = {};
+
+        /// one blend state per color attachment
+        std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments = {Init::PipelineColorBlendAttachmentState()};
+
+        /// dynamic states besides viewport and scissor
+        std::vector<VkDynamicState> dynamicStates;
+
+        /// layout and render pass
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        uint32 subpass = 0;
+
+        /**
+         * @brief add a shader stage
+         *
+         * @param stage
+         * @param module
+         * @return GraphicsPipelineState& this, for chaining
+         */
+        inline GraphicsPipelineState& AddShader(const VkShaderStageFlagBits& stage, const VkShaderModule& module){
+            stages.push_back(ShaderStage{stage, module});
+            return *this;
+        }
+
+        /**
+         * @brief set vertex input
+         *
+         * @param bindings vertex buffer bindings
+         * @param attributes eg. from PipelineReflection::GetVertexAttributes
+         * @return GraphicsPipelineState& this, for chaining
+         */
+        inline GraphicsPipelineState& SetVertexInput(const Span<VkVertexInputBindingDescription>& bindings, const Span<VkVertexInputAttributeDescription>& attributes){
+            vertexBindings.assign(bindings.begin(), bindings.end());
+            vertexAttributes.assign(attributes.begin(), attributes.end());
+            return *this;
+        }
+
+        /**
+         * @brief set rasterization state
+         *
+         * @param polygonMode
+         * @param cullMode
+         * @param frontFace
+         * @return GraphicsPipelineState& this, for chaining
+         */
+        inline GraphicsPipelineState& SetRasterization(const VkPolygonMode& polygonMode, const VkCullModeFlags& cullMode, const VkFrontFace& frontFace = VK_FRONT_FACE_CLOCKWISE){
+            this->polygonMode = polygonMode;
+            this->cullMode = cullMode;
+            this->frontFace = frontFace;
+            return *this;
+        }
+
+        /**
+         * @brief set depth test
+         *
+         * @param test enable depth test
+         * @param write enable depth writes
+         * @param compareOp
+         * @return GraphicsPipelineState& this, for chaining
+         */
+        inline GraphicsPipelineState& SetDepth(const bool& test, const bool& write, const VkCompareOp& compareOp = VK_COMPARE_OP_LESS_OR_EQUAL){
+            depthTest = test ? VK_TRUE : VK_FALSE;
+            depthWrite = write ? VK_TRUE : VK_FALSE;
+            depthCompareOp = compareOp;
+            return *this;
+        }
+
+        /**
+         * @brief use same blend state for a number of color attachments
+         *
+         * @param count number of color attachments
+         * @param blendState
+         * @return GraphicsPipelineState& this, for chaining
+         */
+        inline GraphicsPipelineState& SetColorAttachments(const uint32& count, const VkPipelineColorBlendAttachmentState& blendState = Init::PipelineColorBlendAttachmentState()){
+            colorBlendAttachments.assign(count, blendState);
+            return *this;
+        }
+
+        /**
+         * @brief set layout and render pass
+         *
+         * @param layout
+         * @param renderPass
+         * @param subpass
+         * @return GraphicsPipelineState& this, for chaining
+         */
+        inline GraphicsPipelineState& SetRenderPass(const VkPipelineLayout& layout, const VkRenderPass& renderPass, const uint32& subpass = 0){
+            this->layout = layout;
+            this->renderPass = renderPass;
+            this->subpass = subpass;
+            return *this;
+        }
+
+        /// compare states field by field
+        [[nodiscard]] inline bool operator==(const GraphicsPipelineState& other) const{
+            return stages.size() == other.stages.size() &&
+                std::equal(stages.begin(), stages.end(), other.stages.begin(), [](const ShaderStage& a, const ShaderStage& b){
+                    return a.stage == b.stage && a.module == b.module;
+                }) &&
+                SameBytes(vertexBindings, other.vertexBindings) &&
+                SameBytes(vertexAttributes, other.vertexAttributes) &&
+                topology == other.topology && primitiveRestart == other.primitiveRestart &&
+                polygonMode == other.polygonMode && cullMode == other.cullMode && frontFace == other.frontFace &&
+                depthClamp == other.depthClamp && depthBias == other.depthBias &&
+                samples == other.samples &&
+                depthTest == other.depthTest && depthWrite == other.depthWrite && depthCompareOp == other.depthCompareOp &&
+                stencilTest == other.stencilTest &&
+                memcmp(&stencilFront, &other.stencilFront, sizeof(VkStencilOpState)) == 0 &&
+                memcmp(&stencilBack, &other.stencilBack, sizeof(VkStencilOpState)) == 0 &&
+                SameBytes(colorBlendAttachments, other.colorBlendAttachments) &&
+                dynamicStates == other.dynamicStates &&
+                layout == other.layout && renderPass == other.renderPass && subpass == other.subpass;
+        }
+
+        [[nodiscard]] inline bool operator!=(const GraphicsPipelineState& other) const{
+            return !(*this == other);
+        }
+
+        /**
+         * @brief hash of every field, equal states have equal hashes
+         *
+         * @return size_t
+         */
+        [[nodiscard]] inline size_t Hash() const{
+            uint64 hash = 0;
+            for(const auto& stage : stages){
+                hash = HashBytes(&stage.stage, sizeof(stage.stage), hash);
+                hash = HashBytes(&stage.module, sizeof(stage.module), hash);
+            }
+            hash = HashVector(vertexBindings, hash);
+            hash = HashVector(vertexAttributes, hash);
+
+            // fixed function state is all 32 bit values, hash it as one block
+            const uint32 fixed[] = {
+                static_cast<uint32>(topology), primitiveRestart,
+                static_cast<uint32>(polygonMode), cullMode, static_cast<uint32>(frontFace), depthClamp, depthBias,
+                static_cast<uint32>(samples),
+                depthTest, depthWrite, static_cast<uint32>(depthCompareOp), stencilTest,
+                subpass
+            };
+            hash = HashBytes(fixed, sizeof(fixed), hash);
+            hash = HashBytes(&stencilFront, sizeof(VkStencilOpState), hash);
+            hash = HashBytes(&stencilBack, sizeof(VkStencilOpState), hash);
+            hash = HashVector(colorBlendAttachments, hash);
+            hash = HashVector(dynamicStates, hash);
+            hash = HashBytes(&layout, sizeof(layout), hash);
+            hash = HashBytes(&renderPass, sizeof(renderPass), hash);
+
+            // return
+            return static_cast<size_t>(hash);
+        }
+
+        /**
+         * @brief create pipeline from state
+         *
+         * @param device
+         * @param pipelineCache optional
+         * @return VkPipeline
+         */
+        [[nodiscard]] inline VkPipeline Create(const VkDevice& device, const VkPipelineCache& pipelineCache = VK_NULL_HANDLE) const{
+            return WithCreateInfo([&](const VkGraphicsPipelineCreateInfo& createInfo){
+                return CreateGraphicsPipeline(device, pipelineCache, createInfo);
+            });
+        }
+
+        /**
+         * @brief create pipeline from state through a disk backed pipeline cache
+         *
+         * @param pipelineCache
+         * @return VkPipeline
+         */
+        [[nodiscard]] inline VkPipeline Create(PipelineCache& pipelineCache) const{
+            return WithCreateInfo([&](const VkGraphicsPipelineCreateInfo& createInfo){
+                return pipelineCache.CreateGraphicsPipeline(createInfo);
+            });
+        }
+
+    private:
+        /// compare vectors of plain vulkan structs without padding
+        template<typename T>
+        [[nodiscard]] static inline bool SameBytes(const std::vector<T>& a, const std::vector<T>& b){
+            return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+        }
+
+        /// hash a vector of plain vulkan structs, including its size
+        template<typename T>
+        [[nodiscard]] static inline uint64 HashVector(const std::vector<T>& vector, const uint64& seed){
+            uint64 size = vector.size();
+            uint64 hash = HashBytes(&size, sizeof(size), seed);
+            return vector.empty() ? hash : HashBytes(vector.data(), vector.size() * sizeof(T), hash);
+        }
+
+        /// assemble create info on stack and pass it to create
+        template<typename CreateFunction>
+        [[nodiscard]] inline VkPipeline WithCreateInfo(CreateFunction&& create) const{
+            ASSERT(layout != VK_NULL_HANDLE && renderPass != VK_NULL_HANDLE, "[GraphicsPipelineState] : Layout and render pass must be set");
+
+            std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+            shaderStages.reserve(stages.size());
+            for(const auto& stage : stages) shaderStages.push_back(Init::PipelineShaderStageCreateInfo(stage.stage, stage.module));
+
+            VkPipelineVertexInputStateCreateInfo vertexInput = Init::PipelineVertexInputStateCreateInfo();
+            vertexInput.vertexBindingDescriptionCount   = vertexBindings.size();
+            vertexInput.pVertexBindingDescriptions      = vertexBindings.data();
+            vertexInput.vertexAttributeDescriptionCount = vertexAttributes.size();
+            vertexInput.pVertexAttributeDescriptions    = vertexAttributes.data();
+
+            VkPipelineInputAssemblyStateCreateInfo inputAssembly = Init::PipelineInputAssemblyStateCreateInfo(topology);
+            inputAssembly.primitiveRestartEnable = primitiveRestart;
+
+            // one viewport and scissor, both set in command buffer
+            VkPipelineViewportStateCreateInfo viewport = Init::PipelineViewportStateCreateInfo({}, {});
+            viewport.viewportCount = 1;
+            viewport.scissorCount = 1;
+
+            VkPipelineRasterizationStateCreateInfo rasterization = Init::PipelineRasterizationStateCreateInfo(polygonMode);
+            rasterization.cullMode          = cullMode;
+            rasterization.frontFace         = frontFace;
+            rasterization.depthClampEnable  = depthClamp;
+            rasterization.depthBiasEnable   = depthBias;
+
+            VkPipelineMultisampleStateCreateInfo multisample = Init::PipelineMultisampleStateCreateInfo();
+            multisample.rasterizationSamples = samples;
+
+            VkPipelineDepthStencilStateCreateInfo depthStencil = Init::PipelineDepthStencilStateCreateInfo(depthTest, depthWrite, depthCompareOp);
+            depthStencil.stencilTestEnable  = stencilTest;
+            depthStencil.front              = stencilFront;
+            depthStencil.back               = stencilBack;
+
+            VkPipelineColorBlendStateCreateInfo colorBlend = Init::PipelineColorBlendStateCreateInfo(colorBlendAttachments);
+
+            std::vector<VkDynamicState> allDynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+            if(depthBias) allDynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_BIAS);
+            allDynamicStates.insert(allDynamicStates.end(), dynamicStates.begin(), dynamicStates.end());
+            VkPipelineDynamicStateCreateInfo dynamic = Init::PipelineDynamicStateCreateInfo(allDynamicStates);
+
+            VkGraphicsPipelineCreateInfo createInfo = Init::GraphicsPipelineCreateInfo();
+            createInfo.stageCount           = shaderStages.size();
+            createInfo.pStages              = shaderStages.data();
+            createInfo.pVertexInputState    = &vertexInput;
+            createInfo.pInputAssemblyState  = &inputAssembly;
+            createInfo.pViewportState       = &viewport;
+            createInfo.pRasterizationState  = &rasterization;
+            createInfo.pMultisampleState    = &multisample;
+            createInfo.pDepthStencilState   = &depthStencil;
+            createInfo.pColorBlendState     = &colorBlend;
+            createInfo.pDynamicState        = &dynamic;
+            createInfo.layout               = layout;
+            createInfo.renderPass           = renderPass;
+            createInfo.subpass              = subpass;
+
+            // return
+            return create(createInfo);
+        }
+    };
+
+    /// hasher for using GraphicsPipelineState as a key
+    struct GraphicsPipelineStateHash{
+        inline size_t operator()(const GraphicsPipelineState& state) const{
+            return state.Hash();
+        }
+    };
+
+    /**
+     * @brief Registry of graphics pipelines keyed by their state.
+     *        Registering a state that is already known gives back the existing handle,
+     *        so identical materials share one VkPipeline. A pipeline is created on the
+     *        first Get of its handle, so states that are never drawn cost nothing.
+     *
+     *        Shader modules of a registered state must stay alive until its pipeline
+     *        has been built. Thread safe, concurrent first Gets of one handle build it once.
+     *
+     */
+    struct PipelineRegistry{
+        /// identifies a registered state
+        using Handle = uint32;
+
+        /// registered state and its pipeline once built
+        struct Entry{
+            GraphicsPipelineState state;
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            std::once_flag built;
+        };
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// optional disk backed cache pipelines are created with
+        PipelineCache* pipelineCache = nullptr;
+
+        /// handles by state
+        std::unordered_map<GraphicsPipelineState, Handle, GraphicsPipelineStateHash> handles;
+
+        /// entries by handle, deque so entries never move
+        std::deque<Entry> entries;
+
+        /// guards handles and entries
+        std::mutex mutex;
+
+        /// number of Register calls
+        std::atomic<uint32> requests = 0;
+
+        /// number of pipelines actually created
+        std::atomic<uint32> created = 0;
+
+        /**
+         * @brief initialize registry
+         *
+         * @param device
+         * @param pipelineCache optional, pipelines are created through it when given
+         */
+        inline void Init(const VkDevice& device, PipelineCache* pipelineCache = nullptr){
+            this->device = device;
+            this->pipelineCache = pipelineCache;
+            requests = created = 0;
+        }
+
+        /**
+         * @brief register a state without building its pipeline
+         *
+         * @param state
+         * @return Handle same handle for equal states
+         */
+        [[nodiscard]] inline Handle Register(const GraphicsPipelineState& state){
+            requests++;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = handles.find(state);
+            if(it != handles.end()) return it->second;
+
+            Handle handle = static_cast<Handle>(entries.size());
+            entries.emplace_back().state = state;
+            handles.emplace(state, handle);
+            return handle;
+        }
+
+        /**
+         * @brief get pipeline of a registered state, building it on first use
+         *
+         * @param handle from Register
+         * @return VkPipeline
+         */
+        [[nodiscard]] inline VkPipeline Get(const Handle& handle){
+            Entry* entry;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ASSERT(handle < entries.size(), "[PipelineRegistry] : Invalid handle %u", handle);
+                entry = &entries[handle];
+            }
+
+            // build outside of lock so other pipelines can be built meanwhile
+            std::call_once(entry->built, [&](){
+                entry->pipeline = pipelineCache ? entry->state.Create(*pipelineCache) : entry->state.Create(device);
+                created++;
+            });
+
+            // return
+            return entry->pipeline;
+        }
+
+        /**
+         * @brief register a state and get its pipeline
+         *
+         * @param state
+         * @return VkPipeline
+         */
+        [[nodiscard]] inline VkPipeline Get(const GraphicsPipelineState& state){
+            return Get(Register(state));
+        }
+
+        /**
+         * @brief fraction of Register calls that found an existing state
+         *
+         * @return float between 0 and 1
+         */
+        [[nodiscard]] inline float DedupeRatio(){
+            uint32 total = requests;
+            std::lock_guard<std::mutex> lock(mutex);
+            return total ? 1.0f - static_cast<float>(entries.size()) / static_cast<float>(total) : 0.0f;
+        }
+
+        /// print number of requests, unique states, built pipelines and dedupe ratio
+        inline void PrintStats(){
+            uint32 unique;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                unique = static_cast<uint32>(entries.size());
+            }
+            printf("[PipelineRegistry] : requests = %u | unique = %u | built = %u | dedupe ratio = %.3f\n", requests.load(), unique, created.load(), DedupeRatio());
+        }
+
+        /**
+         * @brief destroy all built pipelines, device must be idle
+         *
+         */
+        inline void Destroy(){
+            std::lock_guard<std::mutex> lock(mutex);
+            for(const auto& entry : entries){
+                if(entry.pipeline != VK_NULL_HANDLE) DestroyPipeline(device, entry.pipeline);
+            }
+            entries.clear();
+            handles.clear();
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_PIPELINE_STATE_HPP
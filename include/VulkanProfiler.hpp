@@ -0,0 +1,402 @@
+/**
+ * @file VulkanProfiler.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief GPU timestamp profiler with CPU zones and Chrome trace export.
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_PROFILER_HPP
+#define VULKAN_HELPER_VULKAN_PROFILER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Measures GPU time of passes with timestamp queries and CPU time of scopes
+     *        with a steady clock, and writes both to a Chrome trace (chrome://tracing, Perfetto).
+     *        Every frame in flight owns a query pool. Results of a pool are read back when
+     *        its frame slot comes around again, after its fence was waited for, so reading
+     *        never stalls the CPU. Results are therefore framesInFlight frames late.
+     *
+     *        GPU zones must be recorded from one thread. CPU zones are thread safe.
+     *        Zone names are not copied and must outlive the profiler (string literals).
+     *
+     *        Usage every frame :
+     *          // after waiting for the fence of this frame, outside any render pass
+     *          profiler.BeginFrame(cmd, frameIdx);
+     *          {
+     *              Vulkan::Profiler::GpuScope zone(profiler, cmd, "Shadow pass");
+     *              ...
+     *          }
+     *
+     */
+    struct Profiler{
+        /// thread id GPU zones are shown on in trace
+        static constexpr uint32 gpuThreadId = 0;
+
+        /// returned by Begin when a frame has no queries left
+        static constexpr uint32 invalidZone = UINT32_MAX;
+
+        /**
+         * @brief a zone in trace, times are in microseconds since profiler creation
+         *
+         */
+        struct TraceEvent{
+            /// name of zone
+            const char* name;
+
+            /// start time
+            double start;
+
+            /// duration
+            double duration;
+
+            /// thread zone ran on, gpuThreadId for GPU zones
+            uint32 threadId;
+        };
+
+        /**
+         * @brief resolved GPU zone of a frame
+         *
+         */
+        struct ZoneResult{
+            /// name of zone
+            const char* name;
+
+            /// start in milliseconds, relative to first zone of frame
+            double start;
+
+            /// duration in milliseconds
+            double duration;
+        };
+
+        /**
+         * @brief queries of one frame in flight
+         *
+         */
+        struct FrameQueries{
+            /// pool with two timestamps per zone
+            VkQueryPool pool = VK_NULL_HANDLE;
+
+            /// names of zones begun this frame, zone i uses queries 2i and 2i + 1
+            std::vector<const char*> names;
+
+            /// CPU time frame was begun at, in microseconds
+            double cpuBeginTime = 0;
+
+            /// frame has timestamps that are not read back yet
+            bool pending = false;
+        };
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// nanoseconds per timestamp tick
+        double timestampPeriod = 1;
+
+        /// valid bits of timestamps written on queue
+        uint64 timestampMask = UINT64_MAX;
+
+        /// maximum number of GPU zones in one frame
+        uint32 maxZonesPerFrame = 0;
+
+        /// query pools, one per frame in flight
+        std::vector<FrameQueries> frames;
+
+        /// frame being recorded
+        uint32 frameIdx = 0;
+
+        /// GPU zones of latest resolved frame
+        std::vector<ZoneResult> lastFrameZones;
+
+        /// collect trace events when true
+        bool tracing = false;
+
+        /// collected trace events
+        std::vector<TraceEvent> events;
+
+        /// time all trace events are relative to
+        std::chrono::steady_clock::time_point epoch;
+
+        /// added to GPU time to move it to CPU time, in microseconds
+        double gpuTimeOffset = 0;
+
+        /// gpuTimeOffset was calculated
+        bool gpuTimeOffsetValid = false;
+
+        /// small ids for CPU threads in trace
+        std::map<std::thread::id, uint32> threadIds;
+
+        /// protects events and threadIds
+        std::mutex mutex;
+
+        /**
+         * @brief RAII GPU zone, writes begin timestamp on creation and end timestamp on destruction
+         *
+         */
+        struct GpuScope{
+            Profiler& profiler;
+            VkCommandBuffer cmdBuffer;
+            uint32 zone;
+
+            GpuScope(Profiler& profiler, const VkCommandBuffer& cmdBuffer, const char* name) : profiler(profiler), cmdBuffer(cmdBuffer), zone(profiler.Begin(cmdBuffer, name)) {}
+            ~GpuScope() { profiler.End(cmdBuffer, zone); }
+        };
+
+        /**
+         * @brief RAII CPU zone, recorded in trace on destruction
+         *
+         */
+        struct CpuScope{
+            Profiler& profiler;
+            const char* name;
+            double start;
+
+            CpuScope(Profiler& profiler, const char* name) : profiler(profiler), name(name), start(profiler.Now()) {}
+            ~CpuScope() { profiler.AddCpuZone(name, start, profiler.Now()); }
+        };
+
+        /**
+         * @brief create query pools
+         *
+         * @param physicalDevice to get timestamp period from
+         * @param device
+         * @param queueFamilyIdx queue family command buffers with zones are submitted to
+         * @param framesInFlight number of frames that can be in flight at once
+         * @param maxZonesPerFrame maximum number of GPU zones in one frame
+         */
+        inline void Init(const VkPhysicalDevice& physicalDevice, const VkDevice& device, const uint32& queueFamilyIdx, const uint32& framesInFlight, const uint32& maxZonesPerFrame = 128){
+            this->device = device;
+            this->maxZonesPerFrame = maxZonesPerFrame;
+            frameIdx = 0;
+            epoch = std::chrono::steady_clock::now();
+            gpuTimeOffsetValid = false;
+
+            // ticks to nanoseconds
+            VkPhysicalDeviceProperties properties = GetPhysicalDeviceProperties(physicalDevice);
+            timestampPeriod = properties.limits.timestampPeriod;
+
+            // bits above timestampValidBits are undefined
+            uint32 validBits = GetPhysicalDeviceQueueFamilyProperties(physicalDevice)[queueFamilyIdx].timestampValidBits;
+            ASSERT(validBits != 0, "[Profiler] : Queue family %u doesn't support timestamps", queueFamilyIdx);
+            timestampMask = validBits >= 64 ? UINT64_MAX : (uint64(1) << validBits) - 1;
+
+            frames.resize(framesInFlight);
+            for(auto& frame : frames){
+                frame.pool = CreateQueryPool(device, Vulkan::Init::QueryPoolCreateInfo(VK_QUERY_TYPE_TIMESTAMP, 2 * maxZonesPerFrame));
+                frame.names.reserve(maxZonesPerFrame);
+                frame.pending = false;
+            }
+        }
+
+        /**
+         * @brief Start profiling a frame. Reads back timestamps this slot recorded
+         *        framesInFlight frames ago, so the fence of this frame must be waited for.
+         *        Must be recorded outside a render pass, before any zone of the frame.
+         *
+         * @param cmdBuffer command buffer of frame
+         * @param frameIdx index of frame in [0, framesInFlight)
+         */
+        inline void BeginFrame(const VkCommandBuffer& cmdBuffer, const uint32& frameIdx){
+            this->frameIdx = frameIdx;
+            FrameQueries& frame = frames[frameIdx];
+
+            if(frame.pending) Resolve(frame);
+
+            CmdResetQueryPool(cmdBuffer, frame.pool, 0, 2 * maxZonesPerFrame);
+            frame.names.clear();
+            frame.cpuBeginTime = Now();
+            frame.pending = true;
+        }
+
+        /**
+         * @brief begin a GPU zone
+         *
+         * @param cmdBuffer command buffer to write timestamp in
+         * @param name of zone, must outlive profiler
+         * @return uint32 : zone to pass to End, invalidZone if frame is out of queries
+         */
+        [[nodiscard]] inline uint32 Begin(const VkCommandBuffer& cmdBuffer, const char* name){
+            FrameQueries& frame = frames[frameIdx];
+            if(frame.names.size() == maxZonesPerFrame){
+                LOG(warning, "[Profiler] : More than %u zones in a frame, zone %s is dropped", maxZonesPerFrame, name);
+                return invalidZone;
+            }
+
+            uint32 zone = static_cast<uint32>(frame.names.size());
+            frame.names.push_back(name);
+            CmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.pool, 2 * zone);
+            return zone;
+        }
+
+        /**
+         * @brief end a GPU zone
+         *
+         * @param cmdBuffer command buffer to write timestamp in
+         * @param zone returned by Begin
+         */
+        inline void End(const VkCommandBuffer& cmdBuffer, const uint32& zone){
+            if(zone == invalidZone) return;
+            CmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frames[frameIdx].pool, 2 * zone + 1);
+        }
+
+        /**
+         * @brief microseconds since profiler creation
+         *
+         * @return double
+         */
+        [[nodiscard]] inline double Now() const{
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+        }
+
+        /**
+         * @brief record a CPU zone in trace. Thread safe.
+         *
+         * @param name of zone, must outlive profiler
+         * @param start returned by Now
+         * @param end returned by Now
+         */
+        inline void AddCpuZone(const char* name, const double& start, const double& end){
+            if(!tracing) return;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            auto threadId = threadIds.emplace(std::this_thread::get_id(), static_cast<uint32>(threadIds.size()) + 1).first->second;
+            events.push_back(TraceEvent{name, start, end - start, threadId});
+        }
+
+        /**
+         * @brief write collected trace events in Chrome trace event format and clear them
+         *
+         * @param filename json file to write
+         * @return true if written
+         * @return false otherwise
+         */
+        inline bool WriteTrace(const char* filename){
+            std::lock_guard<std::mutex> lock(mutex);
+
+            FILE* file = fopen(filename, "w");
+            if(file == nullptr){
+                LOG(error, "[Profiler] : Failed to open %s for writing", filename);
+                return false;
+            }
+
+            // name the threads
+            fprintf(file, "{\"traceEvents\":[\n");
+            fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"GPU\"}}", gpuThreadId);
+            for(const auto& [id, threadId] : threadIds){
+                fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"CPU %u\"}}", threadId, threadId);
+            }
+
+            // complete events
+            for(const auto& event : events){
+                fprintf(file, ",\n{\"name\":\"");
+                for(const char* c = event.name; *c; c++){
+                    if(*c == '"' || *c == '\\') fputc('\\', file);
+                    fputc(*c, file);
+                }
+                fprintf(file, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", event.threadId, event.start, event.duration);
+            }
+            fprintf(file, "\n]}\n");
+
+            bool written = ferror(file) == 0;
+            written = fclose(file) == 0 && written;
+            if(!written){
+                LOG(error, "[Profiler] : Failed to write trace to %s", filename);
+                return false;
+            }
+
+            LOG(success, "[Profiler] : Wrote %zu trace events to %s", events.size(), filename);
+            events.clear();
+            return true;
+        }
+
+        /**
+         * @brief destroy query pools, device must be idle
+         *
+         */
+        inline void Destroy(){
+            for(auto& frame : frames){
+                DestroyQueryPool(device, frame.pool);
+            }
+            frames.clear();
+        }
+
+    private:
+        /// read back timestamps of a frame and convert them to zones
+        inline void Resolve(FrameQueries& frame){
+            frame.pending = false;
+            if(frame.names.empty()) return;
+
+            // fence of frame was waited for, so this doesn't block
+            std::vector<uint64> timestamps;
+            if(!GetQueryPoolResults(device, frame.pool, 0, 2 * static_cast<uint32>(frame.names.size()), timestamps)){
+                LOG(warning, "[Profiler] : Timestamps not available, was fence of frame waited for?");
+                return;
+            }
+
+            // microseconds on GPU clock
+            auto toMicroseconds = [this](const uint64& ticks){
+                return static_cast<double>(ticks & timestampMask) * timestampPeriod / 1000.0;
+            };
+
+            double frameStart = toMicroseconds(timestamps[0]);
+            for(size_t i = 1; i < frame.names.size(); i++){
+                frameStart = std::min(frameStart, toMicroseconds(timestamps[2 * i]));
+            }
+
+            // GPU and CPU clocks are unrelated, GPU work can't start before the CPU began
+            // recording it, so shift GPU time to the earliest CPU time it could have run at
+            double offset = frame.cpuBeginTime - frameStart;
+            if(!gpuTimeOffsetValid || offset > gpuTimeOffset){
+                gpuTimeOffset = offset;
+                gpuTimeOffsetValid = true;
+            }
+
+            lastFrameZones.clear();
+            for(size_t i = 0; i < frame.names.size(); i++){
+                double start = toMicroseconds(timestamps[2 * i]);
+                double end = toMicroseconds(timestamps[2 * i + 1]);
+                lastFrameZones.push_back(ZoneResult{frame.names[i], (start - frameStart) / 1000.0, (end - start) / 1000.0});
+            }
+
+            if(tracing){
+                std::lock_guard<std::mutex> lock(mutex);
+                for(const auto& zone : lastFrameZones){
+                    events.push_back(TraceEvent{zone.name, frameStart + gpuTimeOffset + zone.start * 1000.0, zone.duration * 1000.0, gpuThreadId});
+                }
+            }
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_PROFILER_HPP
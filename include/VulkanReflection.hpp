@@ -0,0 +1,645 @@
+/**
+ * @file VulkanReflection.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief SPIR-V reflection. Extracts descriptor bindings, push constants and vertex inputs
+ *        from shader code and merges them into descriptor set and pipeline layouts.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_REFLECTION_HPP
+#define VULKAN_HELPER_VULKAN_REFLECTION_HPP
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanLayoutCache.hpp"
+#include "VulkanTools.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Reflection data of a single shader stage.
+     *        Parse walks the instruction stream once, recording what every id is in a
+     *        table indexed by id, and stops at the first function since all declarations
+     *        come before it. Variables are resolved from that table afterwards.
+     *
+     *        Only the first entry point is reflected. Array sizes given by specialization
+     *        constants use the constant's default value. Runtime arrays are reported
+     *        with a count of 0, give them a real count before creating layouts.
+     *
+     */
+    struct ShaderReflection{
+        /// a descriptor used by the shader
+        struct DescriptorBinding{
+            uint32 set = 0;
+            uint32 binding = 0;
+            VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+            /// number of descriptors, 0 for runtime arrays
+            uint32 count = 1;
+            std::string name;
+        };
+
+        /// a vertex shader input
+        struct VertexInput{
+            uint32 location = 0;
+            VkFormat format = VK_FORMAT_UNDEFINED;
+            /// size of one element in bytes
+            uint32 size = 0;
+            std::string name;
+        };
+
+        /// stage of reflected entry point
+        VkShaderStageFlagBits stage = VK_SHADER_STAGE_ALL;
+
+        /// name of reflected entry point
+        std::string entryPoint;
+
+        /// descriptors in set, binding order
+        std::vector<DescriptorBinding> bindings;
+
+        /// vertex inputs in location order, only filled for vertex shaders
+        std::vector<VertexInput> vertexInputs;
+
+        /// push constant range, size is 0 if shader has no push constants
+        VkPushConstantRange pushConstants = {};
+
+        /**
+         * @brief reflect spir-v code
+         *
+         * @param code spir-v words
+         * @param codeSize size of code in bytes
+         * @return true if code was reflected
+         * @return false if code isn't valid spir-v
+         */
+        [[nodiscard]] inline bool Parse(const uint32* code, const size_t& codeSize){
+            *this = ShaderReflection();
+            if(!Tools::IsSpirvCode(code, codeSize)){
+                LOG(error, "[ShaderReflection] : Code is not valid spir-v");
+                return false;
+            }
+
+            // header is magic, version, generator, id bound, schema
+            const uint32 wordCount = static_cast<uint32>(codeSize / sizeof(uint32));
+            const uint32 bound = code[3];
+            if(bound > wordCount){
+                LOG(error, "[ShaderReflection] : Id bound %u is larger than the module", bound);
+                return false;
+            }
+
+            ids.assign(bound, Id());
+            structs.clear();
+            variables.clear();
+            uint32 executionModel = ~0u;
+
+            for(uint32 pos = 5; pos < wordCount; ){
+                const uint32 count = code[pos] >> 16;
+                const uint32 opcode = code[pos] & 0xFFFF;
+                if(count == 0 || pos + count > wordCount){
+                    LOG(error, "[ShaderReflection] : Malformed instruction at word %u", pos);
+                    return false;
+                }
+                const uint32* op = code + pos;
+                pos += count;
+
+                // declarations are done once code starts
+                if(opcode == OpFunction) break;
+
+                // every id operand we read must be inside the bound
+                auto valid = [&](const uint32& operand){ return operand < count && op[operand] < bound; };
+
+                switch(opcode){
+                    case OpName:
+                        if(valid(1) && count > 2) ids[op[1]].name = String(op + 2, count - 2);
+                        break;
+
+                    case OpEntryPoint:
+                        if(executionModel == ~0u && count > 3){
+                            executionModel = op[1];
+                            const char* name = String(op + 3, count - 3);
+                            entryPoint = name ? name : "";
+                        }
+                        break;
+
+                    case OpDecorate:
+                        if(valid(1) && count > 2) Decorate(ids[op[1]], op[2], count > 3 ? op[3] : 0);
+                        break;
+
+                    case OpMemberDecorate:
+                        if(valid(1) && count > 4 && op[2] < wordCount){
+                            StructInfo& info = structs[op[1]];
+                            if(info.offsets.size() <= op[2]){
+                                info.offsets.resize(op[2] + 1, 0);
+                                info.matrixStrides.resize(op[2] + 1, 0);
+                            }
+                            if(op[3] == DecorationOffset) info.offsets[op[2]] = op[4];
+                            if(op[3] == DecorationMatrixStride) info.matrixStrides[op[2]] = op[4];
+                        }
+                        break;
+
+                    case OpTypeBool:
+                    case OpTypeSampler:
+                    case OpTypeAccelerationStructure:
+                        if(valid(1)) ids[op[1]].opcode = opcode;
+                        break;
+
+                    case OpTypeInt:
+                    case OpTypeFloat:
+                        // value is width, type is signedness
+                        if(valid(1) && count > 2){
+                            ids[op[1]].opcode = opcode;
+                            ids[op[1]].value = op[2];
+                            ids[op[1]].type = opcode == OpTypeInt && count > 3 ? op[3] : 1;
+                        }
+                        break;
+
+                    case OpTypeVector:
+                    case OpTypeMatrix:
+                    case OpTypeArray:
+                        // value is component count, column count or id of length constant
+                        if(valid(1) && valid(2) && count > 3 && (opcode != OpTypeArray || valid(3))){
+                            ids[op[1]].opcode = opcode;
+                            ids[op[1]].type = op[2];
+                            ids[op[1]].value = op[3];
+                        }
+                        break;
+
+                    case OpTypeRuntimeArray:
+                    case OpTypeSampledImage:
+                        if(valid(1) && valid(2)){
+                            ids[op[1]].opcode = opcode;
+                            ids[op[1]].type = op[2];
+                        }
+                        break;
+
+                    case OpTypeImage:
+                        // value is dimension
+                        if(valid(1) && count > 7){
+                            ids[op[1]].opcode = opcode;
+                            ids[op[1]].value = op[3];
+                            ids[op[1]].sampled = op[7];
+                        }
+                        break;
+
+                    case OpTypeStruct:
+                        if(valid(1) && std::all_of(op + 2, op + count, [&](const uint32& member){ return member < bound; })){
+                            structs[op[1]].members.assign(op + 2, op + count);
+
+                            // members are declared before the struct, so its size is known now
+                            ids[op[1]].value = StructSize(op[1]);
+                            ids[op[1]].opcode = opcode;
+                        }
+                        break;
+
+                    case OpTypePointer:
+                        if(valid(1) && valid(3)){
+                            ids[op[1]].opcode = opcode;
+                            ids[op[1]].storageClass = op[2];
+                            ids[op[1]].type = op[3];
+                        }
+                        break;
+
+                    case OpConstant:
+                    case OpSpecConstant:
+                        // only low word is needed for array lengths
+                        if(valid(2) && count > 3){
+                            ids[op[2]].opcode = opcode;
+                            ids[op[2]].value = op[3];
+                        }
+                        break;
+
+                    case OpVariable:
+                        if(valid(1) && valid(2) && count > 3){
+                            ids[op[2]].opcode = opcode;
+                            ids[op[2]].type = op[1];
+                            ids[op[2]].storageClass = op[3];
+                            variables.push_back(op[2]);
+                        }
+                        break;
+
+                    default:
+                        break;
+                }
+            }
+
+            if(executionModel == ~0u){
+                LOG(error, "[ShaderReflection] : Module has no entry point");
+                return false;
+            }
+            stage = StageFromExecutionModel(executionModel);
+
+            // resolve variables
+            uint32 pushConstantBegin = ~0u, pushConstantEnd = 0;
+            for(const uint32& variable : variables){
+                const Id& var = ids[variable];
+                const Id& pointer = ids[var.type];
+                if(pointer.opcode != OpTypePointer) continue;
+
+                switch(var.storageClass){
+                    case StorageClassUniformConstant:
+                    case StorageClassUniform:
+                    case StorageClassStorageBuffer:{
+                        if(!(var.flags & FlagBinding)) continue;
+
+                        DescriptorBinding binding;
+                        binding.set = var.set;
+                        binding.binding = var.binding;
+
+                        // unwrap arrays
+                        uint32 type = pointer.type;
+                        if(ids[type].opcode == OpTypeArray){
+                            binding.count = ids[ids[type].value].value;
+                            type = ids[type].type;
+                        }else if(ids[type].opcode == OpTypeRuntimeArray){
+                            binding.count = 0;
+                            type = ids[type].type;
+                        }
+
+                        binding.type = DescriptorType(type, var.storageClass);
+                        if(binding.type == VK_DESCRIPTOR_TYPE_MAX_ENUM) continue;
+
+                        // blocks are usually named on the type
+                        const char* name = var.name && *var.name ? var.name : ids[type].name;
+                        binding.name = name ? name : "";
+                        bindings.push_back(std::move(binding));
+                        break;
+                    }
+
+                    case StorageClassPushConstant:{
+                        if(ids[pointer.type].opcode != OpTypeStruct) continue;
+                        const StructInfo& info = structs[pointer.type];
+
+                        // range covers members the block declares, which may not start at 0
+                        for(const uint32& offset : info.offsets) pushConstantBegin = std::min(pushConstantBegin, offset);
+                        if(info.offsets.size() < info.members.size()) pushConstantBegin = 0;
+                        pushConstantEnd = std::max(pushConstantEnd, ids[pointer.type].value);
+                        break;
+                    }
+
+                    case StorageClassInput:{
+                        // built ins like gl_VertexIndex have no location
+                        if(stage != VK_SHADER_STAGE_VERTEX_BIT || (var.flags & FlagBuiltIn) || !(var.flags & FlagLocation)) continue;
+
+                        // matrices take one location per column
+                        uint32 type = pointer.type;
+                        uint32 columns = 1;
+                        if(ids[type].opcode == OpTypeMatrix){
+                            columns = ids[type].value;
+                            type = ids[type].type;
+                        }
+                        if(columns < 1 || columns > 4) continue;
+
+                        // eg. 64 bit or 8 bit types, a vertex layout built from them would be wrong
+                        const VkFormat format = VertexFormat(type);
+                        const uint32 size = TypeSize(type, 0);
+                        if(format == VK_FORMAT_UNDEFINED || size == 0){
+                            LOG(warning, "[ShaderReflection] : Vertex input %s at location %u has a type that can't be reflected, skipping it", var.name ? var.name : "", var.location);
+                            continue;
+                        }
+
+                        for(uint32 column = 0; column < columns; column++){
+                            VertexInput input;
+                            input.location = var.location + column;
+                            input.format = format;
+                            input.size = size;
+                            input.name = var.name ? var.name : "";
+                            vertexInputs.push_back(std::move(input));
+                        }
+                        break;
+                    }
+
+                    default:
+                        break;
+                }
+            }
+
+            if(pushConstantEnd > 0 && pushConstantEnd > pushConstantBegin){
+                pushConstants.stageFlags = stage;
+                pushConstants.offset = pushConstantBegin;
+                pushConstants.size = pushConstantEnd - pushConstantBegin;
+            }
+
+            std::sort(bindings.begin(), bindings.end(), [](const DescriptorBinding& a, const DescriptorBinding& b){
+                return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+            });
+            std::sort(vertexInputs.begin(), vertexInputs.end(), [](const VertexInput& a, const VertexInput& b){
+                return a.location < b.location;
+            });
+
+            // tables are only needed while parsing
+            ids.clear();
+            structs.clear();
+            variables.clear();
+            return true;
+        }
+
+    private:
+        // opcodes, storage classes and decorations from the SPIR-V specification
+        static constexpr uint32 OpName = 5;
+        static constexpr uint32 OpEntryPoint = 15;
+        static constexpr uint32 OpTypeBool = 20;
+        static constexpr uint32 OpTypeInt = 21;
+        static constexpr uint32 OpTypeFloat = 22;
+        static constexpr uint32 OpTypeVector = 23;
+        static constexpr uint32 OpTypeMatrix = 24;
+        static constexpr uint32 OpTypeImage = 25;
+        static constexpr uint32 OpTypeSampler = 26;
+        static constexpr uint32 OpTypeSampledImage = 27;
+        static constexpr uint32 OpTypeArray = 28;
+        static constexpr uint32 OpTypeRuntimeArray = 29;
+        static constexpr uint32 OpTypeStruct = 30;
+        static constexpr uint32 OpTypePointer = 32;
+        static constexpr uint32 OpConstant = 43;
+        static constexpr uint32 OpSpecConstant = 50;
+        static constexpr uint32 OpFunction = 54;
+        static constexpr uint32 OpVariable = 59;
+        static constexpr uint32 OpDecorate = 71;
+        static constexpr uint32 OpMemberDecorate = 72;
+        static constexpr uint32 OpTypeAccelerationStructure = 5341;
+
+        static constexpr uint32 StorageClassUniformConstant = 0;
+        static constexpr uint32 StorageClassInput = 1;
+        static constexpr uint32 StorageClassUniform = 2;
+        static constexpr uint32 StorageClassPushConstant = 9;
+        static constexpr uint32 StorageClassStorageBuffer = 12;
+
+        static constexpr uint32 DecorationBufferBlock = 3;
+        static constexpr uint32 DecorationArrayStride = 6;
+        static constexpr uint32 DecorationMatrixStride = 7;
+        static constexpr uint32 DecorationBuiltIn = 11;
+        static constexpr uint32 DecorationLocation = 30;
+        static constexpr uint32 DecorationBinding = 33;
+        static constexpr uint32 DecorationDescriptorSet = 34;
+        static constexpr uint32 DecorationOffset = 35;
+
+        static constexpr uint8 FlagBinding = 1 << 0;
+        static constexpr uint8 FlagLocation = 1 << 1;
+        static constexpr uint8 FlagBuiltIn = 1 << 2;
+        static constexpr uint8 FlagBufferBlock = 1 << 3;
+
+        /// what an id is, meaning of type and value depends on opcode
+        struct Id{
+            uint32 opcode = 0;
+            uint32 type = 0;
+            uint32 value = 0;
+            uint32 storageClass = 0;
+            uint32 sampled = 0;
+            uint32 set = 0;
+            uint32 binding = 0;
+            uint32 location = 0;
+            uint32 arrayStride = 0;
+            uint8 flags = 0;
+            /// points into the parsed code
+            const char* name = nullptr;
+        };
+
+        /// members of a struct type
+        struct StructInfo{
+            std::vector<uint32> members;
+            std::vector<uint32> offsets;
+            std::vector<uint32> matrixStrides;
+        };
+
+        /// ids of module being parsed
+        std::vector<Id> ids;
+
+        /// struct types of module being parsed
+        std::unordered_map<uint32, StructInfo> structs;
+
+        /// global variables of module being parsed
+        std::vector<uint32> variables;
+
+        /// get literal string starting at words, nullptr if it isn't terminated inside the instruction
+        [[nodiscard]] static inline const char* String(const uint32* words, const uint32& count){
+            const char* string = reinterpret_cast<const char*>(words);
+            return memchr(string, '\0', count * sizeof(uint32)) ? string : nullptr;
+        }
+
+        /// record a decoration
+        inline void Decorate(Id& id, const uint32& decoration, const uint32& value){
+            switch(decoration){
+                case DecorationDescriptorSet: id.set = value; break;
+                case DecorationBinding: id.binding = value; id.flags |= FlagBinding; break;
+                case DecorationLocation: id.location = value; id.flags |= FlagLocation; break;
+                case DecorationBuiltIn: id.flags |= FlagBuiltIn; break;
+                case DecorationBufferBlock: id.flags |= FlagBufferBlock; break;
+                case DecorationArrayStride: id.arrayStride = value; break;
+                default: break;
+            }
+        }
+
+        /// size of a type in bytes as laid out in a block, struct sizes are computed when declared
+        [[nodiscard]] inline uint32 TypeSize(const uint32& type, const uint32& matrixStride, const uint32& depth = 0) const{
+            // a malformed module could make array types refer to each other
+            if(depth > 64) return 0;
+
+            const Id& id = ids[type];
+            switch(id.opcode){
+                case OpTypeBool: return 4;
+                case OpTypeInt:
+                case OpTypeFloat: return id.value / 8;
+                case OpTypeVector: return id.value * TypeSize(id.type, 0, depth + 1);
+                case OpTypeMatrix: return id.value * (matrixStride ? matrixStride : TypeSize(id.type, 0, depth + 1));
+                case OpTypeArray: return ids[id.value].value * (id.arrayStride ? id.arrayStride : TypeSize(id.type, matrixStride, depth + 1));
+                case OpTypePointer: return 8;
+                case OpTypeStruct: return id.value;
+                default: return 0;
+            }
+        }
+
+        /// size of a struct from its members, members must already be declared
+        [[nodiscard]] inline uint32 StructSize(const uint32& type) const{
+            const StructInfo& info = structs.at(type);
+
+            uint32 size = 0;
+            for(size_t i = 0; i < info.members.size(); i++){
+                uint32 offset = i < info.offsets.size() ? info.offsets[i] : 0;
+                uint32 stride = i < info.matrixStrides.size() ? info.matrixStrides[i] : 0;
+                size = std::max(size, offset + TypeSize(info.members[i], stride));
+            }
+            return size;
+        }
+
+        /// descriptor type of a (non array) variable type
+        [[nodiscard]] inline VkDescriptorType DescriptorType(const uint32& type, const uint32& storageClass) const{
+            const Id& id = ids[type];
+            switch(id.opcode){
+                case OpTypeSampler: return VK_DESCRIPTOR_TYPE_SAMPLER;
+                case OpTypeSampledImage: return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                case OpTypeAccelerationStructure: return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                case OpTypeImage:{
+                    // dimension 5 is Buffer and 6 is SubpassData, sampled 2 means storage
+                    if(id.value == 5) return id.sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                    if(id.value == 6) return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                    return id.sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                case OpTypeStruct:{
+                    if(storageClass == StorageClassStorageBuffer || (id.flags & FlagBufferBlock)) return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    if(storageClass == StorageClassUniform) return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                    return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+                }
+                default: return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+            }
+        }
+
+        /// format of a 32 bit scalar or vector vertex input, VK_FORMAT_UNDEFINED for anything else
+        [[nodiscard]] inline VkFormat VertexFormat(const uint32& type) const{
+            const Id& id = ids[type];
+            uint32 components = id.opcode == OpTypeVector ? id.value : 1;
+            const Id& scalar = id.opcode == OpTypeVector ? ids[id.type] : id;
+            if(scalar.value != 32 || components < 1 || components > 4) return VK_FORMAT_UNDEFINED;
+
+            static constexpr VkFormat floatFormats[] = {VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+            static constexpr VkFormat intFormats[] = {VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT};
+            static constexpr VkFormat uintFormats[] = {VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT};
+
+            if(scalar.opcode == OpTypeFloat) return floatFormats[components - 1];
+            if(scalar.opcode == OpTypeInt) return scalar.type ? intFormats[components - 1] : uintFormats[components - 1];
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        /// shader stage of an execution model
+        [[nodiscard]] static inline VkShaderStageFlagBits StageFromExecutionModel(const uint32& executionModel){
+            switch(executionModel){
+                case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+                case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+                case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+                case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+                case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+                case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+                case 5313: return VK_SHADER_STAGE_RAYGEN_BIT_KHR;
+                case 5314: return VK_SHADER_STAGE_INTERSECTION_BIT_KHR;
+                case 5315: return VK_SHADER_STAGE_ANY_HIT_BIT_KHR;
+                case 5316: return VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+                case 5317: return VK_SHADER_STAGE_MISS_BIT_KHR;
+                case 5318: return VK_SHADER_STAGE_CALLABLE_BIT_KHR;
+                default: return VK_SHADER_STAGE_ALL;
+            }
+        }
+    };
+
+    /**
+     * @brief Reflection of all stages of a pipeline, merged into layouts.
+     *        A binding used by several stages gets all their stage flags, and push
+     *        constants of all stages are merged into one range visible to all of them.
+     *
+     */
+    struct PipelineReflection{
+        /// bindings of every set, indexed by set number
+        std::vector<std::vector<VkDescriptorSetLayoutBinding>> sets;
+
+        /// merged push constant range, empty if no stage uses push constants
+        std::vector<VkPushConstantRange> pushConstantRanges;
+
+        /// vertex inputs of vertex stage
+        std::vector<ShaderReflection::VertexInput> vertexInputs;
+
+        /**
+         * @brief merge a stage into pipeline reflection
+         *
+         * @param shader reflected stage
+         */
+        inline void Add(const ShaderReflection& shader){
+            for(const auto& binding : shader.bindings){
+                if(sets.size() <= binding.set) sets.resize(binding.set + 1);
+                auto& set = sets[binding.set];
+
+                auto it = std::find_if(set.begin(), set.end(), [&](const VkDescriptorSetLayoutBinding& b){ return b.binding == binding.binding; });
+                if(it == set.end()){
+                    VkDescriptorSetLayoutBinding layoutBinding = {};
+                    layoutBinding.binding           = binding.binding;
+                    layoutBinding.descriptorType    = binding.type;
+                    layoutBinding.descriptorCount   = binding.count;
+                    layoutBinding.stageFlags        = shader.stage;
+                    set.push_back(layoutBinding);
+                    continue;
+                }
+
+                ASSERT(it->descriptorType == binding.type, "[PipelineReflection] : Stages disagree on type of set %u binding %u (%s)", binding.set, binding.binding, binding.name.c_str());
+                it->descriptorCount = std::max(it->descriptorCount, binding.count);
+                it->stageFlags |= shader.stage;
+            }
+
+            if(shader.pushConstants.size > 0){
+                if(pushConstantRanges.empty()){
+                    pushConstantRanges.push_back(shader.pushConstants);
+                }else{
+                    VkPushConstantRange& range = pushConstantRanges[0];
+                    uint32 end = std::max(range.offset + range.size, shader.pushConstants.offset + shader.pushConstants.size);
+                    range.offset = std::min(range.offset, shader.pushConstants.offset);
+                    range.size = end - range.offset;
+                    range.stageFlags |= shader.stage;
+                }
+            }
+
+            if(shader.stage == VK_SHADER_STAGE_VERTEX_BIT) vertexInputs = shader.vertexInputs;
+        }
+
+        /**
+         * @brief get tightly packed vertex attributes, all in one binding, in location order
+         *
+         * @param binding vertex buffer binding the attributes read from
+         * @param stride set to size of one vertex
+         * @return std::vector<VkVertexInputAttributeDescription>
+         */
+        [[nodiscard]] inline std::vector<VkVertexInputAttributeDescription> GetVertexAttributes(const uint32& binding, uint32& stride) const{
+            std::vector<VkVertexInputAttributeDescription> attributes;
+            attributes.reserve(vertexInputs.size());
+
+            stride = 0;
+            for(const auto& input : vertexInputs){
+                VkVertexInputAttributeDescription attribute = {};
+                attribute.location  = input.location;
+                attribute.binding   = binding;
+                attribute.format    = input.format;
+                attribute.offset    = stride;
+                attributes.push_back(attribute);
+                stride += input.size;
+            }
+
+            // return
+            return attributes;
+        }
+
+        /**
+         * @brief get descriptor set layouts and pipeline layout from a layout cache.
+         *        Sets the shaders don't use get empty layouts so set numbers stay the same.
+         *
+         * @param layoutCache owns the returned layouts
+         * @param setLayouts set to descriptor set layouts in set order
+         * @return VkPipelineLayout
+         */
+        [[nodiscard]] inline VkPipelineLayout CreatePipelineLayout(LayoutCache& layoutCache, std::vector<VkDescriptorSetLayout>& setLayouts) const{
+            setLayouts.clear();
+            setLayouts.reserve(sets.size());
+            for(const auto& set : sets) setLayouts.push_back(layoutCache.GetDescriptorSetLayout(set));
+
+            // return
+            return layoutCache.GetPipelineLayout(setLayouts, pushConstantRanges);
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_REFLECTION_HPP
@@ -0,0 +1,648 @@
+/**
+ * @file VulkanRenderGraph.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Frame graph with pass culling, automatic barriers and transient memory aliasing.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_RENDER_GRAPH_HPP
+#define VULKAN_HELPER_VULKAN_RENDER_GRAPH_HPP
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+#include "VulkanMemory.hpp"
+#include "VulkanBarrier.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Frame graph. Passes declare which resources they read and write and
+     *        how (a Vulkan::Access state), Compile then
+     *
+     *        - culls passes whose results are never used. Passes writing imported resources
+     *          or marked with SideEffects() are kept, and so is everything they depend on.
+     *        - orders remaining passes topologically, spacing producers and consumers apart
+     *          when dependencies allow it.
+     *        - creates transient images with usage derived from their uses, and places them
+     *          in one memory allocation where images whose lifetimes don't overlap share memory.
+     *
+     *        Execute records every pass with the barriers it needs (through a BarrierTracker)
+     *        placed before it, including barriers between aliased images.
+     *        Build and Compile once (again on resize), Execute every frame.
+     *
+     */
+    struct RenderGraph{
+        /// index of a resource in graph
+        using ResourceId = uint32;
+
+        /// unused pass/lifetime index
+        static constexpr uint32 invalidIndex = UINT32_MAX;
+
+        /**
+         * @brief description of an image
+         *
+         */
+        struct ImageDesc{
+            VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+            VkExtent2D extent = {};
+            VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+            uint32 mipLevels = 1;
+            uint32 arrayLayers = 1;
+
+            /// usage besides the one derived from uses
+            VkImageUsageFlags usage = 0;
+        };
+
+        /**
+         * @brief a transient image, an imported image or an imported buffer
+         *
+         */
+        struct Resource{
+            std::string name;
+            ImageDesc desc;
+            bool imported = false;
+            bool isBuffer = false;
+
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView view = VK_NULL_HANDLE;
+            VkBuffer buffer = VK_NULL_HANDLE;
+
+            /// imported images : use by work before the graph
+            ResourceState initialState;
+
+            /// imported images : state left in after the graph, eg. Access::Present. Undefined layout keeps last state.
+            ResourceState finalState;
+
+            /// transient images : usage derived from uses
+            VkImageUsageFlags usage = 0;
+
+            /// transient images : positions in execution order of first and last use
+            uint32 firstUse = invalidIndex;
+            uint32 lastUse = invalidIndex;
+
+            /// transient images : memory requirements and placement in aliased memory
+            VkMemoryRequirements requirements = {};
+            VkDeviceSize aliasOffset = 0;
+        };
+
+        /**
+         * @brief use of a resource by a pass
+         *
+         */
+        struct Use{
+            ResourceId resource = 0;
+            ResourceState state;
+            bool read = false;
+            bool write = false;
+        };
+
+        /**
+         * @brief a pass
+         *
+         */
+        struct Pass{
+            std::string name;
+            std::vector<Use> uses;
+            std::function<void(const VkCommandBuffer&, RenderGraph&)> execute;
+            bool sideEffects = false;
+            bool culled = false;
+        };
+
+        /**
+         * @brief given to setup callback of AddPass to declare resources of the pass
+         *
+         */
+        struct PassBuilder{
+            RenderGraph& graph;
+            uint32 passIdx;
+
+            /// create a transient image, memory may be shared with other transient images
+            [[nodiscard]] inline ResourceId CreateImage(const std::string& name, const ImageDesc& desc){
+                Resource resource;
+                resource.name = name;
+                resource.desc = desc;
+                graph.resources.push_back(resource);
+                return static_cast<ResourceId>(graph.resources.size() - 1);
+            }
+
+            /// pass reads resource, previous contents are needed
+            inline void Read(const ResourceId& resource, const ResourceState& state){
+                AddUse(resource, state, true, false);
+            }
+
+            /// pass writes resource. Also Read it when previous contents are needed (eg. load op load).
+            inline void Write(const ResourceId& resource, const ResourceState& state){
+                AddUse(resource, state, false, true);
+            }
+
+            /// pass has effects outside the graph and is never culled
+            inline void SideEffects(){
+                graph.passes[passIdx].sideEffects = true;
+            }
+
+        private:
+            /// multiple uses of same resource in a pass are merged into one
+            inline void AddUse(const ResourceId& resource, const ResourceState& state, const bool& read, const bool& write){
+                ASSERT(resource < graph.resources.size(), "[RenderGraph] : Invalid resource used by pass %s", graph.passes[passIdx].name.c_str());
+                auto& uses = graph.passes[passIdx].uses;
+                for(auto& use : uses){
+                    if(use.resource != resource) continue;
+                    ASSERT(use.state.layout == state.layout || graph.resources[resource].isBuffer, "[RenderGraph] : Pass %s uses %s in two layouts",
+                           graph.passes[passIdx].name.c_str(), graph.resources[resource].name.c_str());
+                    use.state.stages |= state.stages;
+                    use.state.access |= state.access;
+                    use.read = use.read || read;
+                    use.write = use.write || write;
+                    return;
+                }
+                uses.push_back(Use{resource, state, read, write});
+            }
+        };
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// resources, indexed by ResourceId
+        std::vector<Resource> resources;
+
+        /// passes in order they were added
+        std::vector<Pass> passes;
+
+        /// indices of passes that aren't culled in execution order
+        std::vector<uint32> order;
+
+        /// barrier state of all resources, persists across frames
+        BarrierTracker barriers;
+
+        /// allocator aliased memory came from
+        Memory* memory = nullptr;
+
+        /// memory all transient images are placed in
+        Memory::Allocation transientMemory;
+
+        /// bytes transient images would need without aliasing
+        VkDeviceSize unaliasedSize = 0;
+
+        /**
+         * @brief initialize graph
+         *
+         * @param device
+         */
+        inline void Init(const VkDevice& device){
+            this->device = device;
+        }
+
+        /**
+         * @brief use an image owned outside the graph, eg. a swapchain image
+         *
+         * @param name
+         * @param image
+         * @param view
+         * @param desc
+         * @param initialState last use of image before the graph, eg. {COLOR_ATTACHMENT_OUTPUT stage, no access, UNDEFINED layout} after acquire
+         * @param finalState state to leave image in, eg. Access::Present
+         * @return ResourceId
+         */
+        [[nodiscard]] inline ResourceId ImportImage(const std::string& name, const VkImage& image, const VkImageView& view, const ImageDesc& desc,
+                                                    const ResourceState& initialState = {}, const ResourceState& finalState = {}){
+            Resource resource;
+            resource.name = name;
+            resource.desc = desc;
+            resource.imported = true;
+            resource.image = image;
+            resource.view = view;
+            resource.initialState = initialState;
+            resource.finalState = finalState;
+            resources.push_back(resource);
+            return static_cast<ResourceId>(resources.size() - 1);
+        }
+
+        /**
+         * @brief use a buffer owned outside the graph
+         *
+         * @param name
+         * @param buffer
+         * @return ResourceId
+         */
+        [[nodiscard]] inline ResourceId ImportBuffer(const std::string& name, const VkBuffer& buffer){
+            Resource resource;
+            resource.name = name;
+            resource.imported = true;
+            resource.isBuffer = true;
+            resource.buffer = buffer;
+            resources.push_back(resource);
+            return static_cast<ResourceId>(resources.size() - 1);
+        }
+
+        /**
+         * @brief change image of an imported resource, eg. to this frame's swapchain image
+         *
+         * @param resource returned by ImportImage
+         * @param image
+         * @param view
+         */
+        inline void SetImportedImage(const ResourceId& resource, const VkImage& image, const VkImageView& view){
+            ASSERT(resources[resource].imported && !resources[resource].isBuffer, "[RenderGraph] : %s is not an imported image", resources[resource].name.c_str());
+            resources[resource].image = image;
+            resources[resource].view = view;
+        }
+
+        /**
+         * @brief add a pass
+         *
+         * @param name for debugging and stats
+         * @param setup called right away to declare resources of pass
+         * @param execute called by Execute to record pass, resources are already in declared states
+         */
+        inline void AddPass(const std::string& name, const std::function<void(PassBuilder&)>& setup, std::function<void(const VkCommandBuffer&, RenderGraph&)> execute){
+            Pass pass;
+            pass.name = name;
+            pass.execute = std::move(execute);
+            passes.push_back(std::move(pass));
+
+            PassBuilder builder{*this, static_cast<uint32>(passes.size() - 1)};
+            setup(builder);
+        }
+
+        /**
+         * @brief cull, order, create transient images and alias their memory.
+         *        Transient images of a previous Compile are destroyed, so the GPU
+         *        must be done with them (eg. device idle on resize).
+         *
+         * @param memory allocator the aliased memory is taken from
+         */
+        inline void Compile(Memory& memory){
+            // free with the allocator they came from
+            DestroyTransientImages();
+            this->memory = &memory;
+            Cull();
+            Sort();
+            ComputeLifetimes();
+            CreateTransientImages();
+            LOG(success, "[RenderGraph] : Compiled %u passes (%u culled)", static_cast<uint32>(order.size()), static_cast<uint32>(passes.size() - order.size()));
+        }
+
+        /**
+         * @brief record all passes
+         *
+         * @param cmdBuffer
+         */
+        inline void Execute(const VkCommandBuffer& cmdBuffer){
+            // imported images start each frame in their initial state
+            for(const auto& resource : resources){
+                if(resource.imported && !resource.isBuffer){
+                    barriers.RegisterImage(resource.image, resource.desc.mipLevels, resource.desc.arrayLayers, resource.desc.aspect, resource.initialState);
+                }
+            }
+
+            std::vector<bool> touched(resources.size(), false);
+            for(const auto& passIdx : order){
+                Pass& pass = passes[passIdx];
+                for(const auto& use : pass.uses){
+                    Resource& resource = resources[use.resource];
+                    if(resource.isBuffer){
+                        barriers.UseBuffer(resource.buffer, use.state);
+                    }else{
+                        bool discard = false;
+                        if(!resource.imported && !touched[use.resource]){
+                            // contents of last frame are never needed, other images may have used the memory since
+                            discard = true;
+                            WaitForAliases(use.resource);
+                        }
+                        barriers.UseImage(resource.image, use.state, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS, discard);
+                    }
+                    touched[use.resource] = true;
+                }
+                barriers.Flush(cmdBuffer);
+                pass.execute(cmdBuffer, *this);
+            }
+
+            // leave imported images as requested
+            for(const auto& resource : resources){
+                if(resource.imported && !resource.isBuffer && resource.finalState.layout != VK_IMAGE_LAYOUT_UNDEFINED){
+                    barriers.UseImage(resource.image, resource.finalState);
+                }
+            }
+            barriers.Flush(cmdBuffer);
+        }
+
+        /// image of a resource
+        [[nodiscard]] inline VkImage GetImage(const ResourceId& resource) const{
+            ASSERT(resources[resource].image != VK_NULL_HANDLE, "[RenderGraph] : %s has no image, was it culled?", resources[resource].name.c_str());
+            return resources[resource].image;
+        }
+
+        /// view of all subresources of a resource
+        [[nodiscard]] inline VkImageView GetImageView(const ResourceId& resource) const{
+            ASSERT(resources[resource].view != VK_NULL_HANDLE, "[RenderGraph] : %s has no view, was it culled?", resources[resource].name.c_str());
+            return resources[resource].view;
+        }
+
+        /// buffer of a resource
+        [[nodiscard]] inline VkBuffer GetBuffer(const ResourceId& resource) const{
+            return resources[resource].buffer;
+        }
+
+        /// print pass order and transient memory saved by aliasing
+        inline void PrintStats() const{
+            printf("[RenderGraph] : passes = %u | culled = %u | transient memory = %.2f MiB | without aliasing = %.2f MiB\n",
+                static_cast<uint32>(order.size()), static_cast<uint32>(passes.size() - order.size()),
+                transientMemory.size / (1024.0 * 1024.0), unaliasedSize / (1024.0 * 1024.0));
+            for(const auto& passIdx : order){
+                printf("    %s\n", passes[passIdx].name.c_str());
+            }
+        }
+
+        /**
+         * @brief destroy transient images and their memory, device must be idle
+         *
+         */
+        inline void Destroy(){
+            DestroyTransientImages();
+            resources.clear();
+            passes.clear();
+            order.clear();
+            barriers.Reset();
+            unaliasedSize = 0;
+        }
+
+        /**
+         * @brief place ranges in memory so ranges with overlapping lifetimes don't overlap
+         *
+         * @param resources transient images with requirements and lifetimes set, aliasOffset is written
+         * @return VkDeviceSize : size of memory needed
+         */
+        [[nodiscard]] static inline VkDeviceSize PlaceAliased(std::vector<Resource*>& resources){
+            // biggest first packs best
+            std::sort(resources.begin(), resources.end(), [](const Resource* a, const Resource* b){ return a->requirements.size > b->requirements.size; });
+
+            VkDeviceSize totalSize = 0;
+            std::vector<Resource*> placed;
+            std::vector<Resource*> live;
+            for(auto& resource : resources){
+                // resources in use at the same time
+                live.clear();
+                for(auto& other : placed){
+                    if(other->firstUse <= resource->lastUse && resource->firstUse <= other->lastUse) live.push_back(other);
+                }
+                std::sort(live.begin(), live.end(), [](const Resource* a, const Resource* b){ return a->aliasOffset < b->aliasOffset; });
+
+                // first gap big enough
+                const VkDeviceSize alignment = std::max<VkDeviceSize>(resource->requirements.alignment, 1);
+                VkDeviceSize offset = 0;
+                for(auto& other : live){
+                    if(offset + resource->requirements.size <= other->aliasOffset) break;
+                    offset = std::max(offset, (other->aliasOffset + other->requirements.size + alignment - 1) / alignment * alignment);
+                }
+
+                resource->aliasOffset = offset;
+                totalSize = std::max(totalSize, offset + resource->requirements.size);
+                placed.push_back(resource);
+            }
+            return totalSize;
+        }
+
+    private:
+        /// last pass before given one that writes resource, invalidIndex if none
+        [[nodiscard]] inline uint32 LastWriter(const ResourceId& resource, const uint32& beforePass) const{
+            for(uint32 passIdx = beforePass; passIdx-- > 0;){
+                for(const auto& use : passes[passIdx].uses){
+                    if(use.resource == resource && use.write) return passIdx;
+                }
+            }
+            return invalidIndex;
+        }
+
+        /// mark passes nothing depends on as culled
+        inline void Cull(){
+            std::vector<uint32> stack;
+            for(uint32 passIdx = 0; passIdx < passes.size(); passIdx++){
+                Pass& pass = passes[passIdx];
+                pass.culled = true;
+                bool root = pass.sideEffects;
+                for(const auto& use : pass.uses){
+                    root = root || (use.write && resources[use.resource].imported);
+                }
+                if(root) stack.push_back(passIdx);
+            }
+            for(const auto& passIdx : stack) passes[passIdx].culled = false;
+
+            // everything a kept pass reads from is kept too
+            while(!stack.empty()){
+                uint32 passIdx = stack.back();
+                stack.pop_back();
+                for(const auto& use : passes[passIdx].uses){
+                    if(!use.read) continue;
+                    uint32 writer = LastWriter(use.resource, passIdx);
+                    if(writer != invalidIndex && passes[writer].culled){
+                        passes[writer].culled = false;
+                        stack.push_back(writer);
+                    }
+                }
+            }
+        }
+
+        /// topological order of kept passes, a pass whose dependencies finished earliest goes first
+        inline void Sort(){
+            const uint32 passCount = static_cast<uint32>(passes.size());
+            std::vector<std::vector<uint32>> successors(passCount);
+            std::vector<uint32> predecessorCount(passCount, 0);
+
+            // RAW, WAR and WAW edges in order passes were added
+            for(ResourceId resource = 0; resource < resources.size(); resource++){
+                uint32 lastWriter = invalidIndex;
+                std::vector<uint32> readers;
+                for(uint32 passIdx = 0; passIdx < passCount; passIdx++){
+                    if(passes[passIdx].culled) continue;
+                    for(const auto& use : passes[passIdx].uses){
+                        if(use.resource != resource) continue;
+                        auto addEdge = [&](const uint32& from){
+                            if(from == invalidIndex || from == passIdx) return;
+                            successors[from].push_back(passIdx);
+                            predecessorCount[passIdx]++;
+                        };
+                        addEdge(lastWriter);
+                        if(use.write){
+                            for(const auto& reader : readers) addEdge(reader);
+                            readers.clear();
+                            lastWriter = passIdx;
+                        }else{
+                            readers.push_back(passIdx);
+                        }
+                    }
+                }
+            }
+
+            // Kahn's algorithm
+            std::vector<uint32> readyAt(passCount, 0);
+            std::vector<uint32> ready;
+            for(uint32 passIdx = 0; passIdx < passCount; passIdx++){
+                if(!passes[passIdx].culled && predecessorCount[passIdx] == 0) ready.push_back(passIdx);
+            }
+            order.clear();
+            while(!ready.empty()){
+                auto next = std::min_element(ready.begin(), ready.end(), [&](const uint32& a, const uint32& b){
+                    return readyAt[a] != readyAt[b] ? readyAt[a] < readyAt[b] : a < b;
+                });
+                uint32 passIdx = *next;
+                ready.erase(next);
+                order.push_back(passIdx);
+                for(const auto& successor : successors[passIdx]){
+                    readyAt[successor] = std::max(readyAt[successor], static_cast<uint32>(order.size()));
+                    if(--predecessorCount[successor] == 0) ready.push_back(successor);
+                }
+            }
+        }
+
+        /// first and last use of transient images in execution order
+        inline void ComputeLifetimes(){
+            for(auto& resource : resources){
+                resource.firstUse = resource.lastUse = invalidIndex;
+                if(!resource.imported) resource.usage = resource.desc.usage;
+            }
+            for(uint32 position = 0; position < order.size(); position++){
+                for(const auto& use : passes[order[position]].uses){
+                    Resource& resource = resources[use.resource];
+                    if(resource.imported) continue;
+                    if(resource.firstUse == invalidIndex){
+                        ASSERT(use.write, "[RenderGraph] : %s is read by %s before anything writes it", resource.name.c_str(), passes[order[position]].name.c_str());
+                        resource.firstUse = position;
+                    }
+                    resource.lastUse = position;
+                    resource.usage |= ImageUsage(use.state);
+                }
+            }
+        }
+
+        /// destroy images and views of transient resources, stop tracking them and free their memory
+        inline void DestroyTransientImages(){
+            for(auto& resource : resources){
+                if(resource.imported) continue;
+                if(resource.view != VK_NULL_HANDLE) DestroyImageView(device, resource.view);
+                if(resource.image != VK_NULL_HANDLE){
+                    barriers.ForgetImage(resource.image);
+                    DestroyImage(device, resource.image);
+                }
+                resource.view = VK_NULL_HANDLE;
+                resource.image = VK_NULL_HANDLE;
+            }
+            if(memory != nullptr) memory->Free(transientMemory);
+        }
+
+        /// create images of used transient resources and bind them to aliased memory
+        inline void CreateTransientImages(){
+            std::vector<Resource*> transients;
+            uint32 memoryTypeBits = ~0u;
+            VkDeviceSize alignment = 1;
+            unaliasedSize = 0;
+            for(auto& resource : resources){
+                if(resource.imported || resource.firstUse == invalidIndex) continue;
+
+                VkImageCreateInfo createInfo = Vulkan::Init::ImageCreateInfo(resource.desc.format, resource.usage, {resource.desc.extent.width, resource.desc.extent.height, 1});
+                createInfo.mipLevels = resource.desc.mipLevels;
+                createInfo.arrayLayers = resource.desc.arrayLayers;
+                resource.image = CreateImage(device, createInfo);
+                resource.requirements = GetImageMemoryRequirements(device, resource.image);
+
+                memoryTypeBits &= resource.requirements.memoryTypeBits;
+                alignment = std::max(alignment, resource.requirements.alignment);
+                unaliasedSize += resource.requirements.size;
+                transients.push_back(&resource);
+            }
+            if(transients.empty()) return;
+
+            // one allocation for all of them
+            VkMemoryRequirements requirements = {};
+            requirements.size = PlaceAliased(transients);
+            requirements.alignment = alignment;
+            requirements.memoryTypeBits = memoryTypeBits;
+            ASSERT(memoryTypeBits != 0, "[RenderGraph] : Transient images have no memory type in common");
+            transientMemory = memory->Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false);
+
+            for(auto& resource : transients){
+                BindImageMemory(device, resource->image, transientMemory.memory, transientMemory.offset + resource->aliasOffset);
+
+                VkImageViewCreateInfo viewInfo = Vulkan::Init::ImageViewCreateInfo(resource->image, resource->desc.aspect, resource->desc.format);
+                viewInfo.viewType = resource->desc.arrayLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+                viewInfo.subresourceRange.levelCount = resource->desc.mipLevels;
+                viewInfo.subresourceRange.layerCount = resource->desc.arrayLayers;
+                resource->view = CreateImageView(device, viewInfo);
+
+                barriers.RegisterImage(resource->image, resource->desc.mipLevels, resource->desc.arrayLayers, resource->desc.aspect);
+            }
+        }
+
+        /// make first use of a transient image wait for every image sharing its memory
+        inline void WaitForAliases(const ResourceId& resourceId){
+            const Resource& resource = resources[resourceId];
+
+            // last accesses of overlapping images
+            VkPipelineStageFlags2KHR stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+            VkAccessFlags2KHR writeAccess = VK_ACCESS_2_NONE_KHR;
+            for(ResourceId otherId = 0; otherId < resources.size(); otherId++){
+                const Resource& other = resources[otherId];
+                if(otherId == resourceId || other.imported || other.image == VK_NULL_HANDLE) continue;
+                if(other.aliasOffset >= resource.aliasOffset + resource.requirements.size || resource.aliasOffset >= other.aliasOffset + other.requirements.size) continue;
+
+                for(const auto& state : barriers.images[other.image].subresources){
+                    stages |= state.writeStages | state.readStages;
+                    writeAccess |= state.writeAccess;
+                }
+            }
+            if(stages == VK_PIPELINE_STAGE_2_NONE_KHR) return;
+
+            // treat them as unflushed writes to this image
+            for(auto& state : barriers.images[resource.image].subresources){
+                state.writeStages |= stages;
+                state.writeAccess |= writeAccess;
+                state.visibleStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+                state.visibleAccess = VK_ACCESS_2_NONE_KHR;
+            }
+        }
+
+        /// image usage needed for a state
+        [[nodiscard]] static inline VkImageUsageFlags ImageUsage(const ResourceState& state){
+            VkImageUsageFlags usage = 0;
+            if(state.access & (VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR)) usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            if(state.access & (VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR)) usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+            if(state.access & VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT_KHR) usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+            if(state.access & VK_ACCESS_2_TRANSFER_READ_BIT_KHR) usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+            if(state.access & VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR) usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+            if(state.access & VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR) usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+            if(state.access & (VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR)) usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+
+            // generic shader access, layout tells how image is bound
+            if(state.access & (VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR)){
+                usage |= state.layout == VK_IMAGE_LAYOUT_GENERAL ? VK_IMAGE_USAGE_STORAGE_BIT : VK_IMAGE_USAGE_SAMPLED_BIT;
+            }
+            return usage;
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_RENDER_GRAPH_HPP
@@ -0,0 +1,661 @@
+/**
+ * @file VulkanResult.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Non fatal wrappers that return VkResult to caller instead of asserting.
+ * @version 0.1
+ * @date 2021-05-13
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_RESULT_HPP
+#define VULKAN_HELPER_VULKAN_RESULT_HPP
+
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief true if a call returning result produced its output. VK_SUBOPTIMAL_KHR still
+     *        acquires or presents an image, other positive codes (eg. VK_TIMEOUT) don't.
+     *
+     * @param result returned by vulkan
+     */
+    [[nodiscard]] inline bool HasValue(const VkResult& result){
+        return result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR;
+    }
+
+    /**
+     * @brief Value or VkResult error, like std::expected<T, VkResult>.
+     *        Holds a value when result is VK_SUCCESS or VK_SUBOPTIMAL_KHR. Other success
+     *        codes (VK_TIMEOUT, VK_NOT_READY, VK_PIPELINE_COMPILE_REQUIRED, ...) mean the
+     *        call produced nothing usable, so they have no value either and are returned
+     *        by error() like failures.
+     *
+     * @tparam T type of value
+     */
+    template<typename T>
+    struct Result{
+        /// returned VkResult
+        VkResult result;
+
+        /// value, only meaningful when has_value() is true
+        T payload;
+
+        Result(const VkResult& result, const T& payload) : result(result), payload(payload) {}
+        Result(const VkResult& result) : result(result), payload() {}
+
+        /// true if vulkan returned VK_SUCCESS or VK_SUBOPTIMAL_KHR
+        [[nodiscard]] inline bool has_value() const { return HasValue(result); }
+        [[nodiscard]] explicit inline operator bool() const { return has_value(); }
+
+        /// value, asserts if there is none
+        [[nodiscard]] inline T& value(){
+            ASSERT(has_value(), "[Result] : Accessed value of failed result -> returned : %s", ResultString(result));
+            return payload;
+        }
+
+        /// value, asserts if there is none
+        [[nodiscard]] inline const T& value() const{
+            ASSERT(has_value(), "[Result] : Accessed value of failed result -> returned : %s", ResultString(result));
+            return payload;
+        }
+
+        /// value or given default if there is none
+        [[nodiscard]] inline T value_or(const T& defaultValue) const { return has_value() ? payload : defaultValue; }
+
+        /// returned VkResult
+        [[nodiscard]] inline VkResult error() const { return result; }
+
+        [[nodiscard]] inline T& operator*() { return value(); }
+        [[nodiscard]] inline const T& operator*() const { return value(); }
+        [[nodiscard]] inline T* operator->() { return &value(); }
+        [[nodiscard]] inline const T* operator->() const { return &value(); }
+    };
+
+    /**
+     * @brief Result of a function that returns nothing but a VkResult
+     *
+     */
+    template<>
+    struct Result<void>{
+        /// returned VkResult
+        VkResult result;
+
+        Result(const VkResult& result) : result(result) {}
+
+        /// true if vulkan returned VK_SUCCESS or VK_SUBOPTIMAL_KHR
+        [[nodiscard]] inline bool has_value() const { return HasValue(result); }
+        [[nodiscard]] explicit inline operator bool() const { return has_value(); }
+
+        /// returned VkResult
+        [[nodiscard]] inline VkResult error() const { return result; }
+    };
+
+    /**
+     * @brief Same wrappers as in Vulkan namespace, but failures are returned instead of
+     *        ending the process. Use these where a failure is recoverable, eg. evict caches
+     *        and retry on VK_ERROR_OUT_OF_DEVICE_MEMORY or recreate swapchain on
+     *        VK_ERROR_OUT_OF_DATE_KHR. Invalid handles are programming errors and still assert.
+     *
+     *        if(auto buffer = Vulkan::Try::CreateBuffer(device, createInfo)) use(*buffer);
+     *        else if(buffer.error() == VK_ERROR_OUT_OF_DEVICE_MEMORY) ...
+     *
+     */
+    namespace Try{
+
+        /**
+         * @brief create vulkan instance
+         *
+         * @param instanceCreateInfo
+         * @param allocator
+         * @return Result<VkInstance>
+         */
+        [[nodiscard]] inline Result<VkInstance> CreateInstance(const VkInstanceCreateInfo& instanceCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+            VkInstance instance = VK_NULL_HANDLE;
+            VkResult res = vkCreateInstance(&instanceCreateInfo, allocator, &instance);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateInstance] : Vulkan Instance created");
+            return {res, instance};
+        }
+
+        /**
+         * @brief create logical device
+         *
+         * @param physicalDevice
+         * @param deviceCreateInfo
+         * @param allocator
+         * @return Result<VkDevice>
+         */
+        [[nodiscard]] inline Result<VkDevice> CreateDevice(const VkPhysicalDevice& physicalDevice, const VkDeviceCreateInfo& deviceCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check physical device handle
+            CHECK_VULKAN_HANDLE(physicalDevice)
+
+            VkDevice device = VK_NULL_HANDLE;
+            VkResult res = vkCreateDevice(physicalDevice, &deviceCreateInfo, allocator, &device);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateDevice] : Logical Device created");
+            return {res, device};
+        }
+
+        /**
+         * @brief create swapchain
+         *
+         * @param device
+         * @param swapchainCreateInfo
+         * @param allocator
+         * @return Result<VkSwapchainKHR>
+         */
+        [[nodiscard]] inline Result<VkSwapchainKHR> CreateSwapchain(const VkDevice& device, const VkSwapchainCreateInfoKHR& swapchainCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+            VkResult res = vkCreateSwapchainKHR(device, &swapchainCreateInfo, allocator, &swapchain);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateSwapchain] : Swapchain created");
+            return {res, swapchain};
+        }
+
+        /**
+         * @brief create image view
+         *
+         * @param device
+         * @param ivCreateInfo
+         * @param allocator
+         * @return Result<VkImageView>
+         */
+        [[nodiscard]] inline Result<VkImageView> CreateImageView(const VkDevice& device, const VkImageViewCreateInfo& ivCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkImageView imageView = VK_NULL_HANDLE;
+            VkResult res = vkCreateImageView(device, &ivCreateInfo, allocator, &imageView);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateImageView] : Image View created");
+            return {res, imageView};
+        }
+
+        /**
+         * @brief create command pool
+         *
+         * @param device
+         * @param commandPoolInfo
+         * @param allocator
+         * @return Result<VkCommandPool>
+         */
+        [[nodiscard]] inline Result<VkCommandPool> CreateCommandPool(const VkDevice& device, const VkCommandPoolCreateInfo& commandPoolInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkCommandPool commandPool = VK_NULL_HANDLE;
+            VkResult res = vkCreateCommandPool(device, &commandPoolInfo, allocator, &commandPool);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateCommandPool] : Command Pool created");
+            return {res, commandPool};
+        }
+
+        /**
+         * @brief allocate command buffers
+         *
+         * @param device
+         * @param cmdBufAllocInfo
+         * @return Result<std::vector<VkCommandBuffer>>
+         */
+        [[nodiscard]] inline Result<std::vector<VkCommandBuffer>> AllocateCommandBuffers(const VkDevice& device, const VkCommandBufferAllocateInfo& cmdBufAllocInfo){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            std::vector<VkCommandBuffer> cmdBuffers(cmdBufAllocInfo.commandBufferCount);
+            VkResult res = vkAllocateCommandBuffers(device, &cmdBufAllocInfo, cmdBuffers.data());
+            if(res == VK_SUCCESS) LOG(success, "[Try::AllocateCommandBuffers] : %u Command Buffer(s) allocated", cmdBufAllocInfo.commandBufferCount);
+            return {res, cmdBuffers};
+        }
+
+        /**
+         * @brief create render pass
+         *
+         * @param device
+         * @param createInfo
+         * @param allocator
+         * @return Result<VkRenderPass>
+         */
+        [[nodiscard]] inline Result<VkRenderPass> CreateRenderPass(const VkDevice& device, const VkRenderPassCreateInfo& createInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkRenderPass renderPass = VK_NULL_HANDLE;
+            VkResult res = vkCreateRenderPass(device, &createInfo, allocator, &renderPass);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateRenderPass] : Render Pass created");
+            return {res, renderPass};
+        }
+
+        /**
+         * @brief create framebuffer
+         *
+         * @param device
+         * @param framebufferCreateInfo
+         * @param allocator
+         * @return Result<VkFramebuffer>
+         */
+        [[nodiscard]] inline Result<VkFramebuffer> CreateFramebuffer(const VkDevice& device, const VkFramebufferCreateInfo& framebufferCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkFramebuffer framebuffer = VK_NULL_HANDLE;
+            VkResult res = vkCreateFramebuffer(device, &framebufferCreateInfo, allocator, &framebuffer);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateFramebuffer] : Framebuffer created");
+            return {res, framebuffer};
+        }
+
+        /**
+         * @brief create fence
+         *
+         * @param device
+         * @param fenceCreateInfo
+         * @param allocator
+         * @return Result<VkFence>
+         */
+        [[nodiscard]] inline Result<VkFence> CreateFence(const VkDevice& device, const VkFenceCreateInfo& fenceCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkFence fence = VK_NULL_HANDLE;
+            VkResult res = vkCreateFence(device, &fenceCreateInfo, allocator, &fence);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateFence] : Fence created");
+            return {res, fence};
+        }
+
+        /**
+         * @brief create semaphore
+         *
+         * @param device
+         * @param semaphoreCreateInfo
+         * @param allocator
+         * @return Result<VkSemaphore>
+         */
+        [[nodiscard]] inline Result<VkSemaphore> CreateSemaphore(const VkDevice& device, const VkSemaphoreCreateInfo& semaphoreCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkSemaphore semaphore = VK_NULL_HANDLE;
+            VkResult res = vkCreateSemaphore(device, &semaphoreCreateInfo, allocator, &semaphore);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateSemaphore] : Semaphore created");
+            return {res, semaphore};
+        }
+
+        /**
+         * @brief create descriptor set layout
+         *
+         * @param device
+         * @param createInfo
+         * @param allocator
+         * @return Result<VkDescriptorSetLayout>
+         */
+        [[nodiscard]] inline Result<VkDescriptorSetLayout> CreateDescriptorSetLayout(const VkDevice& device, const VkDescriptorSetLayoutCreateInfo& createInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+            VkResult res = vkCreateDescriptorSetLayout(device, &createInfo, allocator, &layout);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateDescriptorSetLayout] : Descriptor Set Layout created");
+            return {res, layout};
+        }
+
+        /**
+         * @brief create descriptor pool
+         *
+         * @param device
+         * @param createInfo
+         * @param allocator
+         * @return Result<VkDescriptorPool>
+         */
+        [[nodiscard]] inline Result<VkDescriptorPool> CreateDescriptorPool(const VkDevice& device, const VkDescriptorPoolCreateInfo& createInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkDescriptorPool pool = VK_NULL_HANDLE;
+            VkResult res = vkCreateDescriptorPool(device, &createInfo, allocator, &pool);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateDescriptorPool] : Descriptor Pool created");
+            return {res, pool};
+        }
+
+        /**
+         * @brief allocate descriptor sets, fails with VK_ERROR_OUT_OF_POOL_MEMORY or
+         *        VK_ERROR_FRAGMENTED_POOL when pool is exhausted
+         *
+         * @param device
+         * @param allocateInfo
+         * @return Result<std::vector<VkDescriptorSet>>
+         */
+        [[nodiscard]] inline Result<std::vector<VkDescriptorSet>> AllocateDescriptorSets(const VkDevice& device, const VkDescriptorSetAllocateInfo& allocateInfo){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            std::vector<VkDescriptorSet> descriptorSets(allocateInfo.descriptorSetCount);
+            VkResult res = vkAllocateDescriptorSets(device, &allocateInfo, descriptorSets.data());
+            return {res, descriptorSets};
+        }
+
+        /**
+         * @brief create shader module
+         *
+         * @param device
+         * @param smCreateInfo
+         * @param allocator
+         * @return Result<VkShaderModule>
+         */
+        [[nodiscard]] inline Result<VkShaderModule> CreateShaderModule(const VkDevice& device, const VkShaderModuleCreateInfo& smCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkShaderModule shaderModule = VK_NULL_HANDLE;
+            VkResult res = vkCreateShaderModule(device, &smCreateInfo, allocator, &shaderModule);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateShaderModule] : Shader Module created");
+            return {res, shaderModule};
+        }
+
+        /**
+         * @brief create pipeline layout
+         *
+         * @param device
+         * @param pipelineLayoutInfo
+         * @param allocator
+         * @return Result<VkPipelineLayout>
+         */
+        [[nodiscard]] inline Result<VkPipelineLayout> CreatePipelineLayout(const VkDevice& device, const VkPipelineLayoutCreateInfo& pipelineLayoutInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+            VkResult res = vkCreatePipelineLayout(device, &pipelineLayoutInfo, allocator, &pipelineLayout);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreatePipelineLayout] : Pipeline Layout created");
+            return {res, pipelineLayout};
+        }
+
+        /**
+         * @brief create multiple graphics pipelines. VK_PIPELINE_COMPILE_REQUIRED (with
+         *        VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT) has no value,
+         *        pipelines that weren't created are VK_NULL_HANDLE.
+         *
+         * @param device
+         * @param pipelineCache
+         * @param createInfos
+         * @param allocator
+         * @return Result<std::vector<VkPipeline>>
+         */
+        [[nodiscard]] inline Result<std::vector<VkPipeline>> CreateGraphicsPipelines(const VkDevice& device, const VkPipelineCache& pipelineCache, const std::vector<VkGraphicsPipelineCreateInfo>& createInfos, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            std::vector<VkPipeline> pipelines(createInfos.size(), VK_NULL_HANDLE);
+            VkResult res = vkCreateGraphicsPipelines(device, pipelineCache, static_cast<uint32>(createInfos.size()), createInfos.data(), allocator, pipelines.data());
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateGraphicsPipelines] : %u Graphics Pipeline(s) created", static_cast<uint32>(pipelines.size()));
+            return {res, pipelines};
+        }
+
+        /**
+         * @brief create one graphics pipeline. VK_PIPELINE_COMPILE_REQUIRED has no value.
+         *
+         * @param device
+         * @param pipelineCache
+         * @param createInfo
+         * @param allocator
+         * @return Result<VkPipeline>
+         */
+        [[nodiscard]] inline Result<VkPipeline> CreateGraphicsPipeline(const VkDevice& device, const VkPipelineCache& pipelineCache, const VkGraphicsPipelineCreateInfo& createInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            VkResult res = vkCreateGraphicsPipelines(device, pipelineCache, 1, &createInfo, allocator, &pipeline);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateGraphicsPipeline] : Graphics Pipeline created");
+            return {res, pipeline};
+        }
+
+        /**
+         * @brief create buffer
+         *
+         * @param device
+         * @param createInfo
+         * @param allocator
+         * @return Result<VkBuffer>
+         */
+        [[nodiscard]] inline Result<VkBuffer> CreateBuffer(const VkDevice& device, const VkBufferCreateInfo& createInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkResult res = vkCreateBuffer(device, &createInfo, allocator, &buffer);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateBuffer] : Buffer created");
+            return {res, buffer};
+        }
+
+        /**
+         * @brief create image
+         *
+         * @param device
+         * @param imageCreateInfo
+         * @param allocator
+         * @return Result<VkImage>
+         */
+        [[nodiscard]] inline Result<VkImage> CreateImage(const VkDevice& device, const VkImageCreateInfo& imageCreateInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkImage image = VK_NULL_HANDLE;
+            VkResult res = vkCreateImage(device, &imageCreateInfo, allocator, &image);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateImage] : Image created");
+            return {res, image};
+        }
+
+        /**
+         * @brief allocate device memory
+         *
+         * @param device
+         * @param allocateInfo
+         * @param allocator
+         * @return Result<VkDeviceMemory>
+         */
+        [[nodiscard]] inline Result<VkDeviceMemory> AllocateMemory(const VkDevice& device, const VkMemoryAllocateInfo& allocateInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            VkResult res = vkAllocateMemory(device, &allocateInfo, allocator, &memory);
+            if(res == VK_SUCCESS) LOG(success, "[Try::AllocateMemory] : %" PRIu64 " bytes of Device Memory allocated", static_cast<uint64>(allocateInfo.allocationSize));
+            return {res, memory};
+        }
+
+        /**
+         * @brief map device memory
+         *
+         * @param device
+         * @param memory
+         * @param offset
+         * @param size
+         * @return Result<void*>
+         */
+        [[nodiscard]] inline Result<void*> MapMemory(const VkDevice& device, const VkDeviceMemory& memory, const VkDeviceSize& offset = 0, const VkDeviceSize& size = VK_WHOLE_SIZE){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            // check memory handle
+            CHECK_VULKAN_HANDLE(memory)
+
+            void* data = nullptr;
+            VkResult res = vkMapMemory(device, memory, offset, size, 0, &data);
+            return {res, data};
+        }
+
+        /**
+         * @brief bind memory to buffer
+         *
+         * @param device
+         * @param buffer
+         * @param memory
+         * @param offset
+         * @return Result<void>
+         */
+        [[nodiscard]] inline Result<void> BindBufferMemory(const VkDevice& device, const VkBuffer& buffer, const VkDeviceMemory& memory, const VkDeviceSize& offset){
+            // check handles
+            CHECK_VULKAN_HANDLE(device)
+            CHECK_VULKAN_HANDLE(buffer)
+            CHECK_VULKAN_HANDLE(memory)
+
+            return vkBindBufferMemory(device, buffer, memory, offset);
+        }
+
+        /**
+         * @brief bind memory to image
+         *
+         * @param device
+         * @param image
+         * @param memory
+         * @param offset
+         * @return Result<void>
+         */
+        [[nodiscard]] inline Result<void> BindImageMemory(const VkDevice& device, const VkImage& image, const VkDeviceMemory& memory, const VkDeviceSize& offset){
+            // check handles
+            CHECK_VULKAN_HANDLE(device)
+            CHECK_VULKAN_HANDLE(image)
+            CHECK_VULKAN_HANDLE(memory)
+
+            return vkBindImageMemory(device, image, memory, offset);
+        }
+
+        /**
+         * @brief create pipeline cache
+         *
+         * @param device
+         * @param createInfo
+         * @param allocator
+         * @return Result<VkPipelineCache>
+         */
+        [[nodiscard]] inline Result<VkPipelineCache> CreatePipelineCache(const VkDevice& device, const VkPipelineCacheCreateInfo& createInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+            VkResult res = vkCreatePipelineCache(device, &createInfo, allocator, &pipelineCache);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreatePipelineCache] : Pipeline Cache created");
+            return {res, pipelineCache};
+        }
+
+        /**
+         * @brief create query pool
+         *
+         * @param device
+         * @param createInfo
+         * @param allocator
+         * @return Result<VkQueryPool>
+         */
+        [[nodiscard]] inline Result<VkQueryPool> CreateQueryPool(const VkDevice& device, const VkQueryPoolCreateInfo& createInfo, const VkAllocationCallbacks* allocator = nullptr){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            VkQueryPool queryPool = VK_NULL_HANDLE;
+            VkResult res = vkCreateQueryPool(device, &createInfo, allocator, &queryPool);
+            if(res == VK_SUCCESS) LOG(success, "[Try::CreateQueryPool] : Query Pool created");
+            return {res, queryPool};
+        }
+
+        /**
+         * @brief acquire next swapchain image. VK_SUBOPTIMAL_KHR still gives an image,
+         *        VK_ERROR_OUT_OF_DATE_KHR means swapchain must be recreated.
+         *
+         * @param device
+         * @param swapchain
+         * @param timeout
+         * @param semaphore
+         * @param fence
+         * @return Result<uint32> : image index
+         */
+        [[nodiscard]] inline Result<uint32> AcquireNextImage(const VkDevice& device, const VkSwapchainKHR& swapchain, const uint64& timeout, const VkSemaphore& semaphore, const VkFence& fence){
+            // check handles
+            CHECK_VULKAN_HANDLE(device)
+            CHECK_VULKAN_HANDLE(swapchain)
+
+            uint32 idx = 0;
+            VkResult res = vkAcquireNextImageKHR(device, swapchain, timeout, semaphore, fence, &idx);
+            return {res, idx};
+        }
+
+        /**
+         * @brief submit to queue
+         *
+         * @param queue
+         * @param submitInfos
+         * @param fence
+         * @return Result<void>
+         */
+        [[nodiscard]] inline Result<void> QueueSubmit(const VkQueue& queue, const Span<VkSubmitInfo>& submitInfos, const VkFence& fence){
+            // check queue handle
+            CHECK_VULKAN_HANDLE(queue)
+
+            return vkQueueSubmit(queue, submitInfos.size(), submitInfos.data(), fence);
+        }
+
+        /**
+         * @brief submit to present queue. VK_SUBOPTIMAL_KHR is a success,
+         *        VK_ERROR_OUT_OF_DATE_KHR means swapchain must be recreated.
+         *
+         * @param queue
+         * @param presentInfo
+         * @return Result<void>
+         */
+        [[nodiscard]] inline Result<void> QueuePresent(const VkQueue& queue, const VkPresentInfoKHR& presentInfo){
+            // check queue handle
+            CHECK_VULKAN_HANDLE(queue)
+
+            return vkQueuePresentKHR(queue, &presentInfo);
+        }
+
+        /**
+         * @brief wait for fences. Result has no value and error() is VK_TIMEOUT
+         *        if fences weren't signaled in time.
+         *
+         * @param device
+         * @param fences
+         * @param waitAll
+         * @param timeout
+         * @return Result<void>
+         */
+        [[nodiscard]] inline Result<void> WaitForFences(const VkDevice& device, const Span<VkFence>& fences, const VkBool32& waitAll, const uint64& timeout){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            return vkWaitForFences(device, fences.size(), fences.data(), waitAll, timeout);
+        }
+
+        /**
+         * @brief wait for device until it becomes idle
+         *
+         * @param device
+         * @return Result<void>
+         */
+        [[nodiscard]] inline Result<void> DeviceWaitIdle(const VkDevice& device){
+            // check device handle
+            CHECK_VULKAN_HANDLE(device)
+
+            return vkDeviceWaitIdle(device);
+        }
+
+    } // namespace Try
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_RESULT_HPP
@@ -0,0 +1,377 @@
+/**
+ * @file VulkanShaderArchive.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Zero copy shader loading from memory mapped spir-v files and packed shader archives.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_SHADER_ARCHIVE_HPP
+#define VULKAN_HELPER_VULKAN_SHADER_ARCHIVE_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+#include "VulkanTools.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief create a shader module from a spir-v file.
+     *        The file is mapped and the mapping is given directly to vkCreateShaderModule,
+     *        so the code is never copied on our side. Mapping is released once the
+     *        driver has consumed it.
+     *
+     * @param device
+     * @param filename of file containing spir-v code
+     * @param allocator
+     * @return VkShaderModule
+     */
+    [[nodiscard]] inline VkShaderModule LoadShaderModule(const VkDevice& device, const char* filename, const VkAllocationCallbacks* allocator = nullptr){
+        // map file
+        Tools::MappedFile file;
+        bool opened = file.Open(filename);
+
+        // check file
+        ASSERT(opened, "Unable to open shader code file %s", filename);
+        ASSERT(Tools::IsSpirvCode(file.data, file.size), "%s is not a valid spir-v file", filename);
+
+        // return
+        return CreateShaderModule(device, Init::ShaderModuleCreateInfo(static_cast<const uint32*>(file.data), file.size), allocator);
+    }
+
+    /**
+     * @brief Many spir-v modules packed in one file, so startup does a single open and
+     *        a single mapping instead of one per shader.
+     *
+     *        Layout (all fields are uint32) :
+     *        | Header | Entry[moduleCount] sorted by name | names, null terminated, padded to 4 bytes | code |
+     *
+     *        Every code offset is a multiple of 4 and mappings are page aligned, so the
+     *        code can be passed to vkCreateShaderModule straight from the mapping.
+     *        Archives are written with ShaderArchiveWriter.
+     *
+     */
+    struct ShaderArchive{
+        /// "VKSA" in little endian
+        static constexpr uint32 magic = 0x41534B56;
+
+        /// bumped whenever the layout changes
+        static constexpr uint32 version = 1;
+
+        /// archive header
+        struct Header{
+            uint32 magic;
+            uint32 version;
+            uint32 moduleCount;
+            /// size of name table in bytes, including padding
+            uint32 namesSize;
+        };
+
+        /// one entry per module
+        struct Entry{
+            /// offset of name from start of name table
+            uint32 nameOffset;
+            /// length of name without null terminator
+            uint32 nameSize;
+            /// offset of code from start of file
+            uint32 codeOffset;
+            /// size of code in bytes
+            uint32 codeSize;
+        };
+
+        /// code of a module inside the mapping
+        struct Code{
+            /// spir-v words, nullptr if module wasn't found
+            const uint32* words = nullptr;
+
+            /// size of code in bytes
+            size_t size = 0;
+        };
+
+        /// mapped archive
+        Tools::MappedFile file;
+
+        /// module entries, sorted by name
+        const Entry* entries = nullptr;
+
+        /// name table
+        const char* names = nullptr;
+
+        /// number of modules in archive
+        uint32 moduleCount = 0;
+
+        /**
+         * @brief map an archive and validate its index
+         *
+         * @param filename of archive
+         * @return true if archive was opened
+         * @return false if file doesn't exist or isn't a valid archive
+         */
+        [[nodiscard]] inline bool Open(const char* filename){
+            Close();
+            if(!file.Open(filename)){
+                LOG(warning, "[ShaderArchive] : Unable to open %s", filename);
+                return false;
+            }
+
+            if(!Validate()){
+                LOG(error, "[ShaderArchive] : %s is not a valid shader archive", filename);
+                Close();
+                return false;
+            }
+
+            LOG(success, "[ShaderArchive] : Mapped %u modules (%u bytes) from %s", moduleCount, static_cast<uint>(file.size), filename);
+            return true;
+        }
+
+        /**
+         * @brief get name of module at index
+         *
+         * @param idx must be less than moduleCount
+         * @return const char* null terminated name
+         */
+        [[nodiscard]] inline const char* GetName(const uint32& idx) const{
+            return names + entries[idx].nameOffset;
+        }
+
+        /**
+         * @brief find a module by name
+         *
+         * @param name of module
+         * @return Code pointing into the mapping, words is nullptr if there is no such module
+         */
+        [[nodiscard]] inline Code Find(const char* name) const{
+            const Entry* end = entries + moduleCount;
+            const Entry* entry = std::lower_bound(entries, end, name, [this](const Entry& e, const char* n){
+                return strcmp(names + e.nameOffset, n) < 0;
+            });
+
+            Code code;
+            if(entry != end && strcmp(names + entry->nameOffset, name) == 0){
+                code.words = reinterpret_cast<const uint32*>(static_cast<const uint8*>(file.data) + entry->codeOffset);
+                code.size = entry->codeSize;
+            }
+
+            // return
+            return code;
+        }
+
+        /**
+         * @brief create a shader module directly from the mapped archive
+         *
+         * @param device
+         * @param name of module
+         * @param allocator
+         * @return VkShaderModule
+         */
+        [[nodiscard]] inline VkShaderModule CreateShaderModule(const VkDevice& device, const char* name, const VkAllocationCallbacks* allocator = nullptr) const{
+            Code code = Find(name);
+            ASSERT(code.words != nullptr, "[ShaderArchive] : No module named %s in archive", name);
+
+            // return
+            return Vulkan::CreateShaderModule(device, Init::ShaderModuleCreateInfo(code.words, code.size), allocator);
+        }
+
+        /// unmap archive
+        inline void Close(){
+            file.Close();
+            entries = nullptr;
+            names = nullptr;
+            moduleCount = 0;
+        }
+
+    private:
+        /// check that every offset in the index stays inside the file
+        [[nodiscard]] inline bool Validate(){
+            if(file.size < sizeof(Header)) return false;
+
+            // mapping is at least 4 byte aligned and every field is a uint32
+            const Header* header = static_cast<const Header*>(file.data);
+            if(header->magic != magic || header->version != version) return false;
+
+            // index and name table
+            uint64 indexSize = sizeof(Header) + static_cast<uint64>(header->moduleCount) * sizeof(Entry);
+            if(indexSize + header->namesSize > file.size) return false;
+
+            const Entry* index = reinterpret_cast<const Entry*>(header + 1);
+            const char* table = static_cast<const char*>(file.data) + indexSize;
+
+            for(uint32 i = 0; i < header->moduleCount; i++){
+                const Entry& entry = index[i];
+
+                // name must be null terminated inside the name table
+                if(static_cast<uint64>(entry.nameOffset) + entry.nameSize >= header->namesSize) return false;
+                if(table[entry.nameOffset + entry.nameSize] != '\0') return false;
+
+                // names must be sorted for lookup
+                if(i > 0 && strcmp(table + index[i - 1].nameOffset, table + entry.nameOffset) >= 0) return false;
+
+                // code must be inside the file and be spir-v
+                if(static_cast<uint64>(entry.codeOffset) + entry.codeSize > file.size) return false;
+                if(!Tools::IsSpirvCode(static_cast<const uint8*>(file.data) + entry.codeOffset, entry.codeSize)) return false;
+            }
+
+            entries = index;
+            names = table;
+            moduleCount = header->moduleCount;
+            return true;
+        }
+    };
+
+    /**
+     * @brief Packs spir-v modules into a ShaderArchive file.
+     *        Usually run as an offline build step after shader compilation.
+     *
+     */
+    struct ShaderArchiveWriter{
+        /// module to be written
+        struct Module{
+            std::string name;
+            std::vector<uint32> code;
+        };
+
+        /// modules added so far
+        std::vector<Module> modules;
+
+        /**
+         * @brief add a module, replacing any module with same name
+         *
+         * @param name used to look module up in archive
+         * @param code spir-v words
+         * @param codeSize size of code in bytes, must be a multiple of 4
+         */
+        inline void Add(const char* name, const uint32* code, const size_t& codeSize){
+            ASSERT(Tools::IsSpirvCode(code, codeSize), "[ShaderArchiveWriter] : Module %s is not valid spir-v", name);
+
+            auto it = std::find_if(modules.begin(), modules.end(), [name](const Module& module){
+                return module.name == name;
+            });
+            if(it == modules.end()) it = modules.insert(modules.end(), Module{name, {}});
+
+            it->code.assign(code, code + codeSize / sizeof(uint32));
+        }
+
+        /**
+         * @brief add a module from a spir-v file
+         *
+         * @param name used to look module up in archive
+         * @param filename of spir-v file
+         * @return true if file was added
+         * @return false if file couldn't be opened or isn't spir-v
+         */
+        inline bool AddFile(const char* name, const char* filename){
+            Tools::MappedFile file;
+            if(!file.Open(filename) || !Tools::IsSpirvCode(file.data, file.size)){
+                LOG(error, "[ShaderArchiveWriter] : %s is not a valid spir-v file", filename);
+                return false;
+            }
+
+            Add(name, static_cast<const uint32*>(file.data), file.size);
+            return true;
+        }
+
+        /**
+         * @brief write archive to disk. Data is written to a temporary file first
+         *        which is then renamed over the archive.
+         *
+         * @param filename of archive
+         * @return true if archive was written
+         * @return false otherwise
+         */
+        inline bool Write(const char* filename) const{
+            // archive lookup needs entries sorted by name
+            std::vector<const Module*> sorted;
+            sorted.reserve(modules.size());
+            for(const Module& module : modules) sorted.push_back(&module);
+            std::sort(sorted.begin(), sorted.end(), [](const Module* a, const Module* b){
+                return a->name < b->name;
+            });
+
+            // build index and name table
+            std::vector<ShaderArchive::Entry> entries(sorted.size());
+            std::string names;
+            for(size_t i = 0; i < sorted.size(); i++){
+                entries[i].nameOffset = static_cast<uint32>(names.size());
+                entries[i].nameSize = static_cast<uint32>(sorted[i]->name.size());
+                names += sorted[i]->name;
+                names += '\0';
+            }
+            names.resize((names.size() + sizeof(uint32) - 1) & ~(sizeof(uint32) - 1), '\0');
+
+            // code follows name table
+            size_t offset = sizeof(ShaderArchive::Header) + entries.size() * sizeof(ShaderArchive::Entry) + names.size();
+            for(size_t i = 0; i < sorted.size(); i++){
+                entries[i].codeOffset = static_cast<uint32>(offset);
+                entries[i].codeSize = static_cast<uint32>(sorted[i]->code.size() * sizeof(uint32));
+                offset += entries[i].codeSize;
+            }
+
+            ShaderArchive::Header header = {};
+            header.magic = ShaderArchive::magic;
+            header.version = ShaderArchive::version;
+            header.moduleCount = static_cast<uint32>(entries.size());
+            header.namesSize = static_cast<uint32>(names.size());
+
+            std::string tmpFilename = std::string(filename) + ".tmp";
+            FILE* file = fopen(tmpFilename.c_str(), "wb");
+            if(file == nullptr){
+                LOG(error, "[ShaderArchiveWriter] : Failed to open %s for writing", tmpFilename.c_str());
+                return false;
+            }
+
+            bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+            if(!entries.empty()) written = (fwrite(entries.data(), sizeof(ShaderArchive::Entry), entries.size(), file) == entries.size()) && written;
+            written = (fwrite(names.data(), 1, names.size(), file) == names.size()) && written;
+            for(const Module* module : sorted){
+                written = (fwrite(module->code.data(), sizeof(uint32), module->code.size(), file) == module->code.size()) && written;
+            }
+            written = (fflush(file) == 0) && written;
+            fclose(file);
+
+            if(!written){
+                LOG(error, "[ShaderArchiveWriter] : Failed to write %s", tmpFilename.c_str());
+                std::remove(tmpFilename.c_str());
+                return false;
+            }
+
+        #ifndef VULKAN_HELPER_MAPPED_FILE_USE_MMAP
+            // rename doesn't replace existing files here
+            std::remove(filename);
+        #endif
+            if(std::rename(tmpFilename.c_str(), filename) != 0){
+                LOG(error, "[ShaderArchiveWriter] : Failed to rename %s to %s", tmpFilename.c_str(), filename);
+                std::remove(tmpFilename.c_str());
+                return false;
+            }
+
+            LOG(success, "[ShaderArchiveWriter] : Wrote %u modules (%u bytes) to %s", static_cast<uint>(entries.size()), static_cast<uint>(offset), filename);
+            return true;
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_SHADER_ARCHIVE_HPP
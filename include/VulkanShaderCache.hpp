@@ -0,0 +1,340 @@
+/**
+ * @file VulkanShaderCache.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Reference counted shader module cache keyed by code hash, with optional hot reload.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_SHADER_CACHE_HPP
+#define VULKAN_HELPER_VULKAN_SHADER_CACHE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+#include "VulkanTools.hpp"
+
+// use inotify to watch shader files where it is available
+#if defined(__linux__)
+    #define VULKAN_HELPER_SHADER_CACHE_USE_INOTIFY
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace Vulkan{
+
+    /**
+     * @brief Shader module cache. Modules are keyed by the XXH64 hash of their code,
+     *        so pipelines sharing the same spir-v share one VkShaderModule no matter
+     *        where the code came from.
+     *
+     *        Every Acquire must be paired with a Release once the pipelines using the
+     *        module are built. A module is destroyed when its last reference is released.
+     *
+     *        Watch registers a rebuild function for a spir-v file. When the file is
+     *        rewritten on disk the function is called on a background thread, where it
+     *        can Acquire the new code and rebuild its pipelines. Watching needs inotify
+     *        and does nothing on other platforms.
+     *
+     */
+    struct ShaderModuleCache{
+        /// called on watcher thread with the name of the file that changed
+        using RebuildFunction = std::function<void(const std::string& filename)>;
+
+        /// cached module
+        struct Entry{
+            VkShaderModule module = VK_NULL_HANDLE;
+            uint32 refCount = 0;
+        };
+
+        /// a rebuild function registered for a file
+        struct WatchedFile{
+            std::string filename;
+            RebuildFunction rebuild;
+        };
+
+        /// a watched directory and the watched files in it, by file name
+        struct WatchedDirectory{
+            std::string path;
+            std::unordered_map<std::string, std::vector<WatchedFile>> files;
+        };
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// modules by code hash
+        std::unordered_map<uint64, Entry> modules;
+
+        /// code hash by module, for Release
+        std::unordered_map<VkShaderModule, uint64> hashes;
+
+        /// guards modules and hashes
+        std::mutex mutex;
+
+        /// number of Acquire calls
+        std::atomic<uint32> requests = 0;
+
+        /// number of modules actually created
+        std::atomic<uint32> created = 0;
+
+        /// watched directories by inotify watch descriptor
+        std::unordered_map<int, WatchedDirectory> directories;
+
+        /// guards directories
+        std::mutex watchMutex;
+
+        /// inotify instance, -1 until first Watch
+        int inotifyFd = -1;
+
+        /// background thread calling rebuild functions
+        std::thread watcher;
+
+        /// cleared to stop watcher thread
+        std::atomic<bool> watching = false;
+
+        /**
+         * @brief initialize cache
+         *
+         * @param device
+         */
+        inline void Init(const VkDevice& device){
+            this->device = device;
+        }
+
+        /**
+         * @brief get a module for code, creating it only if no module with same code exists
+         *
+         * @param code spir-v words
+         * @param codeSize size of code in bytes
+         * @return VkShaderModule, must be given back with Release
+         */
+        [[nodiscard]] inline VkShaderModule Acquire(const uint32* code, const size_t& codeSize){
+            ASSERT(Tools::IsSpirvCode(code, codeSize), "[ShaderModuleCache] : Code is not valid spir-v");
+
+            // hash outside of lock
+            uint64 hash = HashBytes(code, codeSize);
+            requests++;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            Entry& entry = modules[hash];
+            if(entry.module == VK_NULL_HANDLE){
+                entry.module = CreateShaderModule(device, Init::ShaderModuleCreateInfo(code, codeSize));
+                hashes[entry.module] = hash;
+                created++;
+            }
+            entry.refCount++;
+
+            // return
+            return entry.module;
+        }
+
+        /**
+         * @brief get a module for a spir-v file. File is mapped, not copied.
+         *        Doesn't assert on a bad file, since a file may be caught half
+         *        written while hot reloading.
+         *
+         * @param filename of spir-v file
+         * @return VkShaderModule, VK_NULL_HANDLE if file couldn't be read or isn't spir-v
+         */
+        [[nodiscard]] inline VkShaderModule Acquire(const char* filename){
+            Tools::MappedFile file;
+            if(!file.Open(filename) || !Tools::IsSpirvCode(file.data, file.size)){
+                LOG(error, "[ShaderModuleCache] : %s is not a valid spir-v file", filename);
+                return VK_NULL_HANDLE;
+            }
+
+            // return
+            return Acquire(static_cast<const uint32*>(file.data), file.size);
+        }
+
+        /**
+         * @brief give back a module, destroying it if this was the last reference.
+         *        Pipelines don't need their shader modules after creation.
+         *
+         * @param module returned by Acquire
+         */
+        inline void Release(const VkShaderModule& module){
+            std::lock_guard<std::mutex> lock(mutex);
+            auto hash = hashes.find(module);
+            ASSERT(hash != hashes.end(), "[ShaderModuleCache] : Released module was not acquired from this cache");
+
+            auto entry = modules.find(hash->second);
+            if(--entry->second.refCount == 0){
+                DestroyShaderModule(device, module);
+                modules.erase(entry);
+                hashes.erase(hash);
+            }
+        }
+
+        /**
+         * @brief call rebuild on a background thread whenever file is rewritten
+         *
+         * @param filename of spir-v file
+         * @param rebuild function that rebuilds pipelines using the file
+         * @return true if file is being watched
+         * @return false if file can't be watched
+         */
+        inline bool Watch(const char* filename, const RebuildFunction& rebuild){
+        #ifdef VULKAN_HELPER_SHADER_CACHE_USE_INOTIFY
+            // editors often replace files instead of writing them, so watch the directory
+            std::string path = filename;
+            size_t slash = path.find_last_of('/');
+            std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+            std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+            std::lock_guard<std::mutex> lock(watchMutex);
+            if(inotifyFd < 0){
+                inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+                if(inotifyFd < 0){
+                    LOG(error, "[ShaderModuleCache] : Failed to create inotify instance");
+                    return false;
+                }
+            }
+
+            // same directory always gives same watch descriptor
+            int wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if(wd < 0){
+                LOG(error, "[ShaderModuleCache] : Failed to watch directory %s", directory.c_str());
+                return false;
+            }
+
+            WatchedDirectory& watched = directories[wd];
+            watched.path = directory;
+            watched.files[name].push_back(WatchedFile{filename, rebuild});
+
+            // start watcher with first watch
+            if(!watching){
+                watching = true;
+                watcher = std::thread(&ShaderModuleCache::WatchLoop, this);
+            }
+
+            LOG(success, "[ShaderModuleCache] : Watching %s", filename);
+            return true;
+        #else
+            LOG(warning, "[ShaderModuleCache] : Hot reload is not supported on this platform, %s is not watched", filename);
+            return false;
+        #endif
+        }
+
+        /**
+         * @brief get fraction of requests that were served by an existing module
+         *
+         * @return float between 0 and 1
+         */
+        [[nodiscard]] inline float DedupeRatio() const{
+            uint32 total = requests;
+            return total ? 1.0f - static_cast<float>(created) / static_cast<float>(total) : 0.0f;
+        }
+
+        /// print number of requests, created modules and dedupe ratio
+        inline void PrintStats() const{
+            printf("[ShaderModuleCache] : requests = %u | created = %u | dedupe ratio = %.3f\n", requests.load(), created.load(), DedupeRatio());
+        }
+
+        /**
+         * @brief stop watching files and destroy modules that are still referenced
+         *
+         */
+        inline void Destroy(){
+            // stop watcher first, rebuild functions may still Acquire
+            if(watching){
+                watching = false;
+                watcher.join();
+            }
+        #ifdef VULKAN_HELPER_SHADER_CACHE_USE_INOTIFY
+            if(inotifyFd >= 0) close(inotifyFd);
+        #endif
+            inotifyFd = -1;
+            directories.clear();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!modules.empty()){
+                LOG(warning, "[ShaderModuleCache] : %u modules were never released", static_cast<uint>(modules.size()));
+            }
+            for(const auto& [hash, entry] : modules) DestroyShaderModule(device, entry.module);
+            modules.clear();
+            hashes.clear();
+        }
+
+    private:
+    #ifdef VULKAN_HELPER_SHADER_CACHE_USE_INOTIFY
+        /// wait for file changes and call rebuild functions, runs on watcher thread
+        inline void WatchLoop(){
+            alignas(inotify_event) char buffer[4096];
+
+            while(watching){
+                // wake up regularly to check if we should stop
+                pollfd pfd = {inotifyFd, POLLIN, 0};
+                if(poll(&pfd, 1, 100) <= 0) continue;
+
+                // a compiler may write a file more than once, so collect unique changes first
+                std::vector<std::pair<int, std::string>> changes;
+                ssize_t length;
+                while((length = read(inotifyFd, buffer, sizeof(buffer))) > 0){
+                    for(char* ptr = buffer; ptr < buffer + length; ){
+                        const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+                        ptr += sizeof(inotify_event) + event->len;
+                        if(event->len == 0) continue;
+
+                        std::pair<int, std::string> change(event->wd, event->name);
+                        if(std::find(changes.begin(), changes.end(), change) == changes.end()) changes.push_back(change);
+                    }
+                }
+
+                // copy functions so Watch can be called from inside them
+                std::vector<WatchedFile> rebuilds;
+                {
+                    std::lock_guard<std::mutex> lock(watchMutex);
+                    for(const auto& [wd, name] : changes){
+                        auto directory = directories.find(wd);
+                        if(directory == directories.end()) continue;
+
+                        auto file = directory->second.files.find(name);
+                        if(file == directory->second.files.end()) continue;
+
+                        rebuilds.insert(rebuilds.end(), file->second.begin(), file->second.end());
+                    }
+                }
+
+                for(const WatchedFile& watch : rebuilds){
+                    LOG(info, "[ShaderModuleCache] : %s changed, rebuilding", watch.filename.c_str());
+                    watch.rebuild(watch.filename);
+                }
+            }
+        }
+    #else
+        /// nothing to watch without inotify
+        inline void WatchLoop(){}
+    #endif
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_SHADER_CACHE_HPP
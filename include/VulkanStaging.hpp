@@ -0,0 +1,287 @@
+/**
+ * @file VulkanStaging.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Persistently mapped staging ring buffer for streaming uploads to device local buffers.
+ * @version 0.1
+ * @date 2021-05-04
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_STAGING_HPP
+#define VULKAN_HELPER_VULKAN_STAGING_HPP
+
+#include <deque>
+#include <unordered_map>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+#include "VulkanInitializers.hpp"
+#include "VulkanMemory.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief Staging ring buffer.
+     *        One host visible + host coherent buffer is mapped once and slices of it are
+     *        handed out every frame. Copies are batched per destination buffer and recorded
+     *        as one vkCmdCopyBuffer each. Slices of a frame are recycled once the fence of
+     *        that frame signals.
+     *
+     *        Usage every frame :
+     *          ring.BeginFrame();
+     *          ring.Upload(vertexBuffer, 0, vertices, verticesSize);
+     *          ring.Record(cmd);
+     *          Vulkan::QueueSumbit(queue, {submitInfo}, ring.EndFrame());
+     *
+     */
+    struct StagingRing{
+        /**
+         * @brief part of ring that can be written to
+         *
+         */
+        struct Slice{
+            /// host pointer to write data to
+            void* data = nullptr;
+
+            /// offset of slice in staging buffer
+            VkDeviceSize offset = 0;
+
+            /// size of slice
+            VkDeviceSize size = 0;
+        };
+
+        /**
+         * @brief bookkeeping for a frame in flight
+         *
+         */
+        struct Frame{
+            /// signaled when copies of this frame are done
+            VkFence fence = VK_NULL_HANDLE;
+
+            /// ring position at the end of this frame
+            uint64 end = 0;
+        };
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// memory allocator staging buffer is allocated from
+        Memory* memory = nullptr;
+
+        /// staging buffer
+        VkBuffer buffer = VK_NULL_HANDLE;
+
+        /// memory of staging buffer
+        Memory::Allocation allocation;
+
+        /// size of staging buffer
+        VkDeviceSize capacity = 0;
+
+        /// total number of bytes ever handed out (monotonic), head % capacity is write offset
+        uint64 head = 0;
+
+        /// total number of bytes ever released (monotonic)
+        uint64 tail = 0;
+
+        /// one entry for each frame in flight
+        std::vector<Frame> frames;
+
+        /// index of frame being recorded
+        uint32 frameIdx = 0;
+
+        /// frames submitted but not yet waited for, oldest first
+        std::deque<uint32> inFlight;
+
+        /// copies waiting to be recorded for each destination buffer
+        std::unordered_map<VkBuffer, std::vector<VkBufferCopy>> pendingCopies;
+
+        /// number of bytes uploaded since initialization
+        uint64 uploadedBytes = 0;
+
+        /// number of times an upload had to wait for the GPU because ring was full
+        uint64 stallCount = 0;
+
+        /**
+         * @brief create staging buffer and per frame fences
+         *
+         * @param device
+         * @param memory allocator to allocate staging buffer from
+         * @param capacity size of ring in bytes, should fit uploads of all frames in flight.
+         *        must be a multiple of the largest alignment used with Allocate
+         * @param framesInFlight number of frames that can be in flight at once
+         */
+        inline void Init(const VkDevice& device, Memory& memory, const VkDeviceSize& capacity, const uint32& framesInFlight = 2){
+            this->device = device;
+            this->memory = &memory;
+            this->capacity = capacity;
+
+            // create persistently mapped staging buffer
+            buffer = CreateBuffer(device, Vulkan::Init::BufferCreateInfo(capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT));
+            allocation = memory.AllocateBufferMemory(buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            ASSERT(allocation.mapped != nullptr, "[StagingRing] : Staging memory is not mapped");
+
+            // fences start signaled so the first wait on them returns immediately
+            frames.resize(framesInFlight);
+            for(auto& frame : frames){
+                frame.fence = CreateFence(device, Vulkan::Init::FenceCreateInfo(VK_FENCE_CREATE_SIGNALED_BIT));
+            }
+
+            head = tail = 0;
+            frameIdx = 0;
+        }
+
+        /**
+         * @brief start a new frame. Waits for the frame that used this slot before
+         *        and recycles its slices.
+         *
+         */
+        inline void BeginFrame(){
+            frameIdx = (frameIdx + 1) % static_cast<uint32>(frames.size());
+
+            // if this slot is still in flight then wait for it and everything before it
+            if(std::find(inFlight.begin(), inFlight.end(), frameIdx) != inFlight.end()){
+                uint32 oldest;
+                do{
+                    oldest = inFlight.front();
+                    ReleaseOldest();
+                }while(oldest != frameIdx);
+            }
+
+            ResetFence(device, frames[frameIdx].fence);
+        }
+
+        /**
+         * @brief get an aligned slice of ring to write into.
+         *        If ring is full then this waits for the oldest frame in flight.
+         *
+         * @param size of slice in bytes
+         * @param alignment of slice offset, must be a power of two
+         * @return Slice
+         */
+        [[nodiscard]] inline Slice Allocate(const VkDeviceSize& size, const VkDeviceSize& alignment = 16){
+            ASSERT(size <= capacity, "[StagingRing] : Upload of %" PRIu64 " bytes doesn't fit in ring of %" PRIu64 " bytes",
+                static_cast<uint64>(size), static_cast<uint64>(capacity));
+
+            while(true){
+                // align write position
+                uint64 start = (head + alignment - 1) & ~(static_cast<uint64>(alignment) - 1);
+
+                // slices never wrap, skip to beginning of buffer instead
+                VkDeviceSize offset = start % capacity;
+                if(offset + size > capacity){
+                    start += capacity - offset;
+                    offset = 0;
+                }
+
+                // check if there is enough free space
+                if(start + size - tail <= capacity){
+                    head = start + size;
+                    uploadedBytes += size;
+                    return Slice{static_cast<uint8*>(allocation.mapped) + offset, offset, size};
+                }
+
+                // ring is full, wait for oldest frame
+                ASSERT(!inFlight.empty(), "[StagingRing] : Ring is full with uploads of current frame, increase capacity");
+                stallCount++;
+                ReleaseOldest();
+            }
+        }
+
+        /**
+         * @brief queue a copy from a slice to a buffer
+         *
+         * @param slice written slice
+         * @param dstBuffer destination buffer, must have TRANSFER_DST usage
+         * @param dstOffset offset in destination buffer
+         */
+        inline void Copy(const Slice& slice, const VkBuffer& dstBuffer, const VkDeviceSize& dstOffset){
+            pendingCopies[dstBuffer].push_back(VkBufferCopy{slice.offset, dstOffset, slice.size});
+        }
+
+        /**
+         * @brief copy data to ring and queue a copy to destination buffer
+         *
+         * @param dstBuffer destination buffer, must have TRANSFER_DST usage
+         * @param dstOffset offset in destination buffer
+         * @param data to upload
+         * @param size of data in bytes
+         * @param alignment of slice in staging buffer
+         */
+        inline void Upload(const VkBuffer& dstBuffer, const VkDeviceSize& dstOffset, const void* data, const VkDeviceSize& size, const VkDeviceSize& alignment = 16){
+            Slice slice = Allocate(size, alignment);
+            memcpy(slice.data, data, size);
+            Copy(slice, dstBuffer, dstOffset);
+        }
+
+        /**
+         * @brief record all queued copies, one vkCmdCopyBuffer per destination buffer
+         *
+         * @param cmdBuffer command buffer in recording state
+         */
+        inline void Record(const VkCommandBuffer& cmdBuffer){
+            for(auto& [dstBuffer, regions] : pendingCopies){
+                if(regions.empty()) continue;
+                CmdCopyBuffer(cmdBuffer, buffer, dstBuffer, regions);
+                // keep vector capacity for next frame
+                regions.clear();
+            }
+        }
+
+        /**
+         * @brief end current frame.
+         *
+         * @return VkFence : must be passed to the queue submit that executes recorded copies
+         */
+        [[nodiscard]] inline VkFence EndFrame(){
+            frames[frameIdx].end = head;
+            inFlight.push_back(frameIdx);
+            return frames[frameIdx].fence;
+        }
+
+        /**
+         * @brief wait for all frames and destroy staging buffer
+         *
+         */
+        inline void Destroy(){
+            while(!inFlight.empty()) ReleaseOldest();
+
+            for(auto& frame : frames){
+                DestroyFence(device, frame.fence);
+            }
+            frames.clear();
+
+            DestroyBuffer(device, buffer);
+            memory->Free(allocation);
+            buffer = VK_NULL_HANDLE;
+        }
+
+    private:
+        /// wait for oldest frame in flight and release its slices
+        inline void ReleaseOldest(){
+            Frame& frame = frames[inFlight.front()];
+            WaitForFence(device, frame.fence, UINT64_MAX);
+            tail = frame.end;
+            inFlight.pop_front();
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_STAGING_HPP
@@ -0,0 +1,238 @@
+/**
+ * @file VulkanTimeline.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Timeline semaphore based queue submission scheduler.
+ * @version 0.1
+ * @date 2021-05-10
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_VULKAN_TIMELINE_HPP
+#define VULKAN_HELPER_VULKAN_TIMELINE_HPP
+
+#include <atomic>
+#include <mutex>
+#include <vulkan/vulkan_core.h>
+#include "Core.hpp"
+#include "Vulkan.hpp"
+
+namespace Vulkan{
+
+    /**
+     * @brief a point on a timeline, work is done when semaphore reaches value
+     *
+     */
+    struct TimelinePoint{
+        /// timeline semaphore
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+
+        /// value semaphore is signaled with when work is done
+        uint64 value = 0;
+    };
+
+    /**
+     * @brief semaphore a submission waits on
+     *
+     */
+    struct TimelineWait{
+        /// timeline or binary semaphore
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+
+        /// value to wait for, ignored for binary semaphores
+        uint64 value = 0;
+
+        /// stages that wait
+        VkPipelineStageFlags stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+        TimelineWait() = default;
+        TimelineWait(const TimelinePoint& point, const VkPipelineStageFlags& stage) : semaphore(point.semaphore), value(point.value), stage(stage) {}
+        TimelineWait(const VkSemaphore& binarySemaphore, const VkPipelineStageFlags& stage) : semaphore(binarySemaphore), stage(stage) {}
+    };
+
+    /**
+     * @brief Submission scheduler for one queue.
+     *        Every submission signals one timeline semaphore with a monotonically
+     *        increasing value, so "is submission N done" becomes "is counter >= N".
+     *        This replaces a pool of fences : no fence resets, one wait for any
+     *        amount of work, and other queues can wait on a TimelinePoint directly.
+     *
+     *        Requires Vulkan 1.2 with timelineSemaphore feature enabled.
+     *
+     */
+    struct TimelineScheduler{
+        /// maximum number of wait or signal semaphores in one submission
+        static constexpr size_t maxSemaphores = 16;
+
+        /// device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// queue submissions are made to
+        VkQueue queue = VK_NULL_HANDLE;
+
+        /// timeline semaphore of queue
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+
+        /// value signaled by last submission
+        uint64 submittedValue = 0;
+
+        /// last value read back from semaphore
+        std::atomic<uint64> completedValue = 0;
+
+        /// queue is externally synchronized
+        std::mutex mutex;
+
+        /**
+         * @brief create timeline semaphore for queue
+         *
+         * @param device
+         * @param queue
+         */
+        inline void Init(const VkDevice& device, const VkQueue& queue){
+            this->device = device;
+            this->queue = queue;
+            semaphore = CreateTimelineSemaphore(device, 0);
+            submittedValue = completedValue = 0;
+        }
+
+        /**
+         * @brief submit command buffers. Thread safe.
+         *
+         * @param cmdBuffers command buffers to execute
+         * @param waits semaphores (timeline points of other queues or binary semaphores) to wait for
+         * @param binarySignals binary semaphores to signal as well (eg. for presentation)
+         * @return TimelinePoint : point that is reached when this submission completes
+         */
+        inline TimelinePoint Submit(const Span<VkCommandBuffer>& cmdBuffers, const Span<TimelineWait>& waits = {}, const Span<VkSemaphore>& binarySignals = {}){
+            ASSERT(waits.size() <= maxSemaphores && binarySignals.size() < maxSemaphores, "[TimelineScheduler] : Too many semaphores in one submission");
+
+            // split waits in parallel arrays
+            InlineVector<VkSemaphore, maxSemaphores> waitSemaphores;
+            InlineVector<uint64, maxSemaphores> waitValues;
+            InlineVector<VkPipelineStageFlags, maxSemaphores> waitStages;
+            for(const auto& wait : waits){
+                waitSemaphores.push_back(wait.semaphore);
+                waitValues.push_back(wait.value);
+                waitStages.push_back(wait.stage);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            uint64 value = ++submittedValue;
+
+            // timeline semaphore first, values of binary semaphores are ignored
+            InlineVector<VkSemaphore, maxSemaphores> signalSemaphores = {semaphore};
+            InlineVector<uint64, maxSemaphores> signalValues = {value};
+            for(const auto& binarySignal : binarySignals){
+                signalSemaphores.push_back(binarySignal);
+                signalValues.push_back(0);
+            }
+
+            VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+            timelineInfo.sType                      = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timelineInfo.waitSemaphoreValueCount    = waitValues.size();
+            timelineInfo.pWaitSemaphoreValues       = waitValues.data();
+            timelineInfo.signalSemaphoreValueCount  = signalValues.size();
+            timelineInfo.pSignalSemaphoreValues     = signalValues.data();
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.pNext                = &timelineInfo;
+            submitInfo.waitSemaphoreCount   = waitSemaphores.size();
+            submitInfo.pWaitSemaphores      = waitSemaphores.data();
+            submitInfo.pWaitDstStageMask    = waitStages.data();
+            submitInfo.commandBufferCount   = cmdBuffers.size();
+            submitInfo.pCommandBuffers      = cmdBuffers.data();
+            submitInfo.signalSemaphoreCount = signalSemaphores.size();
+            submitInfo.pSignalSemaphores    = signalSemaphores.data();
+
+            QueueSumbit(queue, submitInfo, VK_NULL_HANDLE);
+
+            // return
+            return TimelinePoint{semaphore, value};
+        }
+
+        /**
+         * @brief point reached when all work submitted so far completes
+         *
+         * @return TimelinePoint
+         */
+        [[nodiscard]] inline TimelinePoint LastPoint(){
+            std::lock_guard<std::mutex> lock(mutex);
+            return TimelinePoint{semaphore, submittedValue};
+        }
+
+        /**
+         * @brief read back value of timeline semaphore
+         *
+         * @return uint64 : all submissions with value <= this are done
+         */
+        inline uint64 GetCompletedValue(){
+            completedValue = GetSemaphoreCounterValue(device, semaphore);
+            return completedValue;
+        }
+
+        /**
+         * @brief check if work up to a value is done, without waiting
+         *
+         * @param value returned by Submit
+         * @return true if done
+         * @return false otherwise
+         */
+        [[nodiscard]] inline bool IsComplete(const uint64& value){
+            // avoid querying the driver if cached value is enough
+            return value <= completedValue || value <= GetCompletedValue();
+        }
+
+        /**
+         * @brief wait on host for work up to value to be done
+         *
+         * @param value returned by Submit
+         * @param timeout in nanoseconds
+         * @return true if done
+         * @return false if timeout happened
+         */
+        inline bool Wait(const uint64& value, const uint64& timeout = UINT64_MAX){
+            if(value <= completedValue) return true;
+            if(!WaitSemaphores(device, semaphore, value, timeout)) return false;
+            GetCompletedValue();
+            return true;
+        }
+
+        /**
+         * @brief wait for all submitted work
+         *
+         */
+        inline void WaitIdle(){
+            Wait(LastPoint().value);
+        }
+
+        /**
+         * @brief wait for all work and destroy semaphore
+         *
+         */
+        inline void Destroy(){
+            WaitIdle();
+            DestroySemaphore(device, semaphore);
+            semaphore = VK_NULL_HANDLE;
+        }
+    };
+
+} // namespace Vulkan
+
+#endif//VULKAN_HELPER_VULKAN_TIMELINE_HPP
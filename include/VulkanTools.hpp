@@ -30,9 +30,21 @@
 #include "Core.hpp"
 #include <vulkan/vulkan.h>
 #include <fstream>
-#include <SDL2/SDL.h>
 #include "Vulkan.hpp"
 
+#ifndef SETTING_DONT_USE_SDL
+    #include <SDL2/SDL.h>
+#endif//SETTING_DONT_USE_SDL
+
+// use mmap for MappedFile where it is available
+#if defined(__unix__) || defined(__APPLE__)
+    #define VULKAN_HELPER_MAPPED_FILE_USE_MMAP
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
 // vulkan namespace
 namespace Vulkan{
     
@@ -120,8 +132,9 @@ namespace Vulkan{
                     swapchainExtensionAvailable = true;
             }
 
-            // no swapchain means no multi-image rendering
-            if(!swapchainExtensionAvailable)
+            // no swapchain means no multi-image rendering,
+            // which only matters when there is a surface to present to
+            if(surface != VK_NULL_HANDLE && !swapchainExtensionAvailable)
                 score = 0;
 
             // if surface handle is given
@@ -255,12 +268,12 @@ namespace Vulkan{
         /**
         * @brief Get the swapchain surface image extent.
         * 
-        * @param width of window that contains the surface
-        * @param height of window that contains the surface
+        * @param windowExtent size of window that contains the surface, used only
+        *        when surface doesn't dictate the extent
         * @param capabilities is surface capabilities of surface
         * @return VkExtent2D containing extent of image
         */
-        [[nodiscard]] inline VkExtent2D SelectSwapchainSurfaceImageExtent(SDL_Window* window, const VkSurfaceCapabilitiesKHR& capabilities){
+        [[nodiscard]] inline VkExtent2D SelectSwapchainSurfaceImageExtent(const VkExtent2D& windowExtent, const VkSurfaceCapabilitiesKHR& capabilities){
             // in displays with low dpi
             if(capabilities.currentExtent.width != UINT32_MAX){
                 printf("[SelectSwapchainSurfaceImageExtent] : w = %i | h = %i\n", capabilities.currentExtent.width, capabilities.currentExtent.height);
@@ -268,11 +281,7 @@ namespace Vulkan{
             }
 
             // in displays with high dpi
-            int w, h;
-            SDL_GetWindowSize(window, &w, &h);
-
-            // extent
-            VkExtent2D extent{static_cast<uint32>(w), static_cast<uint32>(h)};
+            VkExtent2D extent = windowExtent;
 
             // clamp extent width and height
             extent.width = std::max(capabilities.minImageExtent.width, 
@@ -285,38 +294,206 @@ namespace Vulkan{
             return extent;
         }
 
+#ifndef SETTING_DONT_USE_SDL
         /**
-        * @brief Get the shader spirv code
+        * @brief Get the swapchain surface image extent.
         * 
-        * @param filename of file containing spirv code
-        * @return std::vector<uint32> binary code
+        * @param window that contains the surface
+        * @param capabilities is surface capabilities of surface
+        * @return VkExtent2D containing extent of image
         */
-        [[nodiscard]] inline static std::vector<char> LoadShaderCode(const char* filename){
-            // open file in binary mode from the end
-            std::ifstream file(filename, std::ios::ate | std::ios::binary);
+        [[nodiscard]] inline VkExtent2D SelectSwapchainSurfaceImageExtent(SDL_Window* window, const VkSurfaceCapabilitiesKHR& capabilities){
+            int w, h;
+            SDL_GetWindowSize(window, &w, &h);
+            return SelectSwapchainSurfaceImageExtent(VkExtent2D{static_cast<uint32>(w), static_cast<uint32>(h)}, capabilities);
+        }
+#endif//SETTING_DONT_USE_SDL
 
-            // check if file is open or not
-            ASSERT(file.is_open(), "\tUnable to open shader code file %s", filename);
+        /**
+        * @brief Read only memory mapping of a whole file.
+        *        On POSIX systems the file is mmap'ed, elsewhere it is read into a
+        *        buffer. Either way the data is at least 4 byte aligned.
+        * 
+        */
+        struct MappedFile{
+            /// pointer to file contents, nullptr if no file is open
+            const void* data = nullptr;
+
+            /// size of file in bytes
+            size_t size = 0;
+
+        #ifndef VULKAN_HELPER_MAPPED_FILE_USE_MMAP
+            /// file contents when mmap is not available
+            std::vector<uint32> buffer;
+        #endif
 
-            // code size
-            std::size_t codeSize = static_cast<std::size_t>(file.tellg());
+            MappedFile() = default;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
 
-            // code 
-            std::vector<char> shaderCode(codeSize);
+            /// unmap on destruction
+            ~MappedFile(){
+                Close();
+            }
+
+            /**
+            * @brief map a file
+            * 
+            * @param filename 
+            * @return true if file was mapped
+            * @return false if file doesn't exist or is empty
+            */
+            [[nodiscard]] inline bool Open(const char* filename){
+                Close();
+            #ifdef VULKAN_HELPER_MAPPED_FILE_USE_MMAP
+                int fd = open(filename, O_RDONLY);
+                if(fd < 0) return false;
+
+                struct stat st;
+                if(fstat(fd, &st) != 0 || st.st_size == 0){
+                    close(fd);
+                    return false;
+                }
+
+                // mapping stays valid after file descriptor is closed
+                void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                close(fd);
+                if(mapping == MAP_FAILED) return false;
+
+                data = mapping;
+                size = static_cast<size_t>(st.st_size);
+            #else
+                std::ifstream file(filename, std::ios::ate | std::ios::binary);
+                if(!file.is_open()) return false;
+
+                size = static_cast<size_t>(file.tellg());
+                if(size == 0) return false;
+
+                buffer.resize((size + sizeof(uint32) - 1) / sizeof(uint32));
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(buffer.data()), size);
+                data = buffer.data();
+            #endif
+                return true;
+            }
+
+            /// unmap file
+            inline void Close(){
+            #ifdef VULKAN_HELPER_MAPPED_FILE_USE_MMAP
+                if(data) munmap(const_cast<void*>(data), size);
+            #else
+                buffer.clear();
+                buffer.shrink_to_fit();
+            #endif
+                data = nullptr;
+                size = 0;
+            }
+        };
 
-            // put file cursor at beginning
-            file.seekg(0);
+        /**
+        * @brief Get the shader spirv code.
+        *        This copies the file into a vector, which gives no alignment guarantee
+        *        for the spirv words. Prefer Vulkan::LoadShaderModule or Vulkan::ShaderArchive
+        *        which hand the mapped file straight to vkCreateShaderModule.
+        * 
+        * @param filename of file containing spirv code
+        * @return std::vector<char> binary code
+        */
+        [[nodiscard]] inline static std::vector<char> LoadShaderCode(const char* filename){
+            // map file
+            MappedFile file;
+            bool opened = file.Open(filename);
 
-            // read file data
-            file.read(shaderCode.data(), codeSize);
+            // check if file is open or not
+            ASSERT(opened, "\tUnable to open shader code file %s", filename);
 
-            // close file
-            file.close();
+            // copy code
+            const char* code = static_cast<const char*>(file.data);
+            std::vector<char> shaderCode(code, code + file.size);
 
             // return
             return shaderCode;
         }
     
+        /**
+        * @brief check if data looks like a spirv module that can be passed to vkCreateShaderModule
+        * 
+        * @param data pointer to code
+        * @param size of code in bytes
+        * @return true if data is 4 byte aligned, has a whole number of words,
+        *         and starts with a complete spirv header
+        * @return false otherwise
+        */
+        [[nodiscard]] inline bool IsSpirvCode(const void* data, const size_t& size){
+            // spirv header is 5 words, first one is the magic number
+            return data != nullptr && (reinterpret_cast<uintptr_t>(data) % sizeof(uint32)) == 0 &&
+                size >= 5 * sizeof(uint32) && (size % sizeof(uint32)) == 0 &&
+                *static_cast<const uint32*>(data) == 0x07230203;
+        }
+
+        /**
+        * @brief Find index of a memory type that is allowed by memoryTypeBits
+        *        and has all the requested property flags.
+        *        Takes memory properties instead of a physical device so that
+        *        the selection can be done on any (even made up) memory layout.
+        * 
+        * @param memoryProperties memory properties of physical device
+        * @param memoryTypeBits allowed memory types (from VkMemoryRequirements)
+        * @param propertyFlags required memory properties
+        * @return std::optional<uint32> : has no value when no suitable memory type exists
+        */
+        [[nodiscard]] inline std::optional<uint32> FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& memoryProperties, const uint32& memoryTypeBits, const VkMemoryPropertyFlags& propertyFlags){
+            // memory types are ordered by driver in order of preference
+            // so the first match is the best one
+            for(uint32 i = 0; i < memoryProperties.memoryTypeCount; i++){
+                if((memoryTypeBits & (1u << i)) && 
+                    (memoryProperties.memoryTypes[i].propertyFlags & propertyFlags) == propertyFlags){
+                    return i;
+                }
+            }
+
+            // no memory type found
+            return std::nullopt;
+        }
+    
+        /**
+        * @brief Find queue family that supports required flags and has as few of the
+        *        avoided flags as possible. Use it to find dedicated families, eg. a transfer
+        *        only family (avoid graphics and compute) for uploads or a compute family
+        *        without graphics for async compute. Falls back to shared families when
+        *        no dedicated one exists. Graphics and compute families are treated as
+        *        transfer capable even if they don't report the transfer bit.
+        * 
+        * @param queueFamilyProperties queue families of physical device
+        * @param requiredFlags flags family must support
+        * @param avoidFlags flags family should preferably not support
+        * @return std::optional<uint32> : has no value when no family supports required flags
+        */
+        [[nodiscard]] inline std::optional<uint32> FindQueueFamilyIndex(const std::vector<VkQueueFamilyProperties>& queueFamilyProperties, const VkQueueFlags& requiredFlags, const VkQueueFlags& avoidFlags = 0){
+            std::optional<uint32> bestIdx;
+            uint32 bestScore = UINT32_MAX;
+
+            for(uint32 i = 0; i < queueFamilyProperties.size(); i++){
+                VkQueueFlags flags = queueFamilyProperties[i].queueFlags;
+                if(queueFamilyProperties[i].queueCount == 0) continue;
+
+                // transfer is implicit for graphics and compute
+                if(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) flags |= VK_QUEUE_TRANSFER_BIT;
+                if((flags & requiredFlags) != requiredFlags) continue;
+
+                // fewer avoided flags is better, first family wins ties
+                uint32 score = 0;
+                for(VkQueueFlags avoided = flags & avoidFlags; avoided; avoided &= avoided - 1) score++;
+                if(score < bestScore){
+                    bestScore = score;
+                    bestIdx = i;
+                }
+            }
+
+            // return
+            return bestIdx;
+        }
+
     } // tools namespace
 
 } // vulkan namespace
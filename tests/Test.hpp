@@ -0,0 +1,53 @@
+/**
+ * @file Test.hpp
+ * @author Siddharth Mishra (bshock665@gmail.com)
+ * @brief Minimal check macros for host side tests.
+ * @version 0.1
+ * @date 2021-05-16
+ *
+ */
+
+ /**
+  * @copyright Copyright 2021 Siddharth Mishra
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef VULKAN_HELPER_TESTS_TEST_HPP
+#define VULKAN_HELPER_TESTS_TEST_HPP
+
+#include <cstdio>
+
+namespace Test{
+
+    /// number of failed checks
+    inline int failures = 0;
+
+    /// print result of all checks, return value of main
+    [[nodiscard]] inline int Result(const char* name){
+        if(failures == 0) printf("[%s] : all checks passed\n", name);
+        else printf("[%s] : %d checks failed\n", name, failures);
+        return failures == 0 ? 0 : 1;
+    }
+
+} // namespace Test
+
+/// check condition, keeps running after a failure so every broken check is reported
+#define EXPECT(b) \
+    if(!(b)){ \
+        printf("%s:%d : check failed : %s\n", __FILE__, __LINE__, #b); \
+        Test::failures++; \
+    }
+
+#endif//VULKAN_HELPER_TESTS_TEST_HPP
@@ -0,0 +1,318 @@
+#include <vector>
+#include <VulkanBarrier.hpp>
+#include "Test.hpp"
+
+using namespace Vulkan;
+
+/// barriers of every recorded vkCmdPipelineBarrier2
+struct Recorded{
+    std::vector<VkMemoryBarrier2KHR> memoryBarriers;
+    std::vector<VkImageMemoryBarrier2KHR> imageBarriers;
+};
+
+static std::vector<Recorded> recorded;
+
+static void VKAPI_CALL RecordBarrier(VkCommandBuffer, const VkDependencyInfoKHR* dependencyInfo){
+    Recorded record;
+    record.memoryBarriers.assign(dependencyInfo->pMemoryBarriers, dependencyInfo->pMemoryBarriers + dependencyInfo->memoryBarrierCount);
+    record.imageBarriers.assign(dependencyInfo->pImageMemoryBarriers, dependencyInfo->pImageMemoryBarriers + dependencyInfo->imageMemoryBarrierCount);
+    recorded.push_back(record);
+}
+
+static const VkCommandBuffer cmdBuffer = reinterpret_cast<VkCommandBuffer>(0x1);
+static const VkImage image = reinterpret_cast<VkImage>(0x2);
+static const VkBuffer buffer = reinterpret_cast<VkBuffer>(0x3);
+
+// two reads in same layout need nothing
+static void TestReadAfterRead(){
+    BarrierTracker tracker;
+    tracker.RegisterImage(image, 1, 1, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    recorded.clear();
+
+    tracker.UseImage(image, Access::FragmentShaderRead);
+    tracker.UseImage(image, Access::FragmentShaderRead);
+    tracker.UseBuffer(buffer, Access::VertexBuffer);
+    tracker.UseBuffer(buffer, Access::VertexBuffer);
+    EXPECT(!tracker.HasPendingBarriers());
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.empty());
+}
+
+// read after write makes the write visible, once per reading stage
+static void TestReadAfterWrite(){
+    BarrierTracker tracker;
+    recorded.clear();
+
+    tracker.UseBuffer(buffer, Access::TransferDst);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.empty());
+
+    tracker.UseBuffer(buffer, Access::VertexBuffer);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 1 && recorded[0].memoryBarriers.size() == 1);
+    if(recorded.size() == 1 && recorded[0].memoryBarriers.size() == 1){
+        const VkMemoryBarrier2KHR& barrier = recorded[0].memoryBarriers[0];
+        EXPECT(barrier.srcStageMask == VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR && barrier.srcAccessMask == VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        EXPECT(barrier.dstStageMask == VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR && barrier.dstAccessMask == VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR);
+    }
+
+    // already visible to vertex input
+    tracker.UseBuffer(buffer, Access::VertexBuffer);
+    EXPECT(!tracker.HasPendingBarriers());
+
+    // new reading stage
+    tracker.UseBuffer(buffer, Access::UniformBuffer);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 2 && recorded.back().memoryBarriers.size() == 1);
+    if(recorded.size() == 2 && recorded.back().memoryBarriers.size() == 1){
+        EXPECT(recorded.back().memoryBarriers[0].srcAccessMask == VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        EXPECT(recorded.back().memoryBarriers[0].dstAccessMask == VK_ACCESS_2_UNIFORM_READ_BIT_KHR);
+    }
+}
+
+// write after read only waits for the reads, no access masks
+static void TestWriteAfterRead(){
+    BarrierTracker tracker;
+    recorded.clear();
+
+    tracker.UseBuffer(buffer, Access::TransferDst);
+    tracker.UseBuffer(buffer, Access::VertexBuffer);
+    tracker.Flush(cmdBuffer);
+    recorded.clear();
+
+    tracker.UseBuffer(buffer, Access::TransferDst);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 1 && recorded[0].memoryBarriers.size() == 1);
+    if(recorded.size() == 1 && recorded[0].memoryBarriers.size() == 1){
+        const VkMemoryBarrier2KHR& barrier = recorded[0].memoryBarriers[0];
+        EXPECT(barrier.srcStageMask == VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR && barrier.dstStageMask == VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR);
+        EXPECT(barrier.srcAccessMask == VK_ACCESS_2_NONE_KHR && barrier.dstAccessMask == VK_ACCESS_2_NONE_KHR);
+    }
+}
+
+// write after write needs a full memory dependency
+static void TestWriteAfterWrite(){
+    BarrierTracker tracker;
+    recorded.clear();
+
+    tracker.UseBuffer(buffer, Access::TransferDst);
+    tracker.Flush(cmdBuffer);
+    tracker.UseBuffer(buffer, Access::ComputeShaderWrite);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 1 && recorded[0].memoryBarriers.size() == 1);
+    if(recorded.size() == 1 && recorded[0].memoryBarriers.size() == 1){
+        const VkMemoryBarrier2KHR& barrier = recorded[0].memoryBarriers[0];
+        EXPECT(barrier.srcStageMask == VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR && barrier.srcAccessMask == VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        EXPECT(barrier.dstStageMask == VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR && barrier.dstAccessMask == VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    }
+}
+
+// a read in another layout still needs a transition
+static void TestLayoutChange(){
+    BarrierTracker tracker;
+    tracker.RegisterImage(image);
+    recorded.clear();
+
+    // first use from undefined, nothing to wait for
+    tracker.UseImage(image, Access::TransferDst);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 1 && recorded[0].imageBarriers.size() == 1);
+    if(recorded.size() == 1 && recorded[0].imageBarriers.size() == 1){
+        const VkImageMemoryBarrier2KHR& barrier = recorded[0].imageBarriers[0];
+        EXPECT(barrier.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && barrier.newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        EXPECT(barrier.srcStageMask == VK_PIPELINE_STAGE_2_NONE_KHR && barrier.srcAccessMask == VK_ACCESS_2_NONE_KHR);
+    }
+
+    tracker.UseImage(image, Access::FragmentShaderRead);
+    tracker.Flush(cmdBuffer);
+    tracker.UseImage(image, Access::TransferSrc);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 3 && recorded[2].imageBarriers.size() == 1);
+    if(recorded.size() == 3 && recorded[2].imageBarriers.size() == 1){
+        // read -> read with new layout, transition must wait for the fragment shader
+        const VkImageMemoryBarrier2KHR& barrier = recorded[2].imageBarriers[0];
+        EXPECT(barrier.oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL && barrier.newLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        EXPECT(barrier.srcStageMask == VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR && barrier.dstAccessMask == VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+    }
+
+    // discard transitions from undefined
+    tracker.UseImage(image, Access::ColorAttachment, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS, true);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 4 && recorded[3].imageBarriers.size() == 1 && recorded[3].imageBarriers[0].oldLayout == VK_IMAGE_LAYOUT_UNDEFINED);
+}
+
+// neighbouring subresources with same masks share one barrier
+static void TestSubresourceMerging(){
+    BarrierTracker tracker;
+    tracker.RegisterImage(image, 4, 6);
+    recorded.clear();
+
+    // whole image is one barrier
+    tracker.UseImage(image, Access::TransferDst);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 1 && recorded[0].imageBarriers.size() == 1);
+    if(recorded.size() == 1 && recorded[0].imageBarriers.size() == 1){
+        const VkImageSubresourceRange& range = recorded[0].imageBarriers[0].subresourceRange;
+        EXPECT(range.baseMipLevel == 0 && range.levelCount == 4 && range.baseArrayLayer == 0 && range.layerCount == 6);
+    }
+
+    // layers 2..3 of mip 1
+    tracker.UseImage(image, Access::FragmentShaderRead, 1, 1, 2, 2);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 2 && recorded[1].imageBarriers.size() == 1);
+    if(recorded.size() == 2 && recorded[1].imageBarriers.size() == 1){
+        const VkImageSubresourceRange& range = recorded[1].imageBarriers[0].subresourceRange;
+        EXPECT(range.baseMipLevel == 1 && range.levelCount == 1 && range.baseArrayLayer == 2 && range.layerCount == 2);
+    }
+
+    // everything to compute read : mip 0, mip 1 split in three by layers, mips 2..3
+    tracker.UseImage(image, Access::ComputeShaderRead);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 3 && recorded[2].imageBarriers.size() == 5);
+    if(recorded.size() == 3 && recorded[2].imageBarriers.size() == 5){
+        const auto& barriers = recorded[2].imageBarriers;
+        EXPECT(barriers[0].subresourceRange.baseMipLevel == 0 && barriers[0].subresourceRange.levelCount == 1 && barriers[0].subresourceRange.layerCount == 6);
+        EXPECT(barriers[1].subresourceRange.baseArrayLayer == 0 && barriers[1].subresourceRange.layerCount == 2);
+        EXPECT(barriers[2].subresourceRange.baseArrayLayer == 2 && barriers[2].subresourceRange.layerCount == 2);
+        EXPECT(barriers[2].oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        EXPECT(barriers[3].subresourceRange.baseArrayLayer == 4 && barriers[3].subresourceRange.layerCount == 2);
+        EXPECT(barriers[4].subresourceRange.baseMipLevel == 2 && barriers[4].subresourceRange.levelCount == 2 && barriers[4].subresourceRange.layerCount == 6);
+    }
+}
+
+// buffer ranges split on partial use and join again once their states match
+static void TestBufferRanges(){
+    BarrierTracker tracker;
+    recorded.clear();
+
+    tracker.UseBuffer(buffer, Access::TransferDst);
+    EXPECT(tracker.buffers[buffer].size() == 1);
+
+    // [0, 256) [256, 512) [512, whole)
+    tracker.UseBuffer(buffer, Access::VertexBuffer, 256, 256);
+    EXPECT(tracker.buffers[buffer].size() == 3);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 1);
+
+    // untouched range still needs the first write made visible
+    tracker.UseBuffer(buffer, Access::IndexBuffer, 1024, 64);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 2 && recorded[1].memoryBarriers.size() == 1 && recorded[1].memoryBarriers[0].srcAccessMask == VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    EXPECT(tracker.buffers[buffer].size() == 5);
+
+    // overwriting everything joins all ranges again
+    tracker.UseBuffer(buffer, Access::TransferDst);
+    EXPECT(tracker.buffers[buffer].size() == 1);
+    if(tracker.buffers[buffer].size() == 1){
+        EXPECT(tracker.buffers[buffer].begin()->first == 0 && tracker.buffers[buffer].begin()->second.end == VK_WHOLE_SIZE);
+    }
+}
+
+// synchronization2-only write bits are writes too
+static void TestStorageWrite(){
+    constexpr ResourceState storageWrite = {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR};
+    constexpr ResourceState storageRead  = {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR};
+
+    // read after write makes the write visible
+    BarrierTracker tracker;
+    recorded.clear();
+    tracker.UseBuffer(buffer, storageWrite);
+    tracker.Flush(cmdBuffer);
+    tracker.UseBuffer(buffer, storageRead);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 1 && recorded[0].memoryBarriers.size() == 1);
+    if(recorded.size() == 1 && recorded[0].memoryBarriers.size() == 1){
+        const VkMemoryBarrier2KHR& barrier = recorded[0].memoryBarriers[0];
+        EXPECT(barrier.srcAccessMask & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+        EXPECT(barrier.dstAccessMask == VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR);
+    }
+
+    // write after write is a full memory dependency
+    BarrierTracker writes;
+    recorded.clear();
+    writes.UseBuffer(buffer, storageWrite);
+    writes.Flush(cmdBuffer);
+    writes.UseBuffer(buffer, storageWrite);
+    writes.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 1 && recorded[0].memoryBarriers.size() == 1);
+    if(recorded.size() == 1 && recorded[0].memoryBarriers.size() == 1){
+        const VkMemoryBarrier2KHR& barrier = recorded[0].memoryBarriers[0];
+        EXPECT(barrier.srcStageMask == VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR && barrier.srcAccessMask == VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+        EXPECT(barrier.dstStageMask == VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR && barrier.dstAccessMask == VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+    }
+}
+
+// using something again before Flush records its barriers in a later batch
+static void TestReuseBeforeFlush(){
+    BarrierTracker tracker;
+    tracker.RegisterImage(image, 2, 1);
+    recorded.clear();
+
+    // different mips share a batch
+    tracker.UseImage(image, Access::TransferSrc, 0, 1);
+    tracker.UseImage(image, Access::TransferDst, 1, 1);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 1 && recorded[0].imageBarriers.size() == 2);
+
+    // two transitions of mip 1 must be ordered
+    recorded.clear();
+    tracker.UseImage(image, Access::TransferSrc, 1, 1);
+    tracker.UseImage(image, Access::FragmentShaderRead);
+    EXPECT(tracker.HasPendingBarriers());
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 2 && recorded[0].imageBarriers.size() == 1);
+    if(recorded.size() == 2 && recorded[0].imageBarriers.size() == 1){
+        EXPECT(recorded[0].imageBarriers[0].newLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        for(const auto& barrier : recorded[1].imageBarriers) EXPECT(barrier.newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        EXPECT(recorded[1].imageBarriers.size() == 1 && recorded[1].imageBarriers[0].subresourceRange.levelCount == 2);
+    }
+    EXPECT(!tracker.HasPendingBarriers());
+
+    // write then read of the same range keeps two dependencies instead of merging their masks
+    recorded.clear();
+    tracker.UseBuffer(buffer, Access::TransferDst);
+    tracker.Flush(cmdBuffer);
+    tracker.UseBuffer(buffer, Access::ComputeShaderWrite, 0, 256);
+    tracker.UseBuffer(buffer, Access::VertexBuffer, 128, 256);
+    tracker.UseBuffer(buffer, Access::IndexBuffer, 1024, 64);
+    tracker.Flush(cmdBuffer);
+    EXPECT(recorded.size() == 2 && recorded[0].memoryBarriers.size() == 1 && recorded[1].memoryBarriers.size() == 1);
+    if(recorded.size() == 2 && recorded[0].memoryBarriers.size() == 1 && recorded[1].memoryBarriers.size() == 1){
+        EXPECT(recorded[0].memoryBarriers[0].dstStageMask == VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR);
+        EXPECT(recorded[1].memoryBarriers[0].srcAccessMask == (VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR));
+        EXPECT(recorded[1].memoryBarriers[0].dstStageMask == VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR);
+    }
+}
+
+// synchronization2-only bits map to the legacy bits containing them
+static void TestLegacyFlags(){
+    EXPECT(LegacyPipelineStageFlags(VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR) ==
+           (VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT));
+    EXPECT(LegacyPipelineStageFlags(VK_PIPELINE_STAGE_2_COPY_BIT_KHR) == VK_PIPELINE_STAGE_TRANSFER_BIT);
+    EXPECT(LegacyPipelineStageFlags(VK_PIPELINE_STAGE_2_BLIT_BIT_KHR | VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR) == VK_PIPELINE_STAGE_TRANSFER_BIT);
+    EXPECT(LegacyPipelineStageFlags(VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR | VK_PIPELINE_STAGE_2_HOST_BIT_KHR) == (VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_HOST_BIT));
+    EXPECT(LegacyPipelineStageFlags(VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR) == VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+    EXPECT(LegacyPipelineStageFlags(VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR) == VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+    EXPECT(LegacyPipelineStageFlags(VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR) == VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT);
+    EXPECT(LegacyPipelineStageFlags(VK_PIPELINE_STAGE_2_NONE_KHR) == 0);
+
+    EXPECT(LegacyAccessFlags(VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR | VK_ACCESS_2_UNIFORM_READ_BIT_KHR) == (VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_UNIFORM_READ_BIT));
+    EXPECT(LegacyAccessFlags(VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR) == VK_ACCESS_SHADER_READ_BIT);
+    EXPECT(LegacyAccessFlags(VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR) == (VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+}
+
+int main(){
+    cmdPipelineBarrier2 = RecordBarrier;
+
+    TestReadAfterRead();
+    TestReadAfterWrite();
+    TestWriteAfterRead();
+    TestWriteAfterWrite();
+    TestLayoutChange();
+    TestSubresourceMerging();
+    TestBufferRanges();
+    TestStorageWrite();
+    TestReuseBeforeFlush();
+    TestLegacyFlags();
+    return Test::Result("Barrier");
+}
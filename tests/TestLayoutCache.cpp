@@ -0,0 +1,59 @@
+#include <VulkanLayoutCache.hpp>
+#include "Test.hpp"
+
+using namespace Vulkan;
+
+static VkSampler MakeSampler(const uintptr_t& id){
+    return reinterpret_cast<VkSampler>(id);
+}
+
+static VkDescriptorSetLayoutBinding MakeBinding(const uint32& binding, const VkSampler* samplers){
+    VkDescriptorSetLayoutBinding result = {};
+    result.binding              = binding;
+    result.descriptorType       = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    result.descriptorCount      = 1;
+    result.stageFlags           = VK_SHADER_STAGE_FRAGMENT_BIT;
+    result.pImmutableSamplers   = samplers;
+    return result;
+}
+
+// same sampler on a different binding must give a different layout
+static void TestSamplerBinding(){
+    const VkSampler sampler = MakeSampler(0x10);
+    LayoutCache::DescriptorSetLayoutKeyHash hash;
+
+    auto first  = LayoutCache::MakeKey({MakeBinding(0, &sampler), MakeBinding(1, nullptr)}, 0, {});
+    auto second = LayoutCache::MakeKey({MakeBinding(0, nullptr), MakeBinding(1, &sampler)}, 0, {});
+    EXPECT(!(first == second));
+    EXPECT(hash(first) != hash(second));
+}
+
+// binding order doesn't matter, samplers move with their binding
+static void TestCanonicalOrder(){
+    const VkSampler samplers[2] = {MakeSampler(0x10), MakeSampler(0x20)};
+    LayoutCache::DescriptorSetLayoutKeyHash hash;
+
+    auto first  = LayoutCache::MakeKey({MakeBinding(0, &samplers[0]), MakeBinding(1, &samplers[1])}, 0, {});
+    auto second = LayoutCache::MakeKey({MakeBinding(1, &samplers[1]), MakeBinding(0, &samplers[0])}, 0, {});
+    EXPECT(first == second);
+    EXPECT(hash(first) == hash(second));
+
+    auto swapped = LayoutCache::MakeKey({MakeBinding(0, &samplers[1]), MakeBinding(1, &samplers[0])}, 0, {});
+    EXPECT(!(first == swapped));
+}
+
+// binding flags follow their binding too
+static void TestBindingFlags(){
+    auto first  = LayoutCache::MakeKey({MakeBinding(1, nullptr), MakeBinding(0, nullptr)}, 0, {VkDescriptorBindingFlags(1), VkDescriptorBindingFlags(0)});
+    auto second = LayoutCache::MakeKey({MakeBinding(0, nullptr), MakeBinding(1, nullptr)}, 0, {VkDescriptorBindingFlags(0), VkDescriptorBindingFlags(1)});
+    auto third  = LayoutCache::MakeKey({MakeBinding(0, nullptr), MakeBinding(1, nullptr)}, 0, {VkDescriptorBindingFlags(1), VkDescriptorBindingFlags(0)});
+    EXPECT(first == second);
+    EXPECT(!(first == third));
+}
+
+int main(){
+    TestSamplerBinding();
+    TestCanonicalOrder();
+    TestBindingFlags();
+    return Test::Result("LayoutCache");
+}
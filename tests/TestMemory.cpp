@@ -0,0 +1,202 @@
+#include <cstdlib>
+#include <map>
+#include <VulkanMemory.hpp>
+#include "Test.hpp"
+
+using namespace Vulkan;
+
+// device memory is faked with host memory, these replace the loader's functions
+
+/// size of every live fake allocation
+static std::map<VkDeviceMemory, VkDeviceSize> deviceMemory;
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateMemory(VkDevice, const VkMemoryAllocateInfo* allocateInfo, const VkAllocationCallbacks*, VkDeviceMemory* memory){
+    *memory = reinterpret_cast<VkDeviceMemory>(malloc(allocateInfo->allocationSize));
+    deviceMemory[*memory] = allocateInfo->allocationSize;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkFreeMemory(VkDevice, VkDeviceMemory memory, const VkAllocationCallbacks*){
+    deviceMemory.erase(memory);
+    free(memory);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkMapMemory(VkDevice, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize, VkMemoryMapFlags, void** data){
+    *data = reinterpret_cast<uint8*>(memory) + offset;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkUnmapMemory(VkDevice, VkDeviceMemory){}
+
+static const VkDevice device = reinterpret_cast<VkDevice>(0x1);
+
+// splitting a block hands out lowest offsets first, buddies of a split are next to each other
+static void TestBuddySplit(){
+    BuddyAllocator allocator;
+    allocator.Init(1024, 64);
+    EXPECT(allocator.levelCount == 5);
+
+    auto first = allocator.Allocate(64);
+    auto second = allocator.Allocate(64);
+    auto third = allocator.Allocate(128);
+    EXPECT(first.has_value() && first.value() == 0);
+    EXPECT(second.has_value() && second.value() == 64);
+    EXPECT(third.has_value() && third.value() == 128);
+
+    // upper halves of the split are free
+    EXPECT(allocator.freeLists[1].count(512) == 1 && allocator.freeLists[2].count(256) == 1);
+    EXPECT(allocator.usedSize == 256);
+}
+
+// freeing merges buddies back up to the whole block
+static void TestBuddyCoalesce(){
+    BuddyAllocator allocator;
+    allocator.Init(1024, 64);
+
+    std::vector<VkDeviceSize> offsets;
+    for(uint32 i = 0; i < 16; i++){
+        auto offset = allocator.Allocate(64);
+        EXPECT(offset.has_value());
+        if(offset.has_value()) offsets.push_back(offset.value());
+    }
+
+    // free in an order where buddies are freed apart
+    for(uint32 i = 0; i < offsets.size(); i += 2) allocator.Free(offsets[i]);
+    EXPECT(allocator.freeLists[0].empty() && allocator.freeLists[4].size() == 8);
+    for(uint32 i = 1; i < offsets.size(); i += 2) allocator.Free(offsets[i]);
+
+    EXPECT(allocator.Empty() && allocator.usedSize == 0);
+    EXPECT(allocator.freeLists[0].size() == 1 && allocator.freeLists[0].count(0) == 1);
+    for(uint32 level = 1; level < allocator.levelCount; level++) EXPECT(allocator.freeLists[level].empty());
+
+    // whole block can be handed out again
+    auto whole = allocator.Allocate(1024);
+    EXPECT(whole.has_value() && whole.value() == 0);
+}
+
+// allocations are rounded to a power of two and aligned to that size
+static void TestBuddyAlignment(){
+    BuddyAllocator allocator;
+    allocator.Init(4096, 64);
+
+    auto small = allocator.Allocate(1);
+    auto odd = allocator.Allocate(200);
+    auto page = allocator.Allocate(1024);
+    EXPECT(small.has_value() && small.value() % 64 == 0);
+    EXPECT(odd.has_value() && odd.value() % 256 == 0);
+    EXPECT(page.has_value() && page.value() % 1024 == 0);
+    EXPECT(allocator.usedSize == 64 + 256 + 1024);
+}
+
+// a full block gives no value instead of overlapping ranges
+static void TestBuddyExhaustion(){
+    BuddyAllocator allocator;
+    allocator.Init(1024, 256);
+
+    EXPECT(!allocator.Allocate(2048).has_value());
+    for(uint32 i = 0; i < 4; i++) EXPECT(allocator.Allocate(256).has_value());
+    EXPECT(!allocator.Allocate(1).has_value());
+
+    allocator.Free(512);
+    auto offset = allocator.Allocate(200);
+    EXPECT(offset.has_value() && offset.value() == 512);
+    EXPECT(!allocator.Allocate(256).has_value());
+}
+
+/// device local, host visible and host cached memory types on two heaps
+static VkPhysicalDeviceMemoryProperties MakeMemoryProperties(){
+    VkPhysicalDeviceMemoryProperties properties = {};
+    properties.memoryHeapCount = 2;
+    properties.memoryHeaps[0] = {256ull * 1024 * 1024, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT};
+    properties.memoryHeaps[1] = {256ull * 1024 * 1024, 0};
+    properties.memoryTypeCount = 3;
+    properties.memoryTypes[0] = {VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0};
+    properties.memoryTypes[1] = {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 1};
+    properties.memoryTypes[2] = {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, 1};
+    return properties;
+}
+
+// first memory type allowed by memoryTypeBits with all requested properties is used
+static void TestMemoryTypeSelection(){
+    Memory memory;
+    memory.blockSize = 1024 * 1024;
+    memory.Init(device, MakeMemoryProperties());
+
+    Memory::Allocation local = memory.Allocate({256, 256, 0b111}, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    EXPECT(local.memoryTypeIndex == 0 && local.mapped == nullptr);
+
+    Memory::Allocation upload = memory.Allocate({256, 256, 0b111}, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+    EXPECT(upload.memoryTypeIndex == 1 && upload.mapped != nullptr);
+
+    Memory::Allocation readback = memory.Allocate({256, 256, 0b111}, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+    EXPECT(readback.memoryTypeIndex == 2);
+
+    // resource doesn't allow type 1
+    Memory::Allocation restricted = memory.Allocate({256, 256, 0b101}, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+    EXPECT(restricted.memoryTypeIndex == 2 && restricted.mapped != nullptr);
+
+    // one block per used memory type
+    EXPECT(memory.deviceAllocationCount == 3 && memory.allocationCount == 4);
+
+    memory.Free(local);
+    memory.Free(upload);
+    memory.Free(readback);
+    memory.Free(restricted);
+    EXPECT(memory.allocationCount == 0);
+    memory.Destroy();
+    EXPECT(memory.deviceAllocationCount == 0 && deviceMemory.empty());
+}
+
+// small allocations share blocks, large ones get their own memory
+static void TestBlockSelection(){
+    Memory memory;
+    memory.blockSize = 1024 * 1024;
+    memory.minAllocationSize = 256;
+    memory.Init(device, MakeMemoryProperties());
+
+    // same block, offsets respect alignment
+    Memory::Allocation first = memory.Allocate({100, 256, 0b1}, 0);
+    Memory::Allocation second = memory.Allocate({300, 4096, 0b1}, 0);
+    EXPECT(first.memory == second.memory && !first.dedicated && !second.dedicated);
+    EXPECT(first.offset != second.offset && second.offset % 4096 == 0);
+    EXPECT(memory.deviceAllocationCount == 1);
+
+    // images live in other blocks than buffers
+    Memory::Allocation image = memory.Allocate({100, 256, 0b1}, 0, false);
+    EXPECT(image.memory != first.memory && memory.deviceAllocationCount == 2);
+
+    // more than half a block is dedicated
+    Memory::Allocation large = memory.Allocate({memory.blockSize / 2 + 1, 256, 0b1}, 0);
+    EXPECT(large.dedicated && large.offset == 0 && memory.deviceAllocationCount == 3);
+    EXPECT(deviceMemory[large.memory] == memory.blockSize / 2 + 1);
+
+    // filling the block opens a second one
+    Memory::Allocation half = memory.Allocate({memory.blockSize / 2, 256, 0b1}, 0);
+    EXPECT(half.memory == first.memory);
+    Memory::Allocation overflow = memory.Allocate({memory.blockSize / 2, 256, 0b1}, 0);
+    EXPECT(overflow.memory != first.memory && memory.deviceAllocationCount == 4);
+
+    // emptied block is released, last block of a pool is kept
+    memory.Free(overflow);
+    EXPECT(memory.deviceAllocationCount == 3);
+    memory.Free(first);
+    memory.Free(second);
+    memory.Free(half);
+    EXPECT(memory.deviceAllocationCount == 3);
+
+    memory.Free(large);
+    memory.Free(image);
+    EXPECT(memory.deviceAllocationCount == 2 && memory.allocationCount == 0);
+    memory.Destroy();
+    EXPECT(deviceMemory.empty());
+}
+
+int main(){
+    TestBuddySplit();
+    TestBuddyCoalesce();
+    TestBuddyAlignment();
+    TestBuddyExhaustion();
+    TestMemoryTypeSelection();
+    TestBlockSelection();
+    return Test::Result("Memory");
+}
@@ -0,0 +1,116 @@
+#include <map>
+#include <VulkanRenderGraph.hpp>
+#include "Test.hpp"
+
+using namespace Vulkan;
+
+// image and memory calls are replaced, they hand out fake handles and remember what they were given
+
+/// next fake handle
+static uintptr_t nextHandle = 0x100;
+
+/// usage of every live image
+static std::map<VkImage, VkImageUsageFlags> images;
+
+/// number of live views and memory allocations
+static uint32 viewCount = 0;
+static uint32 memoryCount = 0;
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateImage(VkDevice, const VkImageCreateInfo* createInfo, const VkAllocationCallbacks*, VkImage* image){
+    *image = reinterpret_cast<VkImage>(nextHandle++);
+    images[*image] = createInfo->usage;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyImage(VkDevice, VkImage image, const VkAllocationCallbacks*){
+    images.erase(image);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetImageMemoryRequirements(VkDevice, VkImage, VkMemoryRequirements* requirements){
+    *requirements = {4096, 256, 1};
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateMemory(VkDevice, const VkMemoryAllocateInfo*, const VkAllocationCallbacks*, VkDeviceMemory* memory){
+    *memory = reinterpret_cast<VkDeviceMemory>(nextHandle++);
+    memoryCount++;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkFreeMemory(VkDevice, VkDeviceMemory, const VkAllocationCallbacks*){
+    memoryCount--;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindImageMemory(VkDevice, VkImage, VkDeviceMemory, VkDeviceSize){
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateImageView(VkDevice, const VkImageViewCreateInfo*, const VkAllocationCallbacks*, VkImageView* view){
+    *view = reinterpret_cast<VkImageView>(nextHandle++);
+    viewCount++;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyImageView(VkDevice, VkImageView, const VkAllocationCallbacks*){
+    viewCount--;
+}
+
+static const VkDevice device = reinterpret_cast<VkDevice>(0x1);
+
+/// one device local memory type
+static VkPhysicalDeviceMemoryProperties MakeMemoryProperties(){
+    VkPhysicalDeviceMemoryProperties properties = {};
+    properties.memoryHeapCount = 1;
+    properties.memoryHeaps[0] = {256ull * 1024 * 1024, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT};
+    properties.memoryTypeCount = 1;
+    properties.memoryTypes[0] = {VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0};
+    return properties;
+}
+
+// synchronization2 shader access bits give the usage the image is bound with
+static void TestStorageWriteUsage(){
+    Memory memory;
+    memory.Init(device, MakeMemoryProperties());
+
+    constexpr ResourceState storageWrite = {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR, VK_IMAGE_LAYOUT_GENERAL};
+    constexpr ResourceState storageRead  = {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR, VK_IMAGE_LAYOUT_GENERAL};
+    constexpr ResourceState sampledRead  = {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+    RenderGraph graph;
+    graph.Init(device);
+
+    RenderGraph::ResourceId simulated = 0;
+    RenderGraph::ResourceId blurred = 0;
+    graph.AddPass("Simulate", [&](RenderGraph::PassBuilder& builder){
+        simulated = builder.CreateImage("Simulated", {});
+        builder.Write(simulated, storageWrite);
+    }, [](const VkCommandBuffer&, RenderGraph&){});
+    graph.AddPass("Blur", [&](RenderGraph::PassBuilder& builder){
+        blurred = builder.CreateImage("Blurred", {});
+        builder.Read(simulated, storageRead);
+        builder.Write(blurred, storageWrite);
+    }, [](const VkCommandBuffer&, RenderGraph&){});
+    graph.AddPass("Composite", [&](RenderGraph::PassBuilder& builder){
+        builder.Read(blurred, sampledRead);
+        builder.SideEffects();
+    }, [](const VkCommandBuffer&, RenderGraph&){});
+
+    graph.Compile(memory);
+    EXPECT(graph.order.size() == 3);
+    EXPECT(images.size() == 2);
+    EXPECT(images[graph.GetImage(simulated)] == VK_IMAGE_USAGE_STORAGE_BIT);
+    EXPECT(images[graph.GetImage(blurred)] == (VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT));
+
+    // compiling again replaces transient images instead of leaking them
+    graph.Compile(memory);
+    EXPECT(images.size() == 2 && viewCount == 2 && memoryCount == 1);
+    EXPECT(graph.barriers.images.size() == 2);
+
+    graph.Destroy();
+    memory.Destroy();
+    EXPECT(images.empty() && viewCount == 0 && memoryCount == 0);
+}
+
+int main(){
+    TestStorageWriteUsage();
+    return Test::Result("RenderGraph");
+}
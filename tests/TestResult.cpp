@@ -0,0 +1,76 @@
+#include <VulkanResult.hpp>
+#include "Test.hpp"
+
+using namespace Vulkan;
+
+// wrapped calls are replaced, they return whatever the test asks for
+
+/// result next replaced call returns
+static VkResult nextResult = VK_SUCCESS;
+
+VKAPI_ATTR VkResult VKAPI_CALL vkWaitForFences(VkDevice, uint32_t, const VkFence*, VkBool32, uint64_t){
+    return nextResult;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateGraphicsPipelines(VkDevice, VkPipelineCache, uint32_t createInfoCount, const VkGraphicsPipelineCreateInfo*,
+                                                         const VkAllocationCallbacks*, VkPipeline* pipelines){
+    // pipelines that aren't created are VK_NULL_HANDLE
+    for(uint32_t i = 0; i < createInfoCount; i++){
+        pipelines[i] = nextResult == VK_SUCCESS ? reinterpret_cast<VkPipeline>(uintptr_t(0x10 + i)) : VK_NULL_HANDLE;
+    }
+    return nextResult;
+}
+
+/// a handle that is never dereferenced
+static const VkDevice device = reinterpret_cast<VkDevice>(uintptr_t(0x1));
+
+// only VK_SUCCESS and VK_SUBOPTIMAL_KHR give a value
+static void TestSuccessCodes(){
+    EXPECT(Result<void>(VK_SUCCESS).has_value());
+    EXPECT(Result<void>(VK_SUBOPTIMAL_KHR).has_value());
+    EXPECT(!Result<void>(VK_NOT_READY).has_value());
+    EXPECT(!Result<void>(VK_TIMEOUT).has_value());
+    EXPECT(!Result<void>(VK_INCOMPLETE).has_value());
+    EXPECT(!Result<void>(VK_ERROR_OUT_OF_DEVICE_MEMORY).has_value());
+    EXPECT(Result<uint32>(VK_SUBOPTIMAL_KHR, 2).value_or(0) == 2);
+    EXPECT(Result<uint32>(VK_NOT_READY, 2).value_or(0) == 0);
+}
+
+// fences that aren't signaled in time aren't a successful wait
+static void TestWaitForFencesTimeout(){
+    const VkFence fence = reinterpret_cast<VkFence>(uintptr_t(0x2));
+
+    nextResult = VK_SUCCESS;
+    EXPECT(Try::WaitForFences(device, fence, VK_TRUE, 0));
+
+    nextResult = VK_TIMEOUT;
+    Result<void> waited = Try::WaitForFences(device, fence, VK_TRUE, 0);
+    EXPECT(!waited);
+    EXPECT(waited.error() == VK_TIMEOUT);
+}
+
+// a pipeline that needs compiling is not created
+static void TestPipelineCompileRequired(){
+    VkGraphicsPipelineCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+
+    nextResult = VK_SUCCESS;
+    Result<VkPipeline> pipeline = Try::CreateGraphicsPipeline(device, VK_NULL_HANDLE, createInfo);
+    EXPECT(pipeline && *pipeline != VK_NULL_HANDLE);
+
+    nextResult = VK_PIPELINE_COMPILE_REQUIRED_EXT;
+    pipeline = Try::CreateGraphicsPipeline(device, VK_NULL_HANDLE, createInfo);
+    EXPECT(!pipeline);
+    EXPECT(pipeline.error() == VK_PIPELINE_COMPILE_REQUIRED_EXT);
+    EXPECT(pipeline.value_or(VK_NULL_HANDLE) == VK_NULL_HANDLE);
+
+    Result<std::vector<VkPipeline>> pipelines = Try::CreateGraphicsPipelines(device, VK_NULL_HANDLE, {createInfo, createInfo});
+    EXPECT(!pipelines);
+}
+
+int main(){
+    TestSuccessCodes();
+    TestWaitForFencesTimeout();
+    TestPipelineCompileRequired();
+    return Test::Result("Result");
+}
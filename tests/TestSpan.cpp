@@ -0,0 +1,170 @@
+#include <array>
+#include <cstdlib>
+#include <new>
+#include <Vulkan.hpp>
+#include "Test.hpp"
+
+using namespace Vulkan;
+
+/// number of heap allocations, counted by the replaced operator new
+static size_t allocationCount = 0;
+
+void* operator new(std::size_t size){
+    allocationCount++;
+    if(void* ptr = malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept{
+    free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept{
+    free(ptr);
+}
+
+// commands are replaced too, they only remember what they were given
+
+/// count and first handle of last call
+static uint32 lastCount = 0;
+static const void* lastFirst = nullptr;
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBindVertexBuffers(VkCommandBuffer, uint32_t, uint32_t bindingCount, const VkBuffer* buffers, const VkDeviceSize*){
+    lastCount = bindingCount;
+    lastFirst = buffers[0];
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBindDescriptorSets(VkCommandBuffer, VkPipelineBindPoint, VkPipelineLayout, uint32_t, uint32_t descriptorSetCount,
+                                                   const VkDescriptorSet* descriptorSets, uint32_t, const uint32_t*){
+    lastCount = descriptorSetCount;
+    lastFirst = descriptorSets[0];
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkQueueSubmit(VkQueue, uint32_t submitCount, const VkSubmitInfo* submits, VkFence){
+    lastCount = submitCount;
+    lastFirst = submits[0].pCommandBuffers[0];
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkUpdateDescriptorSets(VkDevice, uint32_t descriptorWriteCount, const VkWriteDescriptorSet* descriptorWrites, uint32_t, const VkCopyDescriptorSet*){
+    lastCount = descriptorWriteCount;
+    lastFirst = descriptorWrites[0].dstSet;
+}
+
+template<typename T>
+static T Handle(const uintptr_t& id){
+    return reinterpret_cast<T>(id);
+}
+
+static const VkCommandBuffer cmdBuffer = Handle<VkCommandBuffer>(0x1);
+static const VkDevice device = Handle<VkDevice>(0x2);
+static const VkQueue queue = Handle<VkQueue>(0x3);
+static const VkPipelineLayout pipelineLayout = Handle<VkPipelineLayout>(0x4);
+
+static void TestBindVertexBuffers(){
+    allocationCount = 0;
+
+    InlineVector<VkBuffer, 4> buffers;
+    buffers.push_back(Handle<VkBuffer>(0x10));
+    buffers.push_back(Handle<VkBuffer>(0x11));
+    InlineVector<VkDeviceSize, 4> offsets = {0, 256};
+    CmdBindVertexBuffers(cmdBuffer, 0, buffers.size(), buffers, offsets);
+    EXPECT(lastCount == 2 && lastFirst == Handle<VkBuffer>(0x10));
+
+    const VkBuffer bufferArray[3] = {Handle<VkBuffer>(0x20), Handle<VkBuffer>(0x21), Handle<VkBuffer>(0x22)};
+    const std::array<VkDeviceSize, 3> offsetArray = {0, 0, 0};
+    CmdBindVertexBuffers(cmdBuffer, 0, 3, bufferArray, offsetArray);
+    EXPECT(lastCount == 3 && lastFirst == Handle<VkBuffer>(0x20));
+
+    CmdBindVertexBuffers(cmdBuffer, 0, 1, {Handle<VkBuffer>(0x30)}, {VkDeviceSize(0)});
+    EXPECT(lastCount == 1 && lastFirst == Handle<VkBuffer>(0x30));
+
+    EXPECT(allocationCount == 0);
+}
+
+static void TestBindDescriptorSets(){
+    allocationCount = 0;
+
+    InlineVector<VkDescriptorSet, 4> sets = {Handle<VkDescriptorSet>(0x10), Handle<VkDescriptorSet>(0x11)};
+    CmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, sets);
+    EXPECT(lastCount == 2 && lastFirst == Handle<VkDescriptorSet>(0x10));
+
+    const VkDescriptorSet setArray[2] = {Handle<VkDescriptorSet>(0x20), Handle<VkDescriptorSet>(0x21)};
+    const uint32 dynamicOffsets[1] = {256};
+    CmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, setArray, dynamicOffsets);
+    EXPECT(lastCount == 2 && lastFirst == Handle<VkDescriptorSet>(0x20));
+
+    CmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 1, {Handle<VkDescriptorSet>(0x30)}, {uint32(0), uint32(64)});
+    EXPECT(lastCount == 1 && lastFirst == Handle<VkDescriptorSet>(0x30));
+
+    // single set
+    CmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, Handle<VkDescriptorSet>(0x40));
+    EXPECT(lastCount == 1 && lastFirst == Handle<VkDescriptorSet>(0x40));
+
+    EXPECT(allocationCount == 0);
+}
+
+static void TestQueueSubmit(){
+    allocationCount = 0;
+
+    const VkCommandBuffer cmdBuffers[2] = {Handle<VkCommandBuffer>(0x10), Handle<VkCommandBuffer>(0x11)};
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount   = 2;
+    submitInfo.pCommandBuffers      = cmdBuffers;
+
+    InlineVector<VkSubmitInfo, 2> submitInfos;
+    submitInfos.push_back(submitInfo);
+    QueueSumbit(queue, submitInfos, VK_NULL_HANDLE);
+    EXPECT(lastCount == 1 && lastFirst == cmdBuffers[0]);
+
+    const std::array<VkSubmitInfo, 2> submitArray = {submitInfo, submitInfo};
+    QueueSumbit(queue, submitArray, VK_NULL_HANDLE);
+    EXPECT(lastCount == 2);
+
+    QueueSumbit(queue, {submitInfo, submitInfo, submitInfo}, VK_NULL_HANDLE);
+    EXPECT(lastCount == 3);
+
+    QueueSumbit(queue, submitInfo, VK_NULL_HANDLE);
+    EXPECT(lastCount == 1);
+
+    EXPECT(allocationCount == 0);
+}
+
+static void TestUpdateDescriptorSets(){
+    allocationCount = 0;
+
+    VkWriteDescriptorSet write = {};
+    write.sType             = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet            = Handle<VkDescriptorSet>(0x10);
+    write.descriptorCount   = 1;
+    write.descriptorType    = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+    InlineVector<VkWriteDescriptorSet, 8> writes;
+    writes.push_back(write);
+    writes.push_back(write);
+    UpdateDescriptorSets(device, writes);
+    EXPECT(lastCount == 2 && lastFirst == Handle<VkDescriptorSet>(0x10));
+
+    const VkWriteDescriptorSet writeArray[3] = {write, write, write};
+    UpdateDescriptorSets(device, writeArray);
+    EXPECT(lastCount == 3);
+
+    UpdateDescriptorSets(device, {write});
+    EXPECT(lastCount == 1);
+
+    EXPECT(allocationCount == 0);
+}
+
+int main(){
+    // make sure counting works before trusting a zero
+    allocationCount = 0;
+    delete new int(0);
+    EXPECT(allocationCount == 1);
+
+    TestBindVertexBuffers();
+    TestBindDescriptorSets();
+    TestQueueSubmit();
+    TestUpdateDescriptorSets();
+    return Test::Result("Span");
+}